@@ -242,8 +242,10 @@ HEADERS += \
   src/fs/sc/simconnectreply.h \
   src/fs/sc/simconnecttypes.h \
   src/fs/sc/simconnectuseraircraft.h \
+  src/fs/sc/trafficgeneratorhandler.h \
   src/fs/sc/weatherrequest.h \
   src/fs/sc/xpconnecthandler.h \
+  src/fs/sc/xpsharedmemory.h \
   src/fs/scenery/aircraftindex.h \
   src/fs/util/coordinates.h \
   src/fs/util/fsutil.h \
@@ -251,6 +253,7 @@ HEADERS += \
   src/fs/util/tacanfrequencies.h \
   src/geo/calculations.h \
   src/geo/line.h \
+  src/geo/linearrays.h \
   src/geo/linestring.h \
   src/geo/nanoflann.h \
   src/geo/point3d.h \
@@ -265,6 +268,7 @@ HEADERS += \
   src/io/inireader.h \
   src/io/tempfile.h \
   src/json/nlohmann/json.hpp \
+  src/logging/loggingasync.h \
   src/logging/loggingconfig.h \
   src/logging/loggingguiabort.h \
   src/logging/logginghandler.h \
@@ -276,6 +280,7 @@ HEADERS += \
   src/util/crashhandler.h \
   src/util/csvfilereader.h \
   src/util/csvreader.h \
+  src/util/csvscanner.h \
   src/util/filechecker.h \
   src/util/fileoperations.h \
   src/util/filesystemwatcher.h \
@@ -283,6 +288,8 @@ HEADERS += \
   src/util/heap.h \
   src/util/httpdownloader.h \
   src/util/locker.h \
+  src/util/lrucache.h \
+  src/util/parallel.h \
   src/util/properties.h \
   src/util/props.h \
   src/util/signalhandler.h \
@@ -292,9 +299,11 @@ HEADERS += \
   src/util/updatecheck.h \
   src/util/updatechecktypes.h \
   src/util/version.h \
+  src/util/wildcardfilter.h \
   src/util/xmlstream.h \
   src/win/activationcontext.h \
   src/zip/gzip.h \
+  src/zip/gzipdevice.h \
   src/zip/zipreader.h \
   src/zip/zipwriter.h \
   src/zlib/crc32.h \
@@ -330,8 +339,10 @@ SOURCES += \
   src/fs/sc/simconnectreply.cpp \
   src/fs/sc/simconnecttypes.cpp \
   src/fs/sc/simconnectuseraircraft.cpp \
+  src/fs/sc/trafficgeneratorhandler.cpp \
   src/fs/sc/weatherrequest.cpp \
   src/fs/sc/xpconnecthandler.cpp \
+  src/fs/sc/xpsharedmemory.cpp \
   src/fs/scenery/aircraftindex.cpp \
   src/fs/util/coordinates.cpp \
   src/fs/util/fsutil.cpp \
@@ -339,6 +350,7 @@ SOURCES += \
   src/fs/util/tacanfrequencies.cpp \
   src/geo/calculations.cpp \
   src/geo/line.cpp \
+  src/geo/linearrays.cpp \
   src/geo/linestring.cpp \
   src/geo/point3d.cpp \
   src/geo/pos.cpp \
@@ -351,6 +363,7 @@ SOURCES += \
   src/io/fileroller.cpp \
   src/io/inireader.cpp \
   src/io/tempfile.cpp \
+  src/logging/loggingasync.cpp \
   src/logging/loggingconfig.cpp \
   src/logging/loggingguiabort.cpp \
   src/logging/logginghandler.cpp \
@@ -361,6 +374,7 @@ SOURCES += \
   src/util/crashhandler.cpp \
   src/util/csvfilereader.cpp \
   src/util/csvreader.cpp \
+  src/util/csvscanner.cpp \
   src/util/filechecker.cpp \
   src/util/fileoperations.cpp \
   src/util/filesystemwatcher.cpp \
@@ -368,6 +382,7 @@ SOURCES += \
   src/util/heap.cpp \
   src/util/httpdownloader.cpp \
   src/util/locker.cpp \
+  src/util/parallel.cpp \
   src/util/properties.cpp \
   src/util/props.cpp \
   src/util/signalhandler.cpp \
@@ -377,9 +392,11 @@ SOURCES += \
   src/util/updatecheck.cpp \
   src/util/updatechecktypes.cpp \
   src/util/version.cpp \
+  src/util/wildcardfilter.cpp \
   src/util/xmlstream.cpp \
   src/win/activationcontext.cpp \
   src/zip/gzip.cpp \
+  src/zip/gzipdevice.cpp \
   src/zip/zip.cpp \
   src/zlib/adler32.c \
   src/zlib/compress.c \
@@ -418,11 +435,14 @@ SOURCES += \
 !isEqual(ATOOLS_NO_SQL, "true") {
 HEADERS += \
   src/sql/sqlcolumn.h \
+  src/sql/sqlcursor.h \
   src/sql/sqldatabase.h \
+  src/sql/sqldatabasepool.h \
   src/sql/sqlexception.h \
   src/sql/sqlexport.h \
   src/sql/sqlquery.h \
   src/sql/sqlrecord.h \
+  src/sql/sqlrowcopier.h \
   src/sql/sqlscript.h \
   src/sql/sqltransaction.h \
   src/sql/sqltypes.h \
@@ -430,11 +450,14 @@ HEADERS += \
 
 SOURCES += \
   src/sql/sqlcolumn.cpp \
+  src/sql/sqlcursor.cpp \
   src/sql/sqldatabase.cpp \
+  src/sql/sqldatabasepool.cpp \
   src/sql/sqlexception.cpp \
   src/sql/sqlexport.cpp \
   src/sql/sqlquery.cpp \
   src/sql/sqlrecord.cpp \
+  src/sql/sqlrowcopier.cpp \
   src/sql/sqlscript.cpp \
   src/sql/sqltransaction.cpp \
   src/sql/sqlutil.cpp
@@ -609,6 +632,7 @@ HEADERS += \
   src/httpserver/httpconnectionhandler.h \
   src/httpserver/httpconnectionhandlerpool.h \
   src/httpserver/httpcookie.h \
+  src/httpserver/httpeventloop.h \
   src/httpserver/httpglobal.h \
   src/httpserver/httplistener.h \
   src/httpserver/httprequest.h \
@@ -617,6 +641,7 @@ HEADERS += \
   src/httpserver/httpsession.h \
   src/httpserver/httpsessionstore.h \
   src/httpserver/staticfilecontroller.h \
+  src/templateengine/compiledtemplate.h \
   src/templateengine/template.h \
   src/templateengine/templatecache.h \
   src/templateengine/templateglobal.h \
@@ -626,6 +651,7 @@ SOURCES += \
   src/httpserver/httpconnectionhandler.cpp \
   src/httpserver/httpconnectionhandlerpool.cpp \
   src/httpserver/httpcookie.cpp \
+  src/httpserver/httpeventloop.cpp \
   src/httpserver/httpglobal.cpp \
   src/httpserver/httplistener.cpp \
   src/httpserver/httprequest.cpp \
@@ -634,6 +660,7 @@ SOURCES += \
   src/httpserver/httpsession.cpp \
   src/httpserver/httpsessionstore.cpp \
   src/httpserver/staticfilecontroller.cpp \
+  src/templateengine/compiledtemplate.cpp \
   src/templateengine/template.cpp \
   src/templateengine/templatecache.cpp \
   src/templateengine/templateloader.cpp
@@ -768,6 +795,7 @@ HEADERS += \
   src/fs/scenery/layoutjson.h \
   src/fs/scenery/manifestjson.h \
   src/fs/scenery/materiallib.h \
+  src/fs/scenery/packagecache.h \
   src/fs/scenery/sceneryarea.h \
   src/fs/scenery/scenerycfg.h \
   src/fs/userdata/airspacereaderbase.h \
@@ -916,6 +944,7 @@ SOURCES += \
   src/fs/scenery/layoutjson.cpp \
   src/fs/scenery/manifestjson.cpp \
   src/fs/scenery/materiallib.cpp \
+  src/fs/scenery/packagecache.cpp \
   src/fs/scenery/sceneryarea.cpp \
   src/fs/scenery/scenerycfg.cpp \
   src/fs/userdata/airspacereaderbase.cpp \
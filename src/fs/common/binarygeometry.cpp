@@ -44,6 +44,9 @@ void BinaryGeometry::readFromByteArray(const QByteArray& bytes)
   quint32 size;
   float lonx, laty;
   in >> size;
+
+  // Allocate contiguous storage once - limit by available data to avoid huge allocations for corrupted blobs
+  geometry.reserve(static_cast<int>(std::min(size, static_cast<quint32>(std::max(bytes.size() - 4, 0) / 8))));
   for(unsigned int i = 0; i < size; i++)
   {
     in >> lonx >> laty;
@@ -54,6 +57,7 @@ void BinaryGeometry::readFromByteArray(const QByteArray& bytes)
 QByteArray BinaryGeometry::writeToByteArray() const
 {
   QByteArray bytes;
+  bytes.reserve(4 + geometry.size() * 8);
   QDataStream out(&bytes, QIODevice::WriteOnly);
   out.setVersion(QDataStream::Qt_5_5);
   out.setFloatingPointPrecision(QDataStream::SinglePrecision);
@@ -24,9 +24,19 @@
 #include "wmm/magdectool.h"
 #include "exception.h"
 #include "sql/sqlquery.h"
+#include "geo/calculations.h"
 
-#include <QFile>
+#include <QDataStream>
 #include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+
 #include <cmath>
 
 using atools::geo::Pos;
@@ -40,6 +50,19 @@ using Qt::hex;
 using Qt::dec;
 #endif
 
+/* Change version if anything in the cache file format changes */
+static const quint32 WMM_CACHE_MAGIC_NUMBER = 0x3E71A95C;
+static const quint16 WMM_CACHE_VERSION = 1;
+
+/* Grid of one degree steps and size of the serialized grid as written by writeToBytes() */
+static const int WMM_GRID_SIZE = 360 * 181;
+static const int WMM_GRID_BYTES = static_cast<int>(sizeof(quint32) + WMM_GRID_SIZE * sizeof(float));
+
+/* Protects cache directory which can be changed from any thread */
+static QMutex wmmCacheMutex;
+static QString wmmCacheDirectory;
+static bool wmmCacheDirectorySet = false;
+
 MagDecReader::MagDecReader()
 {
 }
@@ -63,20 +86,148 @@ void MagDecReader::readFromWmm(int year, int month)
 {
   clear();
 
+  if(year <= 0 || month <= 0)
+  {
+    // Same defaults as MagDecTool
+    QDate current = QDateTime::currentDateTimeUtc().date();
+
+    if(year <= 0)
+      year = current.year();
+
+    if(month <= 0)
+      month = current.month();
+  }
+
+  // Grid depends only on month and model coeffizients ===================
+  QString coefficientVersion = atools::wmm::MagDecTool::getCoefficientVersion();
+  QString key = QString("%1|%2-%3").arg(coefficientVersion).arg(year).arg(month);
+
+  QString cacheDir = getWmmCacheDirectory(), cacheFilename;
+  if(!cacheDir.isEmpty())
+  {
+    cacheFilename = QDir(cacheDir).filePath(QString("magdec_%1_%2_%3.bin").
+                                            arg(qHash(coefficientVersion), 8, 16, QChar('0')).
+                                            arg(year, 4, 10, QChar('0')).arg(month, 2, 10, QChar('0')));
+
+    if(readWmmCache(cacheFilename, key))
+    {
+      qDebug() << Q_FUNC_INFO << "Loaded from" << cacheFilename;
+      return;
+    }
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
   // Create WMM model data
   atools::wmm::MagDecTool magDecTool;
   magDecTool.init(year, month);
 
   referenceDate = magDecTool.getReferenceDate();
-  numValues = 360 * 181;
+  wmmVersion = coefficientVersion;
 
   // Copy to internal representation that allows saving and loading
-  magDecValues = new float[numValues];
+  magDecValues.resize(WMM_GRID_SIZE);
   for(int latY = -90; latY <= 90; latY++)
   {
     for(int lonX = -180; lonX < 180; lonX++)
       magDecValues[offset(lonX, latY)] = magDecTool.getMagVar(lonX, latY);
   }
+
+  qDebug() << Q_FUNC_INFO << "Calculated" << key << "in" << timer.elapsed() << "ms";
+
+  if(!cacheFilename.isEmpty())
+    writeWmmCache(cacheFilename, key);
+}
+
+void MagDecReader::setWmmCacheDirectory(const QString& directory)
+{
+  QMutexLocker locker(&wmmCacheMutex);
+  wmmCacheDirectory = directory;
+  wmmCacheDirectorySet = true;
+}
+
+QString MagDecReader::getWmmCacheDirectory()
+{
+  QMutexLocker locker(&wmmCacheMutex);
+  if(!wmmCacheDirectorySet)
+  {
+    // Determine default lazily since the location depends on the application name
+    QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if(!cacheLocation.isEmpty())
+      wmmCacheDirectory = cacheLocation + "/wmm";
+    wmmCacheDirectorySet = true;
+  }
+  return wmmCacheDirectory;
+}
+
+bool MagDecReader::readWmmCache(const QString& filename, const QString& key)
+{
+  QFile file(filename);
+  if(file.exists())
+  {
+    if(file.open(QIODevice::ReadOnly))
+    {
+      QDataStream in(&file);
+      in.setVersion(QDataStream::Qt_5_5);
+
+      quint32 magic;
+      quint16 version;
+      QString fileKey;
+      in >> magic >> version;
+
+      if(magic == WMM_CACHE_MAGIC_NUMBER && version == WMM_CACHE_VERSION)
+      {
+        QDate date;
+        QString fileWmmVersion;
+        QByteArray bytes;
+        in >> fileKey >> date >> fileWmmVersion >> bytes;
+
+        if(in.status() == QDataStream::Ok && fileKey == key)
+        {
+          // Check size before deserializing since readFromBytes() trusts the value count
+          if(bytes.size() == WMM_GRID_BYTES &&
+             qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(bytes.constData())) == static_cast<quint32>(WMM_GRID_SIZE))
+          {
+            readFromBytes(bytes);
+            referenceDate = date;
+            wmmVersion = fileWmmVersion;
+            return true;
+          }
+          else
+            qWarning() << Q_FUNC_INFO << "Invalid grid size in" << filename << bytes.size();
+        }
+        else
+          qWarning() << Q_FUNC_INFO << "Error reading" << filename << "status" << in.status() << "key" << fileKey;
+      }
+      else
+        qWarning() << Q_FUNC_INFO << "Cannot read" << filename << "Invalid magic number or version:" << magic << version;
+    }
+    else
+      qWarning() << Q_FUNC_INFO << "Cannot open file" << filename << file.errorString();
+  }
+
+  clear();
+  return false;
+}
+
+void MagDecReader::writeWmmCache(const QString& filename, const QString& key) const
+{
+  QDir().mkpath(QFileInfo(filename).absolutePath());
+
+  // Write to temporary file first and rename on commit to avoid corrupted files if called from more than one process
+  QSaveFile file(filename);
+  if(file.open(QIODevice::WriteOnly))
+  {
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_5);
+    out << WMM_CACHE_MAGIC_NUMBER << WMM_CACHE_VERSION << key << referenceDate << wmmVersion << writeToBytes();
+
+    if(!file.commit())
+      qWarning() << Q_FUNC_INFO << "Cannot write file" << filename << file.errorString();
+  }
+  else
+    qWarning() << Q_FUNC_INFO << "Cannot open file" << filename << file.errorString();
 }
 
 void MagDecReader::readFromBgl(const QString& filename)
@@ -129,12 +280,11 @@ void MagDecReader::readFromBgl(const QString& filename)
                               arg(numLatValues));
     }
 
-    numValues = numLongValues * numLatValues;
-
-    magDecValues = new float[numValues];
+    int numValues = static_cast<int>(numLongValues * numLatValues);
+    magDecValues.resize(numValues);
 
     // Decode all values
-    for(quint32 i = 0; i < numValues; i++)
+    for(int i = 0; i < numValues; i++)
       // East values are positive while West values are negative
       // As an example a E03.4° value will be coded as:
       // MV (E03.4°) = 65536*3.4/360 = 619 (0x26B)
@@ -156,11 +306,12 @@ void MagDecReader::readFromBytes(const QByteArray& bytes)
   in.setVersion(QDataStream::Qt_5_5);
   in.setFloatingPointPrecision(QDataStream::SinglePrecision);
 
+  quint32 numValues;
   in >> numValues;
-  magDecValues = new float[numValues];
+  magDecValues.resize(static_cast<int>(numValues));
 
-  for(unsigned int i = 0; i < numValues; i++)
-    in >> magDecValues[i];
+  for(float& value : magDecValues)
+    in >> value;
 }
 
 void MagDecReader::writeToTable(sql::SqlDatabase& db) const
@@ -207,15 +358,14 @@ bool MagDecReader::readFromTable(sql::SqlDatabase& db)
 
 void MagDecReader::clear()
 {
-  delete[] magDecValues;
-  magDecValues = nullptr;
+  magDecValues.clear();
   referenceDate = QDate();
   wmmVersion.clear();
 }
 
 bool MagDecReader::isValid() const
 {
-  return magDecValues != nullptr;
+  return !magDecValues.isEmpty();
 }
 
 float MagDecReader::getMagVar(float longitudeX, float latitudeY) const
@@ -238,9 +388,9 @@ QByteArray MagDecReader::writeToBytes() const
   out.setVersion(QDataStream::Qt_5_5);
   out.setFloatingPointPrecision(QDataStream::SinglePrecision);
 
-  out << numValues;
-  for(quint32 i = 0; i < numValues; i++)
-    out << magDecValues[i];
+  out << static_cast<quint32>(magDecValues.size());
+  for(float value : magDecValues)
+    out << value;
 
   return bytes;
 }
@@ -253,6 +403,66 @@ float MagDecReader::getMagVar(const geo::Pos& pos) const
   if(!pos.isValid())
     return 0.f;
 
+  return magVarInterpolated(pos);
+}
+
+void MagDecReader::getMagVar(QVector<float>& magvars, const QVector<atools::geo::Pos>& positions, bool interpolate) const
+{
+  if(!isValid())
+    throw Exception("MagDecReader is invalid");
+
+  magvars.resize(positions.size());
+  float *result = magvars.data();
+
+  if(interpolate)
+  {
+    for(int i = 0; i < positions.size(); i++)
+    {
+      const Pos& pos = positions.at(i);
+      result[i] = pos.isValid() ? magVarInterpolated(pos) : 0.f;
+    }
+  }
+  else
+  {
+    for(int i = 0; i < positions.size(); i++)
+    {
+      const Pos& pos = positions.at(i);
+      result[i] = pos.isValid() ? magVarNearest(pos.getLonX(), pos.getLatY()) : 0.f;
+    }
+  }
+}
+
+void MagDecReader::getMagVar(float *magvars, const float *longitudeX, const float *latitudeY, int size,
+                             bool interpolate) const
+{
+  if(!isValid())
+    throw Exception("MagDecReader is invalid");
+
+  for(int i = 0; i < size; i++)
+  {
+    Pos pos(longitudeX[i], latitudeY[i]);
+    if(pos.isValid())
+      magvars[i] = interpolate ? magVarInterpolated(pos) : magVarNearest(longitudeX[i], latitudeY[i]);
+    else
+      magvars[i] = 0.f;
+  }
+}
+
+float MagDecReader::magVarNearest(float lonX, float latY) const
+{
+  // Round to nearest grid point and wrap -180 to 180
+  int lonXInt = atools::roundToInt(atools::geo::normalizeLonXDeg(lonX));
+  int latYInt = atools::roundToInt(atools::geo::normalizeLatYDeg(latY));
+  if(lonXInt < 0)
+    lonXInt += 360;
+
+  // Same as offset() - east and west longitudes are continuous after adding 360 to west
+  int index = lonXInt * 181 + latYInt + 90;
+  return index >= 0 && index < magDecValues.size() ? magDecValues.at(index) : 0.f;
+}
+
+float MagDecReader::magVarInterpolated(const geo::Pos& pos) const
+{
   Pos posNorm(pos.normalized());
   float lonX = posNorm.getLonX();
   float latY = posNorm.getLatY();
@@ -297,8 +507,8 @@ float MagDecReader::getMagVar(const geo::Pos& pos) const
 
 float MagDecReader::magvar(int offset) const
 {
-  if(offset >= 0 && offset < static_cast<int>(numValues))
-    return magDecValues[offset];
+  if(offset >= 0 && offset < magDecValues.size())
+    return magDecValues.at(offset);
   else
     throw Exception(QString("Wrong offset into magnetic declination %1").arg(offset));
 }
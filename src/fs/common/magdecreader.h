@@ -19,6 +19,7 @@
 #define ATOOLS_FS_COMMON_MAGDECREADER_H
 
 #include <QDate>
+#include <QVector>
 #include <QCoreApplication>
 
 namespace atools {
@@ -35,6 +36,9 @@ namespace common {
 
 /*
  * Loads and parses the magdec.bgl file. Allows to store declination into the magdecl table in a database.
+ *
+ * Copies share the declination grid. getMagVar() only reads the grid and can be called in parallel
+ * once reading is done.
  */
 class MagDecReader
 {
@@ -44,16 +48,19 @@ public:
   MagDecReader();
   virtual ~MagDecReader();
 
-  MagDecReader(const MagDecReader& other) = delete;
-  MagDecReader& operator=(const MagDecReader& other) = delete;
-
   /* Calculate values from world magnetic model based on current year and month or current date if not given.
    * Values can be saved to database. Result is always valid.
+   * Grids are loaded from the cache directory if calculated before for the same month and coeffizient file.
    *  January = 1 */
   void readFromWmm(int year, int month = 1);
   void readFromWmm(const QDate& date);
   void readFromWmm();
 
+  /* Directory for grids calculated by readFromWmm(). Default is "wmm" in the application cache directory.
+   * Caching is disabled if empty. Thread safe. */
+  static void setWmmCacheDirectory(const QString& directory);
+  static QString getWmmCacheDirectory();
+
   /* Read values from magdec.bgl file */
   void readFromBgl(const QString& filename);
 
@@ -76,6 +83,16 @@ public:
   float getMagVar(float longitudeX, float latitudeY) const;
   float getMagVar(double longitudeX, double latitudeY) const;
 
+  /* Batch variants of the above. Result is resized to the number of positions.
+   * Uses bilinear interpolation like the methods above if interpolate is true. Otherwise the value of the
+   * nearest grid point is used which is faster.
+   * Throws exception if object is not valid. */
+  void getMagVar(QVector<float>& magvars, const QVector<atools::geo::Pos>& positions, bool interpolate = true) const;
+
+  /* Arrays of coordinates. magvars has to have space for size values. */
+  void getMagVar(float *magvars, const float *longitudeX, const float *latitudeY, int size,
+                 bool interpolate = true) const;
+
   const QDate& getReferenceDate() const
   {
     return referenceDate;
@@ -88,17 +105,26 @@ public:
   }
 
 private:
+  /* Load grid from cache file if key matches. Returns true if loaded. */
+  bool readWmmCache(const QString& filename, const QString& key);
+  void writeWmmCache(const QString& filename, const QString& key) const;
+
   QByteArray writeToBytes() const;
   void readFromBytes(const QByteArray& bytes);
 
   int offset(int lonX, int latY) const;
   float magvar(int offset) const;
 
+  /* Interpolated value without validity check */
+  float magVarInterpolated(const atools::geo::Pos& pos) const;
+
+  /* Value of nearest grid point without validity check */
+  float magVarNearest(float lonX, float latY) const;
+
   QDate referenceDate;
-  quint32 numValues = 0;
 
   /* https://www.fsdeveloper.com/wiki/index.php?title=Magdec_BGL_File */
-  float *magDecValues = nullptr;
+  QVector<float> magDecValues;
 
   QString wmmVersion;
 };
@@ -31,6 +31,36 @@ namespace atools {
 namespace fs {
 namespace common {
 
+/* Index into grid or -1 for OCEAN and -2 for UNKNOWN in polar regions.
+ * Coordinates are top left corner of rectangle. */
+inline static int moraGridIndex(int lonx, int laty)
+{
+  // Wrap to -89 <= y <= 90
+  laty = (((laty + 89) % 180) + 180) % 180 - 89;
+
+  // Avoid invalid values in far north and south regions
+  if(laty > 85)
+    return -1;
+
+  if(laty < -85)
+    return -2;
+
+  // Wrap to -180 <= x <= 179
+  lonx = (((lonx + 180) % 360) + 360) % 360 - 180;
+
+  return (-laty + 90) * 360 + lonx + 180;
+}
+
+inline static int moraGridValue(const QVector<quint16>& datagrid, int index)
+{
+  if(index == -1)
+    return MoraReader::OCEAN;
+  else if(index == -2)
+    return MoraReader::UNKNOWN;
+  else
+    return datagrid.at(index);
+}
+
 MoraReader::MoraReader(sql::SqlDatabase *sqlDb1, sql::SqlDatabase *sqlDb2)
 {
   assignDatabase(sqlDb1, sqlDb2);
@@ -340,32 +370,35 @@ int MoraReader::getMoraFt(int lonx, int laty) const
   if(!dataAvailable)
     throw Exception("MORA data not available");
 
-  // Coordinates are top left corner of rectangle.
-  // -180 <= x <= 179
-  // -89 <= y <= 90
+  return moraGridValue(datagrid, moraGridIndex(lonx, laty));
+}
 
-  // Adjust values
-  while(laty < -89)
-    laty += 180;
-  while(laty > 90)
-    laty -= 180;
+void MoraReader::getMoraFt(QVector<int>& moraFt, const QVector<geo::Pos>& positions) const
+{
+  if(!dataAvailable)
+    throw Exception("MORA data not available");
 
-  // Avoid invalid values in far north and south regions
-  if(laty > 85)
-    return OCEAN;
+  moraFt.resize(positions.size());
+  int *result = moraFt.data();
 
-  if(laty < -85)
-    return UNKNOWN;
+  // Calculate indexes in a tight loop first and look up values afterwards
+  for(int i = 0; i < positions.size(); i++)
+    result[i] = moraGridIndex(static_cast<int>(positions.at(i).getLonX()), static_cast<int>(positions.at(i).getLatY()));
+
+  for(int i = 0; i < positions.size(); i++)
+    result[i] = moraGridValue(datagrid, result[i]);
+}
 
-  // Adjust values
-  while(lonx < -180)
-    lonx += 360;
-  while(lonx > 179)
-    lonx -= 360;
+void MoraReader::getMoraFt(int *moraFt, const float *longitudeX, const float *latitudeY, int size) const
+{
+  if(!dataAvailable)
+    throw Exception("MORA data not available");
 
-  int pos = (-laty + 90) * 360 + lonx + 180;
+  for(int i = 0; i < size; i++)
+    moraFt[i] = moraGridIndex(static_cast<int>(longitudeX[i]), static_cast<int>(latitudeY[i]));
 
-  return datagrid.at(pos);
+  for(int i = 0; i < size; i++)
+    moraFt[i] = moraGridValue(datagrid, moraFt[i]);
 }
 
 void MoraReader::assignDatabase(sql::SqlDatabase *sqlDb1, sql::SqlDatabase *sqlDb2)
@@ -43,6 +43,9 @@ namespace common {
  * MORA values clear all terrain by 2000 feet in areas where the highest elevations are 5001 feet MSL or higher.
  *
  * The field will contain values expressed in hundreds of feet, for example, the value of 6000 feet is expressed as 060 and the value of 7100 feet is expressed as 071. For geographical sections that are not surveyed, the field will contain the alpha characters UNK for Unknown.
+ *
+ * getMoraFt() only reads the loaded grid and is safe for parallel use. Copies keep the database pointers,
+ * so the table methods are not.
  */
 class MoraReader
 {
@@ -87,6 +90,13 @@ public:
   int getMoraFt(const atools::geo::Pos& pos) const;
   int getMoraFt(int lonx, int laty) const;
 
+  /* Batch variants of the above. Result is resized to the number of positions.
+   * Throws exception if object is not valid. */
+  void getMoraFt(QVector<int>& moraFt, const QVector<atools::geo::Pos>& positions) const;
+
+  /* Arrays of coordinates. moraFt has to have space for size values. */
+  void getMoraFt(int *moraFt, const float *longitudeX, const float *latitudeY, int size) const;
+
   /* Print world map to log */
   void debugPrint(const QVector<quint16>& grid);
 
@@ -17,6 +17,7 @@
 
 #include "fs/db/airwayresolver.h"
 
+#include "sql/sqlcursor.h"
 #include "sql/sqldatabase.h"
 #include "sql/sqlquery.h"
 #include "sql/sqlutil.h"
@@ -24,11 +25,13 @@
 #include "geo/rect.h"
 #include "geo/calculations.h"
 #include "fs/progresshandler.h"
+#include "util/parallel.h"
 
 #include <QDebug>
 #include <QString>
 #include <QList>
 #include <algorithm>
+#include <limits>
 #include <QQueue>
 #include <QElapsedTimer>
 #include <QStringBuilder>
@@ -40,8 +43,21 @@ namespace db {
 /* Report progress twice a second */
 const static int MIN_PROGRESS_REPORT_MS = 500;
 
+/* Minimum number of airway points resolved in parallel between progress reports */
+const static int MIN_BATCH_AIRWAY_POINTS = 20000;
+
+/* Rows per multi row insert statement. 18 columns * 50 rows stays below the SQLite limit of 999 variables. */
+const static int INSERT_BATCH_ROWS = 50;
+
+/* Columns written to table airway. route_type is not used. */
+const static QStringList AIRWAY_COLUMNS({"airway_id", "airway_name", "airway_type", "airway_fragment_no", "sequence_no",
+                                         "from_waypoint_id", "to_waypoint_id", "direction", "minimum_altitude",
+                                         "maximum_altitude", "left_lonx", "top_laty", "right_lonx", "bottom_laty",
+                                         "from_lonx", "from_laty", "to_lonx", "to_laty"});
+
 using atools::sql::SqlDatabase;
 using atools::sql::SqlQuery;
+using atools::sql::SqlCursor;
 using atools::sql::SqlUtil;
 using atools::geo::Pos;
 using atools::geo::Rect;
@@ -83,11 +99,65 @@ uint qHash(const AirwayResolver::AirwaySegment& segment)
   return static_cast<unsigned int>(segment.fromWaypointId) ^ static_cast<unsigned int>(segment.toWaypointId);
 }
 
+/* All rows of tmp_waypoint in flat arrays ordered by waypoint_id */
+struct AirwayResolver::WaypointIndex
+{
+  QVector<int> ids;
+  QVector<float> lonx, laty;
+
+  /* Maps ident, region and type to an index in waypointLists */
+  QHash<QString, int> keyToListIndex;
+
+  /* Indexes into ids, lonx and laty for all waypoints having the same ident, region and type */
+  QVector<QVector<int> > waypointLists;
+
+  static QString key(const QString& ident, const QString& region, const QString& type)
+  {
+    return ident % '|' % region % '|' % type;
+  }
+
+};
+
+/* Row of tmp_airway_point with waypoint references resolved to WaypointIndex::waypointLists. -1 if not found. */
+struct AirwayResolver::AirwayPoint
+{
+  QString name, type;
+  int previousKey = -1, midKey = -1, nextKey = -1,
+      previousMinAlt = 0, previousMaxAlt = 0, nextMinAlt = 0, nextMaxAlt = 0;
+  char previousDir = '\0', nextDir = '\0';
+};
+
+/* Connected list of segments */
+struct AirwayResolver::Fragment
+{
+  QSet<int> waypoints;
+  QVector<AirwaySegment> segments;
+  int fragmentNum = 0, idOffset = 0; /* Offset of first airway_id in this airway */
+};
+
+/* Result for one airway name */
+struct AirwayResolver::Airway
+{
+  QString name;
+  QVector<Fragment> fragments;
+  int numIds = 0; /* Number of airway ids used including the ones of removed fragments */
+  float longestSegmentMeter = 0.f;
+};
+
 AirwayResolver::AirwayResolver(sql::SqlDatabase *sqlDb, atools::fs::ProgressHandler& progress)
-  : progressHandler(progress), curAirwayId(1), numAirways(0), airwayInsertStmt(sqlDb), db(sqlDb)
+  : progressHandler(progress), curAirwayId(1), numAirways(0), airwayInsertStmt(sqlDb), airwayInsertBatchStmt(sqlDb),
+  db(sqlDb)
 {
-  SqlUtil util(sqlDb);
-  airwayInsertStmt.prepare(util.buildInsertStatement("airway"));
+  // Insert statement for one row using positional bindings
+  QString insert = "insert into airway (" % AIRWAY_COLUMNS.join(", ") % ") values ";
+  QString values = "(" % QString("?, ").repeated(AIRWAY_COLUMNS.size() - 1) % "?)";
+  airwayInsertStmt.prepare(insert % values);
+
+  // Insert statement for INSERT_BATCH_ROWS rows
+  QStringList valuesList;
+  for(int i = 0; i < INSERT_BATCH_ROWS; i++)
+    valuesList.append(values);
+  airwayInsertBatchStmt.prepare(insert % valuesList.join(", "));
 }
 
 AirwayResolver::~AirwayResolver()
@@ -117,35 +187,41 @@ bool AirwayResolver::run(int numReportSteps)
   int deleted = deleteAirwayQuery.numRowsAffected();
   qInfo() << "Removed" << deleted << "from airway table";
 
-  // Use set to
-  QSet<AirwaySegment> airway;
-  QString currentAirway;
-
-  int totalRowCount = SqlUtil(db).rowCount("tmp_airway_point");
-
-  int rowsPerStep = static_cast<int>(std::ceil(static_cast<float>(totalRowCount) / static_cast<float>(numReportSteps)));
-  int row = 0, steps = 0;
-
   QElapsedTimer timer;
   timer.start();
   qint64 elapsed = timer.elapsed();
 
-  SqlQuery tmpWaypointQuery(db);
-  tmpWaypointQuery.prepare("select waypoint_id, ident, region, type, lonx, laty "
-                           "from tmp_waypoint where ident = ? and region = ? and type = ?");
+  // Load all waypoints and airway points into memory =============================
+  WaypointIndex waypoints;
+  loadWaypoints(waypoints);
 
-  // Get all tmp_airway_point rows and join previous and next waypoints to the result by ident and region
-  // Result is ordered by airway name
-  SqlQuery tmpAirwayPointQuery(db);
-  tmpAirwayPointQuery.exec("select * from tmp_airway_point order by name"); // where name = 'Y655'
-  atools::geo::Pos lastPosition;
+  // Airway points ordered by name and ranges [first, second) for each airway name
+  QVector<AirwayPoint> airwayPoints;
+  QVector<std::pair<int, int> > airwayRanges;
+  loadAirwayPoints(airwayPoints, airwayRanges, waypoints);
+
+  qDebug() << Q_FUNC_INFO << "Loaded" << waypoints.ids.size() << "waypoints and" << airwayPoints.size()
+           << "airway points in" << timer.elapsed() << "ms";
+
+  int totalRowCount = airwayPoints.size();
+  int rowsPerStep = std::max(static_cast<int>(std::ceil(static_cast<float>(totalRowCount) /
+                                                        static_cast<float>(numReportSteps))), 1);
+  int steps = 0;
   float longestAirwaySegmentMeter = 0.f;
-  while(tmpAirwayPointQuery.next())
-  {
-    QString awName = tmpAirwayPointQuery.value("name").toString();
-    QString awType = tmpAirwayPointQuery.value("type").toString();
 
-    if((row++ % rowsPerStep) == 0)
+  // Resolve batches of airways in parallel and save them in order =============================
+  for(int batchStart = 0; batchStart < airwayRanges.size() && !aborted;)
+  {
+    // Collect airway names up to the minimum batch size - at least one airway
+    int firstRow = airwayRanges.at(batchStart).first;
+    int batchEnd = batchStart + 1;
+    while(batchEnd < airwayRanges.size() && airwayRanges.at(batchEnd).first - firstRow < MIN_BATCH_AIRWAY_POINTS)
+      batchEnd++;
+    int lastRow = airwayRanges.at(batchEnd - 1).second;
+
+    // Report once for each step crossed by the rows of this batch
+    int numSteps = (lastRow + rowsPerStep - 1) / rowsPerStep - (firstRow + rowsPerStep - 1) / rowsPerStep;
+    for(int i = 0; i < numSteps; i++)
     {
       qint64 elapsed2 = timer.elapsed();
 
@@ -154,29 +230,144 @@ bool AirwayResolver::run(int numReportSteps)
       if(!silent)
         elapsed = elapsed2;
       steps++;
-      if((aborted = progressHandler.reportOther(tr("Creating airways: %1...").arg(awName), -1, silent)) == true)
+      if((aborted = progressHandler.reportOther(tr("Creating airways: %1...").arg(airwayPoints.at(firstRow).name),
+                                                -1, silent)) == true)
         break;
     }
 
-    if(awName != currentAirway)
+    if(aborted)
+      break;
+
+    QVector<Airway> airways(batchEnd - batchStart);
+    atools::util::parallelFor(airways.size(), [&airways, &airwayPoints, &airwayRanges, &waypoints, batchStart,
+                                               this](int begin, int end) -> void {
+          for(int i = begin; i < end; i++)
+            resolveAirway(airways[i], airwayPoints, airwayRanges.at(batchStart + i), waypoints);
+        }, 8);
+
+    // Write in airway name order to get the same ids as a sequential run
+    saveAirways(airways);
+
+    for(const Airway& airway : qAsConst(airways))
+      longestAirwaySegmentMeter = std::max(longestAirwaySegmentMeter, airway.longestSegmentMeter);
+
+    batchStart = batchEnd;
+  }
+
+  // Eat up any remaining progress steps
+  progressHandler.increaseCurrent(numReportSteps - steps);
+
+  qInfo() << Q_FUNC_INFO << "Added " << numAirways << " airway segments in" << timer.elapsed() << "ms";
+  qInfo() << Q_FUNC_INFO << "Longest segment is" << atools::geo::meterToNm(longestAirwaySegmentMeter) << "NM";
+
+  if(!aborted)
+    db->commit();
+
+  return aborted;
+}
+
+void AirwayResolver::loadWaypoints(WaypointIndex& waypoints)
+{
+  enum {WAYPOINT_ID, IDENT, REGION, TYPE, LONX, LATY};
+
+  // Order by id to get the same order of duplicates as the indexed query on ident
+  SqlQuery query(db);
+  query.exec("select waypoint_id, ident, region, type, lonx, laty from tmp_waypoint order by waypoint_id");
+  SqlCursor cursor(query);
+
+  while(cursor.next())
+  {
+    int index = waypoints.ids.size();
+    waypoints.ids.append(cursor.valueInt(WAYPOINT_ID));
+    waypoints.lonx.append(cursor.valueFloat(LONX));
+    waypoints.laty.append(cursor.valueFloat(LATY));
+
+    QString key = WaypointIndex::key(cursor.valueStr(IDENT), cursor.valueStr(REGION), cursor.valueStr(TYPE));
+    auto it = waypoints.keyToListIndex.constFind(key);
+    if(it == waypoints.keyToListIndex.constEnd())
     {
-      // A new airway comes from from the query save the current one to the database
-      saveAirway(airway, currentAirway);
-      currentAirway = awName;
-      lastPosition = Pos();
+      waypoints.keyToListIndex.insert(key, waypoints.waypointLists.size());
+      waypoints.waypointLists.append(QVector<int>({index}));
     }
+    else
+      waypoints.waypointLists[it.value()].append(index);
+  }
+}
+
+void AirwayResolver::loadAirwayPoints(QVector<AirwayPoint>& airwayPoints, QVector<std::pair<int, int> >& airwayRanges,
+                                      const WaypointIndex& waypoints)
+{
+  enum {NAME, TYPE,
+        PREVIOUS_IDENT, PREVIOUS_REGION, PREVIOUS_TYPE, MID_IDENT, MID_REGION, MID_TYPE, NEXT_IDENT, NEXT_REGION, NEXT_TYPE,
+        PREVIOUS_MIN_ALT, PREVIOUS_MAX_ALT, PREVIOUS_DIR, NEXT_MIN_ALT, NEXT_MAX_ALT, NEXT_DIR};
+
+  // Get all tmp_airway_point rows - result is ordered by airway name
+  SqlQuery query(db);
+  query.exec("select name, type, "
+             "previous_ident, previous_region, previous_type, mid_ident, mid_region, mid_type, "
+             "next_ident, next_region, next_type, "
+             "previous_minimum_altitude, previous_maximum_altitude, previous_direction, "
+             "next_minimum_altitude, next_maximum_altitude, next_direction "
+             "from tmp_airway_point order by name, airway_point_id");
+  SqlCursor cursor(query);
+
+  // Find list of matching waypoints. Null values never match like in SQL.
+  auto keyIndex = [&cursor, &waypoints](int identCol, int regionCol, int typeCol) -> int {
+        if(cursor.isNull(identCol) || cursor.isNull(regionCol) || cursor.isNull(typeCol))
+          return -1;
+        else
+          return waypoints.keyToListIndex.value(WaypointIndex::key(cursor.valueStr(identCol), cursor.valueStr(regionCol),
+                                                                   cursor.valueStr(typeCol)), -1);
+      };
+
+  while(cursor.next())
+  {
+    AirwayPoint point;
+    point.name = cursor.valueStr(NAME);
+    point.type = cursor.valueStr(TYPE);
+    point.previousKey = keyIndex(PREVIOUS_IDENT, PREVIOUS_REGION, PREVIOUS_TYPE);
+    point.midKey = keyIndex(MID_IDENT, MID_REGION, MID_TYPE);
+    point.nextKey = keyIndex(NEXT_IDENT, NEXT_REGION, NEXT_TYPE);
+    point.previousMinAlt = cursor.valueInt(PREVIOUS_MIN_ALT);
+    point.previousMaxAlt = cursor.valueInt(PREVIOUS_MAX_ALT);
+    point.previousDir = atools::strToChar(cursor.valueStr(PREVIOUS_DIR));
+    point.nextMinAlt = cursor.valueInt(NEXT_MIN_ALT);
+    point.nextMaxAlt = cursor.valueInt(NEXT_MAX_ALT);
+    point.nextDir = atools::strToChar(cursor.valueStr(NEXT_DIR));
+
+    // Start a new range if name changes
+    if(airwayRanges.isEmpty() || airwayPoints.constLast().name != point.name)
+      airwayRanges.append(std::make_pair(airwayPoints.size(), airwayPoints.size()));
+    airwayRanges.last().second++;
+
+    airwayPoints.append(point);
+  }
+}
+
+void AirwayResolver::resolveAirway(Airway& airway, const QVector<AirwayPoint>& airwayPoints,
+                                   const std::pair<int, int>& range, const WaypointIndex& waypoints) const
+{
+  // Use set to remove duplicate segments
+  QSet<AirwaySegment> airwaySegments;
+  atools::geo::Pos lastPosition;
+
+  airway.name = airwayPoints.at(range.first).name;
+
+  for(int row = range.first; row < range.second; row++)
+  {
+    const AirwayPoint& point = airwayPoints.at(row);
 
     int midWpId = -1, prevWpId = -1, nextWpId = -1;
     Pos midWpPos, prevWpPos, nextWpPos;
-    fetchNavaid(prevWpId, prevWpPos, tmpAirwayPointQuery, tmpWaypointQuery, "previous_", lastPosition);
+    fetchNavaid(prevWpId, prevWpPos, waypoints, point.previousKey, lastPosition);
     if(prevWpPos.isValidRange())
       lastPosition = prevWpPos;
 
-    fetchNavaid(midWpId, midWpPos, tmpAirwayPointQuery, tmpWaypointQuery, "mid_", lastPosition);
+    fetchNavaid(midWpId, midWpPos, waypoints, point.midKey, lastPosition);
     if(midWpPos.isValidRange())
       lastPosition = midWpPos;
 
-    fetchNavaid(nextWpId, nextWpPos, tmpAirwayPointQuery, tmpWaypointQuery, "next_", lastPosition);
+    fetchNavaid(nextWpId, nextWpPos, waypoints, point.nextKey, lastPosition);
     if(nextWpPos.isValidRange())
       lastPosition = nextWpPos;
 
@@ -185,14 +376,10 @@ bool AirwayResolver::run(int numReportSteps)
       // Previous waypoint found - add segment
       float midPrevDist = midWpPos.distanceMeterTo(prevWpPos);
       if(maxAirwaySegmentLengthNm <= 1.f || midPrevDist < atools::geo::nmToMeter(maxAirwaySegmentLengthNm))
-      {
-        int prevMinAlt = tmpAirwayPointQuery.value("previous_minimum_altitude").toInt();
-        int prevMaxAlt = tmpAirwayPointQuery.value("previous_maximum_altitude").toInt();
-        char prevDir = atools::strToChar(tmpAirwayPointQuery.value("previous_direction").toString());
-        airway.insert(AirwaySegment(prevWpId, midWpId, prevDir, prevMinAlt, prevMaxAlt, awType, prevWpPos, midWpPos));
-      }
+        airwaySegments.insert(AirwaySegment(prevWpId, midWpId, point.previousDir, point.previousMinAlt,
+                                            point.previousMaxAlt, point.type, prevWpPos, midWpPos));
 
-      longestAirwaySegmentMeter = std::max(longestAirwaySegmentMeter, midPrevDist);
+      airway.longestSegmentMeter = std::max(airway.longestSegmentMeter, midPrevDist);
     }
 
     if(nextWpId != -1)
@@ -200,64 +387,48 @@ bool AirwayResolver::run(int numReportSteps)
       // Next waypoint found - add segment
       float midNextDist = midWpPos.distanceMeterTo(nextWpPos);
       if(maxAirwaySegmentLengthNm <= 1.f || midNextDist < atools::geo::nmToMeter(maxAirwaySegmentLengthNm))
-      {
-        int nextMinAlt = tmpAirwayPointQuery.value("next_minimum_altitude").toInt();
-        int nextMaxAlt = tmpAirwayPointQuery.value("next_maximum_altitude").toInt();
-        char nextDir = atools::strToChar(tmpAirwayPointQuery.value("next_direction").toString());
-        airway.insert(AirwaySegment(midWpId, nextWpId, nextDir, nextMinAlt, nextMaxAlt, awType, midWpPos, nextWpPos));
-      }
+        airwaySegments.insert(AirwaySegment(midWpId, nextWpId, point.nextDir, point.nextMinAlt, point.nextMaxAlt,
+                                            point.type, midWpPos, nextWpPos));
 
-      longestAirwaySegmentMeter = std::max(longestAirwaySegmentMeter, midNextDist);
+      airway.longestSegmentMeter = std::max(airway.longestSegmentMeter, midNextDist);
     }
-  } // while(query.next())
-
-  // Save last remaining airway
-  saveAirway(airway, currentAirway);
-
-  // Eat up any remaining progress steps
-  progressHandler.increaseCurrent(numReportSteps - steps);
-
-  qInfo() << Q_FUNC_INFO << "Added " << numAirways << " airway segments";
-  qInfo() << Q_FUNC_INFO << "Longest segment is" << atools::geo::meterToNm(longestAirwaySegmentMeter) << "NM";
+  }
 
-  if(!aborted)
-    db->commit();
+  if(!airwaySegments.isEmpty())
+  {
+    // Build airway fragments
+    buildAirway(airwaySegments, airway);
 
-  return aborted;
+    // Remove all fragments that are contained by others
+    cleanFragments(airway.fragments);
+  }
 }
 
-void AirwayResolver::fetchNavaid(int& id, atools::geo::Pos& pos, atools::sql::SqlQuery& tmpAirwayPointQuery,
-                                 atools::sql::SqlQuery& tmpWaypointQuery, const QString& prefix, const Pos& lastPos)
+void AirwayResolver::fetchNavaid(int& id, atools::geo::Pos& pos, const WaypointIndex& waypoints, int keyIndex,
+                                 const Pos& lastPos)
 {
-  enum {BIND_IDENT, BIND_REGION, BIND_TYPE};
+  if(keyIndex != -1)
+  {
+    const QVector<int>& wpList = waypoints.waypointLists.at(keyIndex);
 
-  enum {WAYPOINT_ID, IDENT, REGION, TYPE, LONX, LATY};
+    // Take the nearest to the last position if ambiguous
+    int index = wpList.constFirst();
+    if(lastPos.isValidRange() && wpList.size() > 1)
+    {
+      float minDistance = std::numeric_limits<float>::max();
+      for(int wpIndex : wpList)
+      {
+        float distance = Pos(waypoints.lonx.at(wpIndex), waypoints.laty.at(wpIndex)).distanceMeterTo(lastPos);
+        if(distance < minDistance)
+        {
+          minDistance = distance;
+          index = wpIndex;
+        }
+      }
+    }
 
-  // waypoint_id integer primary key,
-  // type varchar(15) not null,
-  // ident varchar(5) not null,
-  // region varchar(2) not null,
-  // lonx double not null,
-  // laty double not null
-  tmpWaypointQuery.bindValue(BIND_IDENT, tmpAirwayPointQuery.valueStr(prefix % "ident"));
-  tmpWaypointQuery.bindValue(BIND_REGION, tmpAirwayPointQuery.valueStr(prefix % "region"));
-  tmpWaypointQuery.bindValue(BIND_TYPE, tmpAirwayPointQuery.valueStr(prefix % "type"));
-  tmpWaypointQuery.exec();
-
-  QVector<std::pair<int, Pos> > wpList;
-  while(tmpWaypointQuery.next())
-    wpList.append(std::make_pair(tmpWaypointQuery.valueInt(WAYPOINT_ID),
-                                 Pos(tmpWaypointQuery.valueFloat(LONX), tmpWaypointQuery.valueFloat(LATY))));
-
-  if(lastPos.isValidRange() && wpList.size() > 1)
-    std::sort(wpList.begin(), wpList.end(), [&lastPos](const std::pair<int, Pos>& t1, const std::pair<int, Pos>& t2) -> bool {
-            return t1.second.distanceMeterTo(lastPos) < t2.second.distanceMeterTo(lastPos);
-          });
-
-  if(!wpList.isEmpty())
-  {
-    id = wpList.constFirst().first;
-    pos = wpList.constFirst().second;
+    id = waypoints.ids.at(index);
+    pos = Pos(waypoints.lonx.at(index), waypoints.laty.at(index));
   }
   else
   {
@@ -266,31 +437,87 @@ void AirwayResolver::fetchNavaid(int& id, atools::geo::Pos& pos, atools::sql::Sq
   }
 }
 
-void AirwayResolver::saveAirway(QSet<AirwaySegment>& airway, const QString& currentAirway)
+void AirwayResolver::saveAirways(const QVector<Airway>& airways)
 {
-  if(!airway.empty())
+  /* Row to be written to table airway */
+  struct Row
   {
-    // Build airway fragments
-    QVector<Fragment> fragments;
-    buildAirway(currentAirway, airway, fragments);
+    const QString *name;
+    int airwayId, fragmentNum, seqNo;
+    const AirwaySegment *segment;
+  };
+
+  // Collect rows and assign ids in airway name order
+  QVector<Row> rows;
+  for(const Airway& airway : airways)
+  {
+    for(const Fragment& fragment : airway.fragments)
+    {
+      for(int i = 0; i < fragment.segments.size(); i++)
+        rows.append({&airway.name, curAirwayId + fragment.idOffset + i, fragment.fragmentNum, i + 1,
+                     &fragment.segments.at(i)});
+    }
 
-    // Remove all fragments that are contained by others
-    cleanFragments(fragments);
+    // Skip ids of removed fragments too
+    curAirwayId += airway.numIds;
+  }
 
-    for(const Fragment& fragment : qAsConst(fragments))
+  // Insert full batches first ==================
+  int numColumns = AIRWAY_COLUMNS.size();
+  int numBatchRows = rows.size() / INSERT_BATCH_ROWS * INSERT_BATCH_ROWS;
+  for(int i = 0; i < numBatchRows; i += INSERT_BATCH_ROWS)
+  {
+    for(int j = 0; j < INSERT_BATCH_ROWS; j++)
     {
-      for(const TypeRowValueVector& bindRow : fragment.boundValues)
-      {
-        airwayInsertStmt.bindValues(bindRow);
-        airwayInsertStmt.exec();
-        numAirways += airwayInsertStmt.numRowsAffected();
-      }
+      const Row& row = rows.at(i + j);
+      bindSegment(airwayInsertBatchStmt, j * numColumns, *row.name, row.airwayId, row.fragmentNum, row.seqNo,
+                  *row.segment);
     }
-    airway.clear();
+    airwayInsertBatchStmt.exec();
+    numAirways += airwayInsertBatchStmt.numRowsAffected();
   }
+
+  // Insert remaining rows one by one ==================
+  for(int i = numBatchRows; i < rows.size(); i++)
+  {
+    const Row& row = rows.at(i);
+    bindSegment(airwayInsertStmt, 0, *row.name, row.airwayId, row.fragmentNum, row.seqNo, *row.segment);
+    airwayInsertStmt.exec();
+    numAirways += airwayInsertStmt.numRowsAffected();
+  }
+}
+
+void AirwayResolver::bindSegment(sql::SqlQuery& query, int offset, const QString& airwayName, int airwayId,
+                                 int fragmentNum, int seqNo, const AirwaySegment& segment)
+{
+  // Create bounding rect for this segment
+  Rect bounding(segment.fromPos);
+  bounding.extend(segment.toPos);
+
+  // Order has to match AIRWAY_COLUMNS
+  query.bindValue(offset++, airwayId);
+  query.bindValue(offset++, airwayName);
+  query.bindValue(offset++, segment.type);
+  query.bindValue(offset++, fragmentNum);
+  query.bindValue(offset++, seqNo);
+  query.bindValue(offset++, segment.fromWaypointId);
+  query.bindValue(offset++, segment.toWaypointId);
+  query.bindValue(offset++, atools::charToStr(segment.dir));
+  query.bindValue(offset++, segment.minAlt);
+  query.bindValue(offset++, segment.maxAlt);
+  query.bindValue(offset++, bounding.getTopLeft().getLonX());
+  query.bindValue(offset++, bounding.getTopLeft().getLatY());
+  query.bindValue(offset++, bounding.getBottomRight().getLonX());
+  query.bindValue(offset++, bounding.getBottomRight().getLatY());
+
+  // Write start and end coordinates for this segment
+  query.bindValue(offset++, segment.fromPos.getLonX());
+  query.bindValue(offset++, segment.fromPos.getLatY());
+  query.bindValue(offset++, segment.toPos.getLonX());
+  query.bindValue(offset++, segment.toPos.getLatY());
 }
 
-void AirwayResolver::buildAirway(const QString& airwayName, QSet<AirwaySegment>& airway, QVector<Fragment>& fragments)
+void AirwayResolver::buildAirway(QSet<AirwaySegment>& airwaySegments, Airway& airway)
 {
   // Queue of waypoints that will get waypoints in order prependend and appendend
   QQueue<AirwaySegment> newAirway;
@@ -301,7 +528,7 @@ void AirwayResolver::buildAirway(const QString& airwayName, QSet<AirwaySegment>&
   QHash<int, AirwaySegment> segsByToWpId;
 
   // Fill the index
-  for(const AirwaySegment& segment : qAsConst(airway))
+  for(const AirwaySegment& segment : qAsConst(airwaySegments))
   {
     segsByFromWpId[segment.fromWaypointId] = segment;
     segsByToWpId[segment.toWaypointId] = segment;
@@ -312,13 +539,13 @@ void AirwayResolver::buildAirway(const QString& airwayName, QSet<AirwaySegment>&
 
   // Iterator over all waypoints in the airway which are neither ordered nor connected yet
   // All waypoints in airway have same airway name
-  while(!airway.empty())
+  while(!airwaySegments.empty())
   {
     newAirway.clear();
 
     // Take a random waypoint from the unordered airway and add it to the queue
-    segment = *airway.constBegin();
-    airway.erase(airway.constBegin());
+    segment = *airwaySegments.constBegin();
+    airwaySegments.erase(airwaySegments.constBegin());
     newAirway.append(segment);
 
     bool foundTo, foundFrom;
@@ -332,80 +559,45 @@ void AirwayResolver::buildAirway(const QString& airwayName, QSet<AirwaySegment>&
       // Take a segment from the front of the queue and find predecessors
       segment = newAirway.front();
       auto it = segsByToWpId.constFind(segment.fromWaypointId);
-      if(it != segsByToWpId.constEnd() && airway.constFind(it.value()) != airway.constEnd())
+      if(it != segsByToWpId.constEnd() && airwaySegments.constFind(it.value()) != airwaySegments.constEnd())
       {
         // Found a predecessor in the index - add it to the new airway and remove it from the queue
         segment = it.value();
         newAirway.prepend(segment);
 
-        airway.erase(airway.find(segment));
+        airwaySegments.erase(airwaySegments.find(segment));
         foundTo = true;
       }
 
       // Take a segment from the end of the queue and find successors
       segment = newAirway.back();
       it = segsByFromWpId.constFind(segment.toWaypointId);
-      if(it != segsByFromWpId.constEnd() && airway.constFind(it.value()) != airway.constEnd())
+      if(it != segsByFromWpId.constEnd() && airwaySegments.constFind(it.value()) != airwaySegments.constEnd())
       {
         // Found a successor in the index - add it to the new airway and remove it from the queue
         segment = it.value();
         newAirway.append(segment);
 
-        airway.erase(airway.constFind(segment));
+        airwaySegments.erase(airwaySegments.constFind(segment));
         foundFrom = true;
       }
     } while(foundTo || foundFrom);
 
-    // Write airway fragment - there may be more fragments for the same airway name
-    AirwaySegment last;
-    int seqNo = 1;
+    // Build airway fragment - there may be more fragments for the same airway name
     Fragment fragment;
+    fragment.fragmentNum = fragmentNum;
+    fragment.idOffset = airway.numIds;
 
     for(const AirwaySegment& newSegment : qAsConst(newAirway))
     {
-      last = newSegment;
-
       fragment.waypoints.insert(newSegment.fromWaypointId);
       fragment.waypoints.insert(newSegment.toWaypointId);
-
-      // Create bounding rect for this segment
-      Rect bounding(newSegment.fromPos);
-      bounding.extend(newSegment.toPos);
-
-      TypeRowValueVector row;
-
-      row.append(std::make_pair(":airway_id", curAirwayId));
-      row.append(std::make_pair(":airway_name", airwayName));
-      row.append(std::make_pair(":airway_type", newSegment.type));
-      // route_type varchar(5), unused
-
-      row.append(std::make_pair(":airway_fragment_no", fragmentNum));
-      row.append(std::make_pair(":sequence_no", seqNo));
-
-      row.append(std::make_pair(":from_waypoint_id", newSegment.fromWaypointId));
-      row.append(std::make_pair(":to_waypoint_id", newSegment.toWaypointId));
-
-      row.append(std::make_pair(":direction", atools::charToStr(newSegment.dir)));
-      row.append(std::make_pair(":minimum_altitude", newSegment.minAlt));
-      row.append(std::make_pair(":maximum_altitude", newSegment.maxAlt));
-      row.append(std::make_pair(":left_lonx", bounding.getTopLeft().getLonX()));
-      row.append(std::make_pair(":top_laty", bounding.getTopLeft().getLatY()));
-      row.append(std::make_pair(":right_lonx", bounding.getBottomRight().getLonX()));
-      row.append(std::make_pair(":bottom_laty", bounding.getBottomRight().getLatY()));
-
-      // Write start and end coordinates for this segment
-      row.append(std::make_pair(":from_lonx", newSegment.fromPos.getLonX()));
-      row.append(std::make_pair(":from_laty", newSegment.fromPos.getLatY()));
-      row.append(std::make_pair(":to_lonx", newSegment.toPos.getLonX()));
-      row.append(std::make_pair(":to_laty", newSegment.toPos.getLatY()));
-
-      fragment.boundValues.append(row);
-
-      seqNo++;
-      curAirwayId++;
+      fragment.segments.append(newSegment);
     }
-    fragments.append(fragment);
+    airway.fragments.append(fragment);
 
+    // Ids are used even if the fragment is removed later
+    airway.numIds += newAirway.size();
     fragmentNum++;
   }
 }
@@ -21,6 +21,7 @@
 #include "sql/sqlquery.h"
 
 #include <QSet>
+#include <QVector>
 #include <QCoreApplication>
 
 namespace atools {
@@ -34,6 +35,10 @@ namespace db {
 /*
  * Reads from the tmp_airway_point table that was filled with waypoint record data and connects the
  * waypoint lists to airways that are stored in table airway.
+ *
+ * All airway points and waypoints are loaded once into memory. Waypoint lookup is done using a hash
+ * and airways are resolved in parallel for batches of airway names. Results are written in airway name
+ * order using multi row insert statements.
  */
 class AirwayResolver
 {
@@ -66,33 +71,39 @@ public:
   }
 
 private:
-  float maxAirwaySegmentLengthNm = 0.f;
+  struct WaypointIndex;
+  struct AirwayPoint;
+  struct Fragment;
+  struct Airway;
 
-  typedef std::pair<QString, QVariant> TypeRowValue;
-  typedef QVector<TypeRowValue> TypeRowValueVector;
+  /* Load tmp_waypoint and tmp_airway_point tables into memory */
+  void loadWaypoints(WaypointIndex& waypoints);
+  void loadAirwayPoints(QVector<AirwayPoint>& airwayPoints, QVector<std::pair<int, int> >& airwayRanges,
+                        const WaypointIndex& waypoints);
 
-  struct Fragment
-  {
-    QSet<int> waypoints;
-    QVector<TypeRowValueVector> boundValues;
-  };
+  /* Collect segments for the airway points in the given range and build fragments. Thread safe. */
+  void resolveAirway(Airway& airway, const QVector<AirwayPoint>& airwayPoints, const std::pair<int, int>& range,
+                     const WaypointIndex& waypoints) const;
 
-  void buildAirway(const QString& airwayName, QSet<atools::fs::db::AirwayResolver::AirwaySegment>& airway,
-                   QVector<Fragment>& fragments);
+  static void buildAirway(QSet<atools::fs::db::AirwayResolver::AirwaySegment>& airwaySegments, Airway& airway);
 
   /* Remove empty segments and segments that are contained by another */
-  void cleanFragments(QVector<Fragment>& fragments);
+  static void cleanFragments(QVector<Fragment>& fragments);
 
-  /* Save airways to table airway */
-  void saveAirway(QSet<AirwaySegment>& airway, const QString& currentAirway);
+  /* Save airways to table airway using batched inserts */
+  void saveAirways(const QVector<Airway>& airways);
+  void bindSegment(sql::SqlQuery& query, int offset, const QString& airwayName, int airwayId, int fragmentNum,
+                   int seqNo, const AirwaySegment& segment);
 
   /* Fetch navaid id and position. Takes the nearest in case of disambiguities */
-  void fetchNavaid(int& id, atools::geo::Pos& pos, sql::SqlQuery& tmpAirwayPointQuery, sql::SqlQuery& tmpWaypointQuery,
-                   const QString& prefix, const atools::geo::Pos& lastPos);
+  static void fetchNavaid(int& id, atools::geo::Pos& pos, const WaypointIndex& waypoints, int keyIndex,
+                          const atools::geo::Pos& lastPos);
+
+  float maxAirwaySegmentLengthNm = 0.f;
 
   atools::fs::ProgressHandler& progressHandler;
   int curAirwayId, numAirways;
-  atools::sql::SqlQuery airwayInsertStmt;
+  atools::sql::SqlQuery airwayInsertStmt, airwayInsertBatchStmt;
   atools::sql::SqlDatabase *db;
 };
 
@@ -236,7 +236,7 @@ void DataWriter::writeSceneryArea(const SceneryArea& area)
   QStringList filepaths, filenames;
 
   // Get all BGL files in this scenery area
-  atools::fs::scenery::FileResolver resolver(options);
+  atools::fs::scenery::FileResolver resolver(options, false /* noWarnings */, packageCache);
   resolver.getFiles(area, &filepaths, &filenames);
 
   if(sceneryErrors != nullptr)
@@ -42,6 +42,7 @@ namespace scenery {
 class SceneryArea;
 class LanguageJson;
 class MaterialLib;
+class PackageCache;
 }
 class ProgressHandler;
 
@@ -285,6 +286,12 @@ public:
     materialLibScenery = value;
   }
 
+  /* Cache for MSFS layout files used to find BGL files */
+  void setPackageCache(atools::fs::scenery::PackageCache *value)
+  {
+    packageCache = value;
+  }
+
   atools::sql::SqlDatabase& getDatabase() const
   {
     return db;
@@ -346,6 +353,7 @@ private:
   const atools::fs::NavDatabaseOptions& options;
   const atools::fs::scenery::LanguageJson *languageIndex = nullptr;
   const atools::fs::scenery::MaterialLib *materialLib = nullptr, *materialLibScenery = nullptr;
+  atools::fs::scenery::PackageCache *packageCache = nullptr;
 };
 
 } // namespace writer
@@ -34,6 +34,7 @@
 #include "fs/scenery/layoutjson.h"
 #include "fs/scenery/manifestjson.h"
 #include "fs/scenery/materiallib.h"
+#include "fs/scenery/packagecache.h"
 #include "fs/scenery/scenerycfg.h"
 #include "fs/util/fsutil.h"
 #include "fs/xp/xpdatacompiler.h"
@@ -41,11 +42,12 @@
 #include "sql/sqlscript.h"
 #include "sql/sqltransaction.h"
 #include "sql/sqlutil.h"
+#include "util/fileoperations.h"
+#include "util/parallel.h"
 
 #include <QDir>
 #include <QElapsedTimer>
 #include <QProcessEnvironment>
-#include <QQueue>
 #include <QStandardPaths>
 #include <QStringBuilder>
 
@@ -90,6 +92,7 @@ using atools::buildPathNoCase;
 NavDatabase::~NavDatabase()
 {
   ATOOLS_DELETE_LOG(simconnectLoader);
+  ATOOLS_DELETE_LOG(packageCache);
 }
 
 atools::fs::ResultFlags NavDatabase::compileDatabase()
@@ -619,11 +622,21 @@ atools::fs::ResultFlags NavDatabase::createInternal(const QString& sceneryConfig
     total = countDfdSteps();
   else if(sim == FsPaths::MSFS || sim == FsPaths::MSFS_2024)
   {
+    // Cache for parsed manifest and layout files - load from last compilation if available
+    if(packageCache == nullptr)
+      packageCache = new scenery::PackageCache;
+    if(!options->getPackageCacheFile().isEmpty())
+      packageCache->loadFile(options->getPackageCacheFile());
+
     // Fill with default required entries but does not read a file
     readSceneryConfigMsfs(sceneryCfg);
     readSceneryConfigIncludePathsFsxP3dMsfs(sceneryCfg);
     total = countMsfsSteps(&progress, sceneryCfg);
 
+    // Save manifest and layout files which are read now
+    if(!options->getPackageCacheFile().isEmpty())
+      packageCache->saveFile(options->getPackageCacheFile());
+
     if(sim == FsPaths::MSFS)
     {
       // Check for Navigraph packages to report back to caller
@@ -726,6 +739,7 @@ atools::fs::ResultFlags NavDatabase::createInternal(const QString& sceneryConfig
   {
     // Load FSX / P3D scenery database ======================================================
     fsDataWriter.reset(new atools::fs::db::DataWriter(*db, *options, &progress));
+    fsDataWriter->setPackageCache(packageCache);
 
     // Base is
     // C:/Users/alex/AppData/Local/Packages/Microsoft.FlightSimulator_8wekyb3d8bbwe/LocalCache/Packages
@@ -747,6 +761,7 @@ atools::fs::ResultFlags NavDatabase::createInternal(const QString& sceneryConfig
 
       // Load translation file in current language for airport names ====================================
       languageIndex.reset(new scenery::LanguageJson());
+      languageIndex->setPackageCache(packageCache);
       languageIndex->clear();
       if(langFile.exists() && langFile.isFile())
         languageIndex->readFromFile(langFile.filePath(), {"AIRPORT"});
@@ -757,6 +772,7 @@ atools::fs::ResultFlags NavDatabase::createInternal(const QString& sceneryConfig
       // Load the two official material libraries ================================
       SceneryErrors materialLibErrors;
       materialLib.reset(new scenery::MaterialLib(options, &progress, &materialLibErrors));
+      materialLib->setPackageCache(packageCache);
       materialLib->readOfficial(packageBase);
       fsDataWriter->setMaterialLib(materialLib.data());
 
@@ -767,6 +783,10 @@ atools::fs::ResultFlags NavDatabase::createInternal(const QString& sceneryConfig
     // Load all community and official scenery/BGL files  =====================================
     loadMsfs(&progress, fsDataWriter.data(), sceneryCfg);
     fsDataWriter->close();
+
+    // Save material libraries and language files read while loading
+    if(!options->getPackageCacheFile().isEmpty())
+      packageCache->saveFile(options->getPackageCacheFile());
   }
   else
   {
@@ -1258,6 +1278,7 @@ bool NavDatabase::loadFsxP3dMsfsSimulator(ProgressHandler *progress, db::DataWri
 {
   SceneryErrors materialLibErrors;
   scenery::MaterialLib materialLib(options, progress, &materialLibErrors);
+  materialLib.setPackageCache(packageCache);
 
   for(const SceneryArea& area : areas)
   {
@@ -1738,8 +1759,6 @@ void NavDatabase::readSceneryConfigMsfs(atools::fs::scenery::SceneryCfg& cfg)
     cfg.appendArea(areaNav);
   }
 
-  scenery::LayoutJson layout;
-
   // Read add-on packages in official ===============================
   if(options->getSimulatorType() == FsPaths::MSFS)
   {
@@ -1747,6 +1766,9 @@ void NavDatabase::readSceneryConfigMsfs(atools::fs::scenery::SceneryCfg& cfg)
     const QDir dirOfficial(path, QString(), QDir::Name | QDir::IgnoreCase, QDir::Dirs | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
     QString baseName = dirOfficial.dirName();
     const QFileInfoList entriesOfficial = dirOfficial.entryInfoList();
+
+    // Collect package directories ===================
+    QFileInfoList packagesOfficial;
     for(QFileInfo fileinfo : entriesOfficial)
     {
       QString name = fileinfo.fileName();
@@ -1763,16 +1785,23 @@ void NavDatabase::readSceneryConfigMsfs(atools::fs::scenery::SceneryCfg& cfg)
         // Already read before - do not touch name or priority
         continue;
 
-      // Read manifest to check type
-      manifest.clear();
-      manifest.read(fileinfo.filePath() % SEP % "manifest.json");
+      packagesOfficial.append(fileinfo);
+    }
+
+    // Read manifest and layout files in parallel ===================
+    QVector<scenery::ManifestJson> manifests;
+    QVector<scenery::LayoutJson> layouts;
+    readPackagesMsfs(manifests, layouts, packagesOfficial);
+
+    for(int i = 0; i < packagesOfficial.size(); i++)
+    {
+      const QFileInfo& fileinfo = packagesOfficial.at(i);
+      QString name = fileinfo.fileName();
+      const scenery::ManifestJson& manifest = manifests.at(i);
+      const scenery::LayoutJson& layout = layouts.at(i);
 
       if(manifest.isAnyScenery())
       {
-        // Read BGL and material file locations from layout file
-        layout.clear();
-        layout.read(fileinfo.filePath() % SEP % "layout.json");
-
         SceneryArea addonArea(contentXml.getPriority(name, LAYER_NUM_DEFAULT), baseName, atools::canonicalFilePath(fileinfo));
         if(manifest.isScenery() && layout.hasFsArchive() && errors != nullptr)
           errors->appendSceneryErrors(
@@ -1800,6 +1829,9 @@ void NavDatabase::readSceneryConfigMsfs(atools::fs::scenery::SceneryCfg& cfg)
                               QDir::Name | QDir::IgnoreCase, QDir::Dirs | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
 
       const QFileInfoList entriesCommunity = dirCommunity.entryInfoList();
+
+      // Collect package directories ===================
+      QFileInfoList packagesCommunity;
       for(QFileInfo fileinfo : entriesCommunity)
       {
         QString name = fileinfo.fileName();
@@ -1812,15 +1844,21 @@ void NavDatabase::readSceneryConfigMsfs(atools::fs::scenery::SceneryCfg& cfg)
           continue;
         }
 
-        manifest.clear();
-        manifest.read(fileinfo.filePath() % SEP % "manifest.json");
+        packagesCommunity.append(fileinfo);
+      }
+
+      // Read manifest and layout files in parallel ===================
+      readPackagesMsfs(manifests, layouts, packagesCommunity);
+
+      for(int i = 0; i < packagesCommunity.size(); i++)
+      {
+        const QFileInfo& fileinfo = packagesCommunity.at(i);
+        QString name = fileinfo.fileName();
+        const scenery::ManifestJson& manifest = manifests.at(i);
+        const scenery::LayoutJson& layout = layouts.at(i);
 
         if(manifest.isAnyScenery())
         {
-          // Read BGL and material file locations from layout file
-          layout.clear();
-          layout.read(fileinfo.filePath() % SEP % "layout.json");
-
           SceneryArea addonArea(contentXml.getPriority(name, LAYER_NUM_DEFAULT), tr("Community"), atools::canonicalFilePath(fileinfo));
           addonArea.setCommunity(true);
           if(manifest.isScenery() && layout.hasFsArchive() && errors != nullptr)
@@ -1844,7 +1882,35 @@ void NavDatabase::readSceneryConfigMsfs(atools::fs::scenery::SceneryCfg& cfg)
   cfg.sortAreas();
 }
 
-bool NavDatabase::isNavigraphNavdata(atools::fs::scenery::ManifestJson& manifest)
+void NavDatabase::readPackagesMsfs(QVector<scenery::ManifestJson>& manifests, QVector<scenery::LayoutJson>& layouts,
+                                   const QFileInfoList& packageDirs)
+{
+  manifests.clear();
+  manifests.resize(packageDirs.size());
+  layouts.clear();
+  layouts.resize(packageDirs.size());
+
+  scenery::ManifestJson *manifestData = manifests.data();
+  scenery::LayoutJson *layoutData = layouts.data();
+  scenery::PackageCache *cache = packageCache;
+
+  // Reading is I/O bound - use one package per task to keep threads busy on slow drives
+  atools::util::parallelFor(packageDirs.size(), [&packageDirs, manifestData, layoutData, cache](int begin, int end) -> void {
+        for(int i = begin; i < end; i++)
+        {
+          QString path = packageDirs.at(i).filePath();
+
+          // Read manifest to check type
+          manifestData[i] = cache->getManifest(path % SEP % "manifest.json");
+
+          if(manifestData[i].isAnyScenery())
+            // Read BGL and material file locations from layout file
+            layoutData[i] = cache->getLayout(path % SEP % "layout.json");
+        }
+      }, 1 /* minChunkSize */);
+}
+
+bool NavDatabase::isNavigraphNavdata(const scenery::ManifestJson& manifest)
 {
   // navigraph-navdata
   // Procedures and airport centers
@@ -1906,33 +1972,19 @@ void NavDatabase::readSceneryConfigIncludePathsFsxP3dMsfs(atools::fs::scenery::S
   for(int i = 0; i < dirs.size(); i++)
   {
     // Read entries recursively for user added folder ===================
-    QQueue<QFileInfo> queue;
-    // Add intial path
-    queue.enqueue(dirs.at(i));
-
     QFileInfoList entries(QDir(dirs.at(i)).entryInfoList(filters));
-    while(!queue.isEmpty())
-    {
-      const QFileInfoList entriesDir = QDir(queue.dequeue().absoluteFilePath(), QString(), QDir::Name, filters).entryInfoList();
-      for(const QFileInfo& fileinfo : entriesDir)
-      {
-        bool ok = false;
-        if(options->getSimulatorType() == atools::fs::FsPaths::MSFS)
-          // Detect MSFS by looking for the two JSON files
-          ok = atools::checkFile(Q_FUNC_INFO, fileinfo.absoluteFilePath() % atools::SEP % "manifest.json") &&
-               atools::checkFile(Q_FUNC_INFO, fileinfo.absoluteFilePath() % atools::SEP % "layout.json");
-        else
-          // FSX and P3D scenery is detected by folder "scenery"
-          ok = atools::checkDir(Q_FUNC_INFO, fileinfo.absoluteFilePath() % atools::SEP % "scenery");
 
-        // Folder contains airport - add to list and do not descent further
-        if(ok)
-          entries.append(fileinfo);
-        else
-          // Folder does not contain airport - enqueue and descent further
-          queue.enqueue(fileinfo);
-      }
-    }
+    bool msfs = options->getSimulatorType() == atools::fs::FsPaths::MSFS;
+    entries.append(atools::util::FileOperations::findDirectories(dirs.at(i), [msfs](const QFileInfo& fileinfo) -> bool {
+          // Folder contains airport - add to list and do not descent further
+          if(msfs)
+            // Detect MSFS by looking for the two JSON files
+            return atools::checkFile(Q_FUNC_INFO, fileinfo.absoluteFilePath() % atools::SEP % "manifest.json") &&
+                   atools::checkFile(Q_FUNC_INFO, fileinfo.absoluteFilePath() % atools::SEP % "layout.json");
+          else
+            // FSX and P3D scenery is detected by folder "scenery"
+            return atools::checkDir(Q_FUNC_INFO, fileinfo.absoluteFilePath() % atools::SEP % "scenery");
+        }, filters));
 
 #ifdef DEBUG_INFORMATION
     qDebug() << Q_FUNC_INFO << "User defined dir content" << entries;
@@ -2239,7 +2291,7 @@ void NavDatabase::countFiles(ProgressHandler *progress, const QList<atools::fs::
                              int& numFiles, int& numSceneryAreas)
 {
   qDebug() << Q_FUNC_INFO << "Entry";
-  atools::fs::scenery::FileResolver resolver(*options, true);
+  atools::fs::scenery::FileResolver resolver(*options, true, packageCache);
 
   for(const SceneryArea& area : areas)
   {
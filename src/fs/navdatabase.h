@@ -24,6 +24,7 @@
 #include <QDebug>
 #include <QCoreApplication>
 #include <QFileInfo>
+#include <QVector>
 
 namespace atools {
 namespace win {
@@ -48,6 +49,8 @@ class SceneryCfg;
 class AddOnComponent;
 class SceneryArea;
 class ManifestJson;
+class LayoutJson;
+class PackageCache;
 }
 
 namespace db {
@@ -216,9 +219,17 @@ private:
   void calculateRating(atools::fs::FsPaths::SimulatorType sim);
 
   /* Detect Navigraph navdata update packages for special handling. */
-  bool isNavigraphNavdata(atools::fs::scenery::ManifestJson& manifest);
+  bool isNavigraphNavdata(const atools::fs::scenery::ManifestJson& manifest);
+
+  /* Get manifest and layout files for all MSFS package directories in parallel using the package cache.
+   * Layout is only read for scenery packages. Result vectors have the same size and order as packageDirs. */
+  void readPackagesMsfs(QVector<atools::fs::scenery::ManifestJson>& manifests, QVector<atools::fs::scenery::LayoutJson>& layouts,
+                        const QFileInfoList& packageDirs);
 
   atools::fs::sc::db::SimConnectLoader *simconnectLoader = nullptr;
+
+  /* Parsed MSFS manifest and layout files. Only used for MSFS compilation. */
+  atools::fs::scenery::PackageCache *packageCache = nullptr;
   const atools::win::ActivationContext *activationContext = nullptr;
   QString libraryName;
 
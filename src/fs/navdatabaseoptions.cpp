@@ -28,7 +28,7 @@
 namespace atools {
 namespace fs {
 
-const static QList<QRegExp> EMPTY_REGEXP_LIST;
+const static atools::util::WildcardFilter EMPTY_FILTER;
 
 void NavDatabaseOptions::setLanguage(const QString& lang)
 {
@@ -99,24 +99,25 @@ bool NavDatabaseOptions::isAddonGui(const QFileInfo& filepath) const
   return includedGui(filepath, dirAddonExcludesGui, fileAddonExcludesGui);
 }
 
-bool NavDatabaseOptions::includedGui(const QFileInfo& path, const QList<QRegExp>& fileExclude, const QList<QRegExp>& dirExclude) const
+bool NavDatabaseOptions::includedGui(const QFileInfo& path, const atools::util::WildcardFilter& fileExclude,
+                                     const atools::util::WildcardFilter& dirExclude) const
 {
   if(fileExclude.isEmpty() && dirExclude.isEmpty())
     return true;
 
   if(path.isDir())
   {
-    if(!includeObject(adaptDir(atools::canonicalFilePath(path)), EMPTY_REGEXP_LIST, dirExclude))
+    if(!includeObject(adaptDir(atools::canonicalFilePath(path)), EMPTY_FILTER, dirExclude))
       return false;
   }
   else if(path.isFile())
   {
     // First check path to file
-    if(!includeObject(adaptDir(atools::canonicalPath(path)), EMPTY_REGEXP_LIST, dirExclude))
+    if(!includeObject(adaptDir(atools::canonicalPath(path)), EMPTY_FILTER, dirExclude))
       return false;
 
     // Check file name
-    if(!includeObject(atools::canonicalFilePath(path), EMPTY_REGEXP_LIST, fileExclude))
+    if(!includeObject(atools::canonicalFilePath(path), EMPTY_FILTER, fileExclude))
       return false;
   }
 
@@ -128,7 +129,7 @@ bool NavDatabaseOptions::isHighPriority(const QString& filepath) const
   if(highPriorityFiltersInc.isEmpty())
     return false;
 
-  return includeObject(adaptDir(filepath), highPriorityFiltersInc, EMPTY_REGEXP_LIST);
+  return includeObject(adaptDir(filepath), highPriorityFiltersInc, EMPTY_FILTER);
 }
 
 bool NavDatabaseOptions::isIncludedFilename(const QString& filename) const
@@ -289,36 +290,20 @@ void NavDatabaseOptions::loadFromSettings(QSettings& settings)
   settings.endGroup();
 }
 
-bool NavDatabaseOptions::includeObject(const QString& string, const QList<QRegExp>& filterListInc,
-                                       const QList<QRegExp>& filterListExcl) const
+bool NavDatabaseOptions::includeObject(const QString& string, const atools::util::WildcardFilter& filterListInc,
+                                       const atools::util::WildcardFilter& filterListExcl) const
 {
   if(filterListInc.isEmpty() && filterListExcl.isEmpty())
     return true;
 
-  bool excludeMatched = false;
-  for(const QRegExp& iter : filterListExcl)
-  {
-    if(iter.exactMatch(string))
-    {
-      excludeMatched = true;
-      break;
-    }
-  }
+  bool excludeMatched = filterListExcl.matches(string);
 
   if(filterListInc.isEmpty())
     // No include filters - let exclude filter decide
     return !excludeMatched;
   else
   {
-    bool includeMatched = false;
-    for(const QRegExp& iter : filterListInc)
-    {
-      if(iter.exactMatch(string))
-      {
-        includeMatched = true;
-        break;
-      }
-    }
+    bool includeMatched = filterListInc.matches(string);
 
     if(filterListExcl.isEmpty())
       // No exclude filters - let include filter decide
@@ -328,16 +313,16 @@ bool NavDatabaseOptions::includeObject(const QString& string, const QList<QRegEx
   }
 }
 
-void NavDatabaseOptions::addToFilterList(const QStringList& filters, QList<QRegExp>& filterList)
+void NavDatabaseOptions::addToFilterList(const QStringList& filters, atools::util::WildcardFilter& filterList)
 {
   for(const QString& filter : filters)
     addToFilter(filter, filterList);
 }
 
-void NavDatabaseOptions::addToFilter(const QString& filter, QList<QRegExp>& filterList)
+void NavDatabaseOptions::addToFilter(const QString& filter, atools::util::WildcardFilter& filterList)
 {
   if(!filter.isEmpty())
-    filterList.append(QRegExp(filter.trimmed(), Qt::CaseInsensitive, QRegExp::Wildcard));
+    filterList.addPattern(filter.trimmed());
 }
 
 QString NavDatabaseOptions::adaptDir(const QString& filepath) const
@@ -358,12 +343,9 @@ QStringList NavDatabaseOptions::fromNativeSeparatorList(const QStringList& paths
   return retval;
 }
 
-QString patternStr(const QList<QRegExp>& list)
+QString patternStr(const atools::util::WildcardFilter& filter)
 {
-  QStringList retval;
-  for(const QRegExp& regexp : list)
-    retval.append(regexp.pattern());
-  return retval.join(", ");
+  return filter.getPatterns().join(", ");
 }
 
 QDebug operator<<(QDebug out, const NavDatabaseOptions& opts)
@@ -378,6 +360,7 @@ QDebug operator<<(QDebug out, const NavDatabaseOptions& opts)
   out << ", SimConnectLoadDisconnected \"" << opts.simConnectLoadDisconnected << "\"";
   out << ", SimConnectLoadDisconnectedFile \"" << opts.simConnectLoadDisconnectedFile << "\"";
   out << ", sceneryFile \"" << opts.sceneryFile << "\"";
+  out << ", packageCacheFile \"" << opts.packageCacheFile << "\"";
   out << ", basepath \"" << opts.basepath << "\"";
   out << ", msfsCommunityPath \"" << opts.msfsCommunityPath << "\"";
   out << ", msfsOfficialPath \"" << opts.msfsOfficialPath << "\"";
@@ -20,6 +20,7 @@
 
 #include "fs/fspaths.h"
 #include "util/flags.h"
+#include "util/wildcardfilter.h"
 
 #include <functional>
 
@@ -183,6 +184,15 @@ public:
     msfsOfficialPath = value;
   }
 
+  /*
+   * Set file used to keep parsed MSFS "manifest.json" and "layout.json" files between compilations.
+   * Unchanged packages are not read again if set. Default is empty which disables the persistent cache.
+   */
+  void setPackageCacheFile(const QString& value)
+  {
+    packageCacheFile = value;
+  }
+
   /*
    * Set source database to copy from.
    */
@@ -325,6 +335,11 @@ public:
     return msfsOfficialPath;
   }
 
+  const QString& getPackageCacheFile() const
+  {
+    return packageCacheFile;
+  }
+
   const QString& getSourceDatabase() const
   {
     return sourceDatabase;
@@ -477,9 +492,9 @@ public:
   void setLanguage(const QString& lang);
 
   /* Get raw filter for SimConnect interface to limit reading of airports to selection. */
-  const QList<QRegExp>& getAirportIcaoFiltersInc() const
+  QList<QRegExp> getAirportIcaoFiltersInc() const
   {
-    return airportIcaoFiltersInc;
+    return airportIcaoFiltersInc.toRegExpList();
   }
 
   int getSimConnectAirportFetchDelay() const
@@ -548,9 +563,10 @@ private:
 
   void addToHighPriorityFiltersInc(const QStringList& filters);
 
-  void addToFilterList(const QStringList& filters, QList<QRegExp>& filterList);
-  void addToFilter(const QString& filter, QList<QRegExp>& filterList);
-  bool includeObject(const QString& string, const QList<QRegExp>& filterListInc, const QList<QRegExp>& filterListExcl) const;
+  void addToFilterList(const QStringList& filters, atools::util::WildcardFilter& filterList);
+  void addToFilter(const QString& filter, atools::util::WildcardFilter& filterList);
+  bool includeObject(const QString& string, const atools::util::WildcardFilter& filterListInc,
+                     const atools::util::WildcardFilter& filterListExcl) const;
 
   void addToBglObjectFilter(const QStringList& filters, QSet<atools::fs::type::NavDbObjectType>& filterList);
 
@@ -559,19 +575,21 @@ private:
   QStringList fromNativeSeparatorList(const QStringList& paths) const;
   QString createDirFilter(const QString& path);
 
-  bool includedGui(const QFileInfo& path, const QList<QRegExp>& fileExclude, const QList<QRegExp>& dirExclude) const;
+  bool includedGui(const QFileInfo& path, const atools::util::WildcardFilter& fileExclude,
+                   const atools::util::WildcardFilter& dirExclude) const;
 
-  QString sceneryFile, basepath, msfsCommunityPath, msfsOfficialPath, sourceDatabase, language = "en-US";
+  QString sceneryFile, basepath, msfsCommunityPath, msfsOfficialPath, sourceDatabase, language = "en-US",
+          packageCacheFile;
 
   atools::fs::type::OptionFlags flags;
 
   QMap<QString, int> basicValidationTables;
-  QList<QRegExp> fileFiltersInc, pathFiltersInc, addonFiltersInc, airportIcaoFiltersInc,
-                 fileFiltersExcl, pathFiltersExcl, addonFiltersExcl, airportIcaoFiltersExcl,
-                 highPriorityFiltersInc;
+  atools::util::WildcardFilter fileFiltersInc, pathFiltersInc, addonFiltersInc, airportIcaoFiltersInc,
+                               fileFiltersExcl, pathFiltersExcl, addonFiltersExcl, airportIcaoFiltersExcl,
+                               highPriorityFiltersInc;
 
   /* Elements set from GUI. Not loaded from config file */
-  QList<QRegExp> dirExcludesGui, fileExcludesGui, dirAddonExcludesGui, fileAddonExcludesGui;
+  atools::util::WildcardFilter dirExcludesGui, fileExcludesGui, dirAddonExcludesGui, fileAddonExcludesGui;
   QStringList dirIncludesGui;
 
   QSet<atools::fs::type::NavDbObjectType> navDbObjectTypeFiltersInc, navDbObjectTypeFiltersExcl;
@@ -38,6 +38,26 @@ using Qt::dec;
 using Qt::endl;
 #endif
 
+/* Emit statistics every milliseconds */
+static const qint64 STATISTICS_INTERVAL_MS = 10000;
+
+QDebug operator<<(QDebug out, const DataReaderTaskStatistics& stats)
+{
+  QDebugStateSaver saver(out);
+  out.nospace() << "[runs " << stats.numRuns << ", skipped " << stats.numSkipped
+                << ", latency " << stats.lastLatencyMs << "/" << stats.averageLatencyMs << "/" << stats.maxLatencyMs
+                << " ms, drift " << stats.lastDriftMs << "/" << stats.maxDriftMs << " ms, age " << stats.getAgeMs() << " ms]";
+  return out;
+}
+
+QDebug operator<<(QDebug out, const DataReaderStatistics& stats)
+{
+  QDebugStateSaver saver(out);
+  out.nospace() << "DataReaderStatistics[user " << stats.userAircraft << ", AI " << stats.aiAircraft
+                << ", weather " << stats.weather << "]";
+  return out;
+}
+
 void DataReaderThread::debugWriteWhazzup(const atools::fs::sc::SimConnectData& dataPacket)
 {
   static QDateTime last;
@@ -219,6 +239,7 @@ DataReaderThread::DataReaderThread(QObject *parent, bool verboseLog)
 {
   qDebug() << Q_FUNC_INFO;
   setObjectName("DataReaderThread");
+  qRegisterMetaType<atools::fs::sc::DataReaderStatistics>();
 
   options = atools::fs::sc::FETCH_AI_AIRCRAFT | atools::fs::sc::FETCH_AI_BOAT;
 }
@@ -330,6 +351,15 @@ void DataReaderThread::run()
   numErrors = 0;
   failedTerminally = false;
 
+  // Start schedule ============================================
+  {
+    QMutexLocker locker(&statisticsMutex);
+    userTask = aiTask = weatherTask = ScheduledTask();
+  }
+  aiAircraftCache.clear();
+  nextStatisticsMs = STATISTICS_INTERVAL_MS;
+  timer.start();
+
   // Main loop  ============================================
   while(!terminate)
   {
@@ -379,83 +409,98 @@ void DataReaderThread::run()
         closeReplay();
       }
     } // if(loadReplayFile != nullptr)
-    else if(fetchData(data, aiFetchRadiusKm, opts))
+    else if(isWeatherRequested() || timer.elapsed() >= userTask.nextDueMs)
     {
-      // Data fetched from simconnect - send to client ============================================
-      if(verbose && !data.getMetars().isEmpty())
-        qDebug() << "DataReaderThread::run() num metars" << data.getMetars().size();
-
-      emit postSimConnectData(data);
-
-      if(saveReplayFile != nullptr && saveReplayFile->isOpen() && data.getPacketId() > 0)
-        // Save only simulator packets, not weather replays
-        data.write(saveReplayFile);
-    }
-    else
-    {
-      if(handler->getState() != atools::fs::sc::STATEOK)
+      if(fetchScheduled(data, opts))
       {
-        // Error fetching data from simconnect ============================================
-        connected = false;
-        emit disconnectedFromSimulator();
+        // Data fetched from simconnect - send to client ============================================
+        if(verbose && !data.getMetars().isEmpty())
+          qDebug() << "DataReaderThread::run() num metars" << data.getMetars().size();
 
-        emit postStatus(data.getStatus(), data.getStatusText());
-
-        qWarning() << "Error fetching data from simulator." << data.getStatusText();
+        emit postSimConnectData(data);
 
-        if(numErrors++ > MAX_NUMBER_OF_ERRORS)
+        if(saveReplayFile != nullptr && saveReplayFile->isOpen() && data.getPacketId() > 0)
+          // Save only simulator packets, not weather replays
+          data.write(saveReplayFile);
+      }
+      else
+      {
+        if(handler->getState() != atools::fs::sc::STATEOK)
         {
-          qWarning() << "Failed terminally - restart needed";
-          failedTerminally = true;
-          emit postLogMessage(tr("Too many errors reading from simulator. Disconnected.\n"
-                                 "The simulator has probably crashed.\n\n"
-                                 "Restart %1 to try again.").
-                              arg(QCoreApplication::applicationName()), false, true);
-          break;
+          // Error fetching data from simconnect ============================================
+          connected = false;
+          emit disconnectedFromSimulator();
+
+          emit postStatus(data.getStatus(), data.getStatusText());
+
+          qWarning() << "Error fetching data from simulator." << data.getStatusText();
+
+          if(numErrors++ > MAX_NUMBER_OF_ERRORS)
+          {
+            qWarning() << "Failed terminally - restart needed";
+            failedTerminally = true;
+            emit postLogMessage(tr("Too many errors reading from simulator. Disconnected.\n"
+                                   "The simulator has probably crashed.\n\n"
+                                   "Restart %1 to try again.").
+                                arg(QCoreApplication::applicationName()), false, true);
+            break;
+          }
+
+          if(!handler->isSimRunning())
+            // Try to reconnect if we lost connection to simulator
+            connectToSimulator();
         }
+        else if(data.getStatus() != OK)
+        {
+          connected = false;
+          emit disconnectedFromSimulator();
 
-        if(!handler->isSimRunning())
-          // Try to reconnect if we lost connection to simulator
-          connectToSimulator();
-      }
-      else if(data.getStatus() != OK)
-      {
-        connected = false;
-        emit disconnectedFromSimulator();
+          emit postStatus(data.getStatus(), data.getStatusText());
 
-        emit postStatus(data.getStatus(), data.getStatusText());
+          qWarning() << "Error fetching data from simulator." << data.getStatusText();
 
-        qWarning() << "Error fetching data from simulator." << data.getStatusText();
+          emit postLogMessage(tr("Error reading from simulator: %1. Disconnected. "
+                                 "Restart <i>%2</i> to try again.").
+                              arg(data.getStatusText()).
+                              arg(QCoreApplication::applicationName()), false, true);
 
-        emit postLogMessage(tr("Error reading from simulator: %1. Disconnected. "
-                               "Restart <i>%2</i> to try again.").
-                            arg(data.getStatusText()).
-                            arg(QCoreApplication::applicationName()), false, true);
+          if(data.getStatus() == INVALID_MAGIC_NUMBER || data.getStatus() == VERSION_MISMATCH)
+          {
+            emit postLogMessage(tr("Your installed version of Little Xpconnect "
+                                   "is not compatible with this version of %2.").
+                                arg(QCoreApplication::applicationName()), false, true);
+            emit postLogMessage(tr("Install the latest version of Little Xpconnect."), false, true);
+          }
 
-        if(data.getStatus() == INVALID_MAGIC_NUMBER || data.getStatus() == VERSION_MISMATCH)
-        {
-          emit postLogMessage(tr("Your installed version of Little Xpconnect "
-                                 "is not compatible with this version of %2.").
-                              arg(QCoreApplication::applicationName()), false, true);
-          emit postLogMessage(tr("Install the latest version of Little Xpconnect."), false, true);
+          break;
         }
-
-        break;
+        // else
+        // qWarning() << "No data fetched";
       }
-      // else
-      // qWarning() << "No data fetched";
     }
 
-    unsigned long sleepMs = 500;
+    unsigned long sleepMs = 0;
     if(loadReplayFile != nullptr)
       sleepMs = static_cast<unsigned long>(static_cast<float>(replayUpdateRateMs) /
                                            static_cast<float>(replaySpeed));
     else
-      sleepMs = updateRate;
+    {
+      if(timer.elapsed() >= nextStatisticsMs)
+      {
+        publishStatistics();
+        nextStatisticsMs = timer.elapsed() + STATISTICS_INTERVAL_MS;
+      }
 
-    bool wakeUpSignalled = waitCondition.wait(&waitMutex, sleepMs);
-    if(wakeUpSignalled && verbose)
-      qDebug() << "DataReaderThread::run wakeUpSignalled";
+      // Sleep until the user aircraft is due again
+      sleepMs = static_cast<unsigned long>(std::max(userTask.nextDueMs - timer.elapsed(), static_cast<qint64>(0)));
+    }
+
+    if(sleepMs > 0)
+    {
+      bool wakeUpSignalled = waitCondition.wait(&waitMutex, sleepMs);
+      if(wakeUpSignalled && verbose)
+        qDebug() << "DataReaderThread::run wakeUpSignalled";
+    }
   }
 
   closeReplay();
@@ -475,6 +520,104 @@ void DataReaderThread::run()
   qDebug() << Q_FUNC_INFO << "leave";
 }
 
+bool DataReaderThread::fetchScheduled(atools::fs::sc::SimConnectData& data, Options fetchOptions)
+{
+  const Options aiOptions = atools::fs::sc::FETCH_AI_AIRCRAFT | atools::fs::sc::FETCH_AI_BOAT;
+  qint64 startMs = timer.elapsed();
+
+  if(isWeatherRequested())
+  {
+    // Weather on demand - does not change the schedule of the aircraft
+    bool result = fetchData(data, aiFetchRadiusKm, fetchOptions);
+    finishTask(weatherTask, startMs, 0, result);
+    return result;
+  }
+
+  // AI aircraft and boats only if enabled and due ===============
+  bool fetchAi = (fetchOptions & aiOptions) && startMs >= aiTask.nextDueMs;
+  bool result = fetchData(data, aiFetchRadiusKm, fetchAi ? fetchOptions : fetchOptions & ~aiOptions);
+
+  finishTask(userTask, startMs, updateRate, result);
+
+  if(fetchAi)
+  {
+    finishTask(aiTask, startMs, std::max(aiUpdateRate, updateRate), result);
+    if(result)
+      aiAircraftCache = data.getAiAircraftConst();
+  }
+  else if(fetchOptions & aiOptions)
+  {
+    // Attach AI from last fetch to avoid clients dropping them
+    if(result)
+      data.getAiAircraft() = aiAircraftCache;
+  }
+  else
+    aiAircraftCache.clear();
+
+  return result;
+}
+
+void DataReaderThread::finishTask(ScheduledTask& task, qint64 startMs, qint64 intervalMs, bool success)
+{
+  qint64 now = timer.elapsed();
+  qint64 latency = now - startMs;
+
+  QMutexLocker locker(&statisticsMutex);
+  DataReaderTaskStatistics& stats = task.stats;
+  stats.numRuns++;
+  stats.lastLatencyMs = latency;
+  stats.maxLatencyMs = std::max(stats.maxLatencyMs, latency);
+
+  if(stats.numRuns == 1)
+    stats.averageLatencyMs = static_cast<float>(latency);
+  else
+    stats.averageLatencyMs = stats.averageLatencyMs * 0.9f + static_cast<float>(latency) * 0.1f;
+
+  if(intervalMs > 0)
+  {
+    // Periodic task ==================
+    stats.lastDriftMs = std::max(startMs - task.nextDueMs, static_cast<qint64>(0));
+    stats.maxDriftMs = std::max(stats.maxDriftMs, stats.lastDriftMs);
+
+    task.nextDueMs += intervalMs;
+    if(task.nextDueMs <= now)
+    {
+      // Fell behind - skip missed runs instead of catching up
+      stats.numSkipped += static_cast<int>((now - task.nextDueMs) / intervalMs) + 1;
+      task.nextDueMs = now + intervalMs;
+    }
+  }
+
+  if(success)
+    stats.lastUpdate = QDateTime::currentDateTimeUtc();
+}
+
+void DataReaderThread::publishStatistics()
+{
+  DataReaderStatistics statistics = getStatistics();
+
+  if(verbose)
+    qDebug() << Q_FUNC_INFO << statistics;
+
+  emit postStatistics(statistics);
+}
+
+DataReaderStatistics DataReaderThread::getStatistics() const
+{
+  QMutexLocker locker(&statisticsMutex);
+  DataReaderStatistics statistics;
+  statistics.userAircraft = userTask.stats;
+  statistics.aiAircraft = aiTask.stats;
+  statistics.weather = weatherTask.stats;
+  return statistics;
+}
+
+bool DataReaderThread::isWeatherRequested() const
+{
+  QMutexLocker locker(&handlerMutex);
+  return handler->isLoaded() && handler->getWeatherRequest().isValid();
+}
+
 bool DataReaderThread::fetchData(atools::fs::sc::SimConnectData& data, int radiusKm, Options fetchOptions)
 {
   if(verbose)
@@ -21,6 +21,7 @@
 #include "fs/sc/simconnectdata.h"
 #include "fs/sc/simconnectreply.h"
 
+#include <QElapsedTimer>
 #include <QMutex>
 #include <QThread>
 #include <QWaitCondition>
@@ -33,8 +34,37 @@ namespace sc {
 
 class ConnectHandler;
 
+/* Timing statistics for one periodic or on demand task of the DataReaderThread. Times in milliseconds. */
+struct DataReaderTaskStatistics
+{
+  /* Milliseconds since last successful run or -1 if never run */
+  qint64 getAgeMs() const
+  {
+    return lastUpdate.isValid() ? lastUpdate.msecsTo(QDateTime::currentDateTimeUtc()) : -1;
+  }
+
+  int numRuns = 0, numSkipped = 0; /* Skipped are runs which were missed since the task fell behind */
+  qint64 lastLatencyMs = 0, maxLatencyMs = 0; /* Duration of the fetch */
+  qint64 lastDriftMs = 0, maxDriftMs = 0; /* Delay of start against schedule */
+  float averageLatencyMs = 0.f; /* Moving average */
+  QDateTime lastUpdate; /* Time of last successful run in UTC */
+};
+
+/* Statistics for all tasks. Published by DataReaderThread::postStatistics() */
+struct DataReaderStatistics
+{
+  DataReaderTaskStatistics userAircraft, aiAircraft, weather;
+};
+
+QDebug operator<<(QDebug out, const atools::fs::sc::DataReaderTaskStatistics& stats);
+QDebug operator<<(QDebug out, const atools::fs::sc::DataReaderStatistics& stats);
+
 /* Actively reads flight simulator data using the simconnect interface in background and sends a
- * signal for each data package. */
+ * signal for each data package.
+ *
+ * Work is split into tasks with their own schedule: The user aircraft is fetched every update rate,
+ * AI aircraft and boats every AI update rate and weather on demand. AI aircraft from the last
+ * AI fetch are attached to packets in between. Latency and drift of each task are published by postStatistics(). */
 class DataReaderThread :
   public QThread
 {
@@ -64,6 +94,15 @@ public:
     updateRate = updateRateMs;
   }
 
+  /* Fetch AI aircraft and boats only every aiUpdateRateMs. Uses update rate if 0 or smaller than update rate. */
+  void setAiUpdateRate(unsigned int aiUpdateRateMs)
+  {
+    aiUpdateRate = aiUpdateRateMs;
+  }
+
+  /* Get a copy of the current timing statistics. Thread safe. */
+  atools::fs::sc::DataReaderStatistics getStatistics() const;
+
   /* If simulator connection is lost try to reconnect every reconnectSec seconds. */
   void setReconnectRateSec(int reconnectSec)
   {
@@ -159,12 +198,33 @@ signals:
   /* Emitted when disconnected manually or due to error */
   void disconnectedFromSimulator();
 
+  /* Sent every few seconds while connected to the simulator */
+  void postStatistics(atools::fs::sc::DataReaderStatistics statistics);
+
 private:
+  /* Schedule of a periodic task. Times are milliseconds of DataReaderThread::timer. */
+  struct ScheduledTask
+  {
+    qint64 nextDueMs = 0;
+    DataReaderTaskStatistics stats;
+  };
+
+  /* Update statistics after a run which started at startMs and schedule next run intervalMs later */
+  void finishTask(ScheduledTask& task, qint64 startMs, qint64 intervalMs, bool success);
+
+  /* Emit and log statistics */
+  void publishStatistics();
+
+  bool isWeatherRequested() const;
+
   void connectToSimulator();
   virtual void run() override;
   void setupReplay();
   bool fetchData(atools::fs::sc::SimConnectData& data, int radiusKm, atools::fs::sc::Options fetchOptions);
 
+  /* Fetch weather if requested or user aircraft and AI if due and update task statistics */
+  bool fetchScheduled(atools::fs::sc::SimConnectData& data, atools::fs::sc::Options fetchOptions);
+
   /* Updates whazzup.txt file in given folder during replay */
   void debugWriteWhazzup(const atools::fs::sc::SimConnectData& dataPacket);
 
@@ -192,10 +252,19 @@ private:
   quint32 replayUpdateRateMs = 500;
 
   bool terminate = false, verbose = false, failedTerminally = false;
-  unsigned int updateRate = 500;
+  unsigned int updateRate = 500, aiUpdateRate = 0;
   int reconnectRateSec = 10;
   bool connected = false, reconnecting = false;
 
+  /* Scheduling for live simulator data */
+  QElapsedTimer timer;
+  ScheduledTask userTask, aiTask, weatherTask;
+  qint64 nextStatisticsMs = 0;
+  QVector<atools::fs::sc::SimConnectAircraft> aiAircraftCache; /* AI from last AI fetch */
+
+  /* Protects statistics in tasks which are read from outside */
+  mutable QMutex statisticsMutex;
+
   /* Source for packet ids */
   int nextPacketId = 1;
 
@@ -211,4 +280,6 @@ private:
 } // namespace fs
 } // namespace atools
 
+Q_DECLARE_METATYPE(atools::fs::sc::DataReaderStatistics)
+
 #endif // LITTLENAVCONNECT_DATAREADERTHREAD_H
@@ -237,7 +237,7 @@ public:
 
   void fetchDisconnectedNavaidsResource(const QString& typeFilter);
 
-  void readNavaidsFromFile(QTextStream& stream, const QString& typeFilter);
+  void readNavaidsFromFile(const QByteArray& data, const QString& typeFilter);
 
   // Free all memory
   void clear();
@@ -1064,8 +1064,7 @@ ls -lh $APROJECTS/atools/resources/navdata/navaids24.csv.gz
     if(file.open(QIODevice::ReadOnly))
     {
       qDebug() << Q_FUNC_INFO << "Reading" << file.fileName();
-      QTextStream stream(atools::zip::gzipDecompress(file.readAll()), QIODevice::ReadOnly);
-      readNavaidsFromFile(stream, typeFilter);
+      readNavaidsFromFile(atools::zip::gzipDecompress(file.readAll()), typeFilter);
       file.close();
     }
     else
@@ -1076,8 +1075,7 @@ ls -lh $APROJECTS/atools/resources/navdata/navaids24.csv.gz
     if(fileExtra.open(QIODevice::ReadOnly))
     {
       qDebug() << Q_FUNC_INFO << "Reading" << fileExtra.fileName();
-      QTextStream stream(fileExtra.readAll(), QIODevice::ReadOnly);
-      readNavaidsFromFile(stream, typeFilter);
+      readNavaidsFromFile(fileExtra.readAll(), typeFilter);
       fileExtra.close();
     }
     else
@@ -1092,8 +1090,7 @@ ls -lh $APROJECTS/atools/resources/navdata/navaids24.csv.gz
       if(fileExtraUser.open(QIODevice::ReadOnly))
       {
         qDebug() << Q_FUNC_INFO << "Reading" << fileExtraUser.fileName();
-        QTextStream stream(fileExtraUser.readAll(), QIODevice::ReadOnly);
-        readNavaidsFromFile(stream, typeFilter);
+        readNavaidsFromFile(fileExtraUser.readAll(), typeFilter);
         fileExtraUser.close();
       }
       else
@@ -1102,13 +1099,13 @@ ls -lh $APROJECTS/atools/resources/navdata/navaids24.csv.gz
   }
 }
 
-void SimConnectLoaderPrivate::readNavaidsFromFile(QTextStream& stream, const QString& typeFilter)
+void SimConnectLoaderPrivate::readNavaidsFromFile(const QByteArray& data, const QString& typeFilter)
 {
   // CSV columns
   enum {IDENT, REGION, TYPE};
 
   atools::util::CsvFileReader csvReader;
-  csvReader.readCsvFile(stream);
+  csvReader.readCsvData(data);
 
   for(const QStringList& row : csvReader.getValues())
   {
@@ -1147,13 +1144,11 @@ ls -lh ~/.config/ABarthel/navaids.csv.gz
     QFile file(atools::settings::Settings::getPath() % atools::SEP % "navaids.csv.gz");
     if(file.open(QIODevice::ReadOnly))
     {
-      QTextStream stream(atools::zip::gzipDecompress(file.readAll()), QIODevice::ReadOnly);
-
       // CSV columns
       enum {IDENT};
 
       atools::util::CsvFileReader csvReader;
-      csvReader.readCsvFile(stream);
+      csvReader.readCsvData(atools::zip::gzipDecompress(file.readAll()));
 
       for(const QStringList& row : csvReader.getValues())
       {
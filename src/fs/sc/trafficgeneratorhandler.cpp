@@ -0,0 +1,244 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "fs/sc/trafficgeneratorhandler.h"
+
+#include "atools.h"
+#include "fs/sc/simconnectdata.h"
+#include "fs/sc/weatherrequest.h"
+#include "geo/calculations.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <cmath>
+
+namespace atools {
+namespace fs {
+namespace sc {
+
+/* Model, type, engine type, number of engines, wing span in ft, cruise speed in knots and cruise altitude in ft */
+struct TrafficModel
+{
+  const char *model, *type;
+  EngineType engineType;
+  quint8 numEngines;
+  quint16 wingSpanFt;
+  float speedKts, altitudeFt;
+};
+
+static const TrafficModel AIRCRAFT_MODELS[] = {
+  {"B738", "Boeing", JET, 2, 117, 450.f, 35000.f},
+  {"A320", "Airbus", JET, 2, 118, 450.f, 37000.f},
+  {"B77W", "Boeing", JET, 2, 212, 490.f, 39000.f},
+  {"DH8D", "De Havilland", TURBOPROP, 2, 93, 300.f, 25000.f},
+  {"C172", "Cessna", PISTON, 1, 36, 110.f, 5500.f},
+  {"BE58", "Beechcraft", PISTON, 2, 38, 190.f, 9500.f}
+};
+
+static const TrafficModel BOAT_MODELS[] = {
+  {"Ferry", "Ferry", NO_ENGINE, 0, 0, 20.f, 0.f},
+  {"Yacht", "Yacht", NO_ENGINE, 0, 0, 12.f, 0.f}
+};
+
+static const char *AIRLINES[] = {"Lufthansa", "United", "Delta", "Ryanair", "Air France"};
+
+/* Smaller radius is clamped to this value to allow vehicles to move */
+static const float MIN_RADIUS_NM = 1.f;
+
+/* Maximum number of destinations reached within one step */
+static const int MAX_DESTINATIONS_PER_STEP = 100;
+
+TrafficGeneratorHandler::TrafficGeneratorHandler(int numAircraft, const geo::Pos& centerParam, float radiusNm, quint32 seed)
+  : center(centerParam), radiusMeter(atools::geo::nmToMeter(std::max(radiusNm, MIN_RADIUS_NM))), random(seed)
+{
+  qDebug() << Q_FUNC_INFO << "numAircraft" << numAircraft << "center" << center << "radiusNm" << radiusNm << "seed" << seed;
+
+  if(radiusNm < MIN_RADIUS_NM)
+    qWarning() << Q_FUNC_INFO << "Radius" << radiusNm << "too small. Using" << MIN_RADIUS_NM;
+
+  initVehicle(user, 1, false);
+
+  vehicles.resize(numAircraft);
+  for(int i = 0; i < numAircraft; i++)
+    initVehicle(vehicles[i], static_cast<quint32>(i + 2), i % 10 == 9);
+}
+
+TrafficGeneratorHandler::~TrafficGeneratorHandler()
+{
+  qDebug() << Q_FUNC_INFO;
+}
+
+bool TrafficGeneratorHandler::connect()
+{
+  state = STATEOK;
+  timer.start();
+  simTimeMs = lastUpdateMs = 0;
+  return true;
+}
+
+bool TrafficGeneratorHandler::fetchData(SimConnectData& data, int radiusKm, Options options)
+{
+  if(state != STATEOK)
+    return false;
+
+  // Advance simulated time and move vehicles if due =======================
+  if(fixedTimeStepMs > 0)
+    simTimeMs += fixedTimeStepMs;
+  else
+    simTimeMs = timer.elapsed();
+
+  qint64 elapsedMs = simTimeMs - lastUpdateMs;
+  if(elapsedMs > 0 && elapsedMs >= aircraftUpdateRateMs)
+  {
+    float seconds = static_cast<float>(elapsedMs) / 1000.f;
+    lastUserPos = user.aircraft.position;
+    moveVehicle(user, seconds);
+    for(Vehicle& vehicle : vehicles)
+      moveVehicle(vehicle, seconds);
+    lastUpdateMs = simTimeMs;
+  }
+
+  // User aircraft =======================
+  const SimConnectAircraft& ac = user.aircraft;
+  data = SimConnectData::buildDebugMovingAircraft(ac.position, lastUserPos, false /* ground */, 0.f /* vertSpeed */,
+                                                  ac.trueAirspeedKts, 800.f /* fuelflow */, 10000.f /* totalFuel */,
+                                                  0.f /* ice */, ac.position.getAltitude(), 0.f /* magVar */,
+                                                  ac.engineType != PISTON /* jetFuel */, false /* helicopter */);
+
+  // AI aircraft and boats =======================
+  float maxDistanceMeter = radiusKm > 0 ? static_cast<float>(radiusKm) * 1000.f : 0.f;
+  QVector<SimConnectAircraft>& aiAircraft = data.getAiAircraft();
+  aiAircraft.reserve(vehicles.size());
+  for(const Vehicle& vehicle : qAsConst(vehicles))
+  {
+    bool boat = vehicle.aircraft.isAnyBoat();
+    if((boat && !options.testFlag(FETCH_AI_BOAT)) || (!boat && !options.testFlag(FETCH_AI_AIRCRAFT)))
+      continue;
+
+    if(maxDistanceMeter > 0.f && vehicle.aircraft.position.distanceMeterTo(ac.position) > maxDistanceMeter)
+      continue;
+
+    aiAircraft.append(vehicle.aircraft);
+  }
+
+  return true;
+}
+
+bool TrafficGeneratorHandler::fetchWeatherData(SimConnectData& data)
+{
+  Q_UNUSED(data)
+  return false;
+}
+
+void TrafficGeneratorHandler::addWeatherRequest(const WeatherRequest& request)
+{
+  Q_UNUSED(request)
+}
+
+const WeatherRequest& TrafficGeneratorHandler::getWeatherRequest() const
+{
+  static atools::fs::sc::WeatherRequest dummy;
+  return dummy;
+}
+
+QString TrafficGeneratorHandler::getName() const
+{
+  return QLatin1String("TrafficGenerator");
+}
+
+atools::geo::Pos TrafficGeneratorHandler::randomPos(float altitudeFt)
+{
+  // Square root gives uniform distribution over the circle area
+  float distance = static_cast<float>(std::sqrt(random.generateDouble())) * radiusMeter;
+  float angle = static_cast<float>(random.bounded(360.));
+  atools::geo::Pos pos = center.endpoint(distance, angle);
+  pos.setAltitude(altitudeFt);
+  return pos;
+}
+
+void TrafficGeneratorHandler::initVehicle(Vehicle& vehicle, quint32 objectId, bool boat)
+{
+  const TrafficModel& model = boat ?
+                              BOAT_MODELS[random.bounded(static_cast<int>(sizeof(BOAT_MODELS) / sizeof(BOAT_MODELS[0])))] :
+                              AIRCRAFT_MODELS[random.bounded(static_cast<int>(sizeof(AIRCRAFT_MODELS) / sizeof(AIRCRAFT_MODELS[0])))];
+
+  SimConnectAircraft& ac = vehicle.aircraft;
+  ac.objectId = objectId;
+  ac.category = boat ? BOAT : AIRPLANE;
+  ac.engineType = model.engineType;
+  ac.numberOfEngines = model.numEngines;
+  ac.wingSpanFt = model.wingSpanFt;
+  ac.modelRadiusFt = static_cast<quint16>(model.wingSpanFt / 2);
+  ac.airplaneModel = model.model;
+  ac.airplaneType = model.type;
+  ac.airplaneTitle = QString("%1 %2").arg(model.type).arg(model.model);
+
+  if(!boat)
+  {
+    ac.airplaneAirline = AIRLINES[random.bounded(static_cast<int>(sizeof(AIRLINES) / sizeof(AIRLINES[0])))];
+    ac.airplaneFlightnumber = QString::number(random.bounded(1, 10000));
+    ac.transponderCode = static_cast<qint16>(random.bounded(0, 4096));
+  }
+
+  // Unique registration derived from id - "N" and five digits
+  ac.airplaneReg = QString("N%1").arg(objectId, 5, 10, QChar('0'));
+  ac.updateAirplaneRegistrationKey();
+
+  // Vary speed and altitude by +/- 10 percent
+  float factor = 0.9f + static_cast<float>(random.bounded(0.2));
+  ac.trueAirspeedKts = ac.groundSpeedKts = model.speedKts * factor;
+  ac.indicatedSpeedKts = ac.trueAirspeedKts * 0.7f;
+  ac.position = randomPos(atools::roundToInt(model.altitudeFt * factor / 500.f) * 500.f);
+  ac.indicatedAltitudeFt = ac.position.getAltitude();
+  ac.flags = boat ? ON_GROUND : NONE;
+
+  vehicle.destination = randomPos(ac.position.getAltitude());
+  ac.headingTrueDeg = ac.headingMagDeg = ac.position.angleDegTo(vehicle.destination);
+}
+
+void TrafficGeneratorHandler::moveVehicle(Vehicle& vehicle, float seconds)
+{
+  SimConnectAircraft& ac = vehicle.aircraft;
+  float distance = atools::geo::knotsToMeterPerSec(ac.groundSpeedKts) * seconds;
+
+  // Pick new destinations until distance to travel is shorter than the remaining track
+  float remaining = ac.position.distanceMeterTo(vehicle.destination);
+  int numDestinations = 0;
+  while(remaining <= distance)
+  {
+    ac.position = vehicle.destination;
+    distance -= remaining;
+    vehicle.destination = randomPos(ac.position.getAltitude());
+    remaining = ac.position.distanceMeterTo(vehicle.destination);
+
+    // Stay at destination if no different one can be found
+    if(!(remaining > 0.f) || ++numDestinations >= MAX_DESTINATIONS_PER_STEP)
+      return;
+  }
+
+  // Follow great circle by recalculating the initial course for each step
+  float course = ac.position.angleDegTo(vehicle.destination);
+  float altitude = ac.position.getAltitude();
+  ac.position = ac.position.endpoint(distance, course);
+  ac.position.setAltitude(altitude);
+  ac.headingTrueDeg = ac.headingMagDeg = atools::geo::normalizeCourse(course);
+}
+
+} // namespace sc
+} // namespace fs
+} // namespace atools
@@ -0,0 +1,145 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef ATOOLS_FS_TRAFFICGENERATORHANDLER_H
+#define ATOOLS_FS_TRAFFICGENERATORHANDLER_H
+
+#include "fs/sc/connecthandler.h"
+#include "fs/sc/simconnectaircraft.h"
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QVector>
+
+namespace atools {
+namespace fs {
+namespace sc {
+
+/*
+ * Connect handler generating synthetic traffic for load tests and profiling without a simulator.
+ *
+ * Moves a user aircraft and a configurable number of AI aircraft and boats along great circle tracks
+ * between random points around a center position. A new destination is picked when one is reached.
+ * Uses a seeded random generator so the same parameters always result in the same traffic.
+ */
+class TrafficGeneratorHandler :
+  public atools::fs::sc::ConnectHandler
+{
+public:
+  /*
+   * @param numAircraft Number of AI vehicles. Every tenth one is a boat.
+   * @param center Center of the area for random start and destination points
+   * @param radiusNm Radius of the area. Clamped to a minimum of one nautical mile.
+   * @param seed Seed for random generator
+   */
+  TrafficGeneratorHandler(int numAircraft, const atools::geo::Pos& center, float radiusNm = 300.f, quint32 seed = 1);
+  virtual ~TrafficGeneratorHandler() override;
+
+  TrafficGeneratorHandler(const TrafficGeneratorHandler& other) = delete;
+  TrafficGeneratorHandler& operator=(const TrafficGeneratorHandler& other) = delete;
+
+  /* Move vehicles only every intervalMs of simulated time like simulators updating AI at a lower rate.
+   * Vehicles are moved on each fetch if 0. */
+  void setAircraftUpdateRate(int intervalMs)
+  {
+    aircraftUpdateRateMs = intervalMs;
+  }
+
+  /* Advance simulated time by stepMs on each fetch instead of using real time.
+   * Makes the generated data independent of timing. Uses real time if 0. */
+  void setFixedTimeStep(int stepMs)
+  {
+    fixedTimeStepMs = stepMs;
+  }
+
+  /* Always succeeds */
+  virtual bool connect() override;
+
+  virtual bool isLoaded() const override
+  {
+    return true;
+  }
+
+  /* Move vehicles and copy them into data. Honors radiusKm around user aircraft if > 0 and AI options. */
+  virtual bool fetchData(atools::fs::sc::SimConnectData& data, int radiusKm, atools::fs::sc::Options options) override;
+
+  /* Weather is not supported */
+  virtual bool fetchWeatherData(atools::fs::sc::SimConnectData& data) override;
+  virtual void addWeatherRequest(const atools::fs::sc::WeatherRequest& request) override;
+  virtual const atools::fs::sc::WeatherRequest& getWeatherRequest() const override;
+
+  virtual bool isSimRunning() const override
+  {
+    return state == STATEOK;
+  }
+
+  virtual bool isSimPaused() const override
+  {
+    return false;
+  }
+
+  virtual bool canFetchWeather() const override
+  {
+    return false;
+  }
+
+  virtual atools::fs::sc::State getState() const override
+  {
+    return state;
+  }
+
+  virtual QString getName() const override;
+
+  int getNumAircraft() const
+  {
+    return vehicles.size();
+  }
+
+private:
+  struct Vehicle
+  {
+    atools::fs::sc::SimConnectAircraft aircraft;
+    atools::geo::Pos destination;
+  };
+
+  /* Random position in area with given altitude */
+  atools::geo::Pos randomPos(float altitudeFt);
+
+  /* Set random type, registration, speed, start and destination */
+  void initVehicle(Vehicle& vehicle, quint32 objectId, bool boat);
+
+  /* Move vehicle along great circle to destination and pick a new one if reached */
+  void moveVehicle(Vehicle& vehicle, float seconds);
+
+  QVector<Vehicle> vehicles;
+  Vehicle user;
+  atools::geo::Pos lastUserPos, center;
+  float radiusMeter;
+
+  QRandomGenerator random;
+  QElapsedTimer timer;
+  qint64 simTimeMs = 0, lastUpdateMs = 0;
+  int aircraftUpdateRateMs = 0, fixedTimeStepMs = 0;
+
+  atools::fs::sc::State state = DISCONNECTED;
+};
+
+} // namespace sc
+} // namespace fs
+} // namespace atools
+
+#endif // ATOOLS_FS_TRAFFICGENERATORHANDLER_H
@@ -24,6 +24,8 @@
 #include <QBuffer>
 #include <QDataStream>
 
+#include <atomic>
+
 namespace atools {
 namespace fs {
 namespace sc {
@@ -67,7 +69,6 @@ bool XpConnectHandler::connect()
 bool XpConnectHandler::fetchData(fs::sc::SimConnectData& data, int radiusKm, fs::sc::Options options)
 {
   Q_UNUSED(radiusKm)
-  Q_UNUSED(options)
 
   if(!sharedMemory.isAttached())
   {
@@ -75,6 +76,91 @@ bool XpConnectHandler::fetchData(fs::sc::SimConnectData& data, int radiusKm, fs:
     return false;
   }
 
+  // Check for header of the lock free protocol on each call since the writer might not have initialized it yet
+  const XpSharedMemoryHeader *header = static_cast<const XpSharedMemoryHeader *>(sharedMemory.constData());
+  bool buffered = sharedMemory.size() >= static_cast<int>(sizeof(XpSharedMemoryHeader)) && header->legacySize == 0 &&
+                  header->magicNumber == XP_SHARED_MEMORY_MAGIC_NUMBER;
+
+  if(buffered ? fetchDataBuffered(data) : fetchDataLocked(data))
+  {
+    if(data.isUserAircraftValid() && data.getStatus() == OK)
+    {
+      if(!(options & atools::fs::sc::FETCH_AI_AIRCRAFT))
+        // Have to clear this here since the X-Plane plugin has no configuration option
+        data.clearAiAircraft();
+
+      return true;
+    }
+  }
+  return false;
+}
+
+bool XpConnectHandler::fetchDataBuffered(SimConnectData& data)
+{
+  const XpSharedMemoryHeader *header = static_cast<const XpSharedMemoryHeader *>(sharedMemory.constData());
+
+  if(header->flags.loadAcquire() & (XP_SHARED_MEMORY_TERMINATE | XP_SHARED_MEMORY_RESIZED))
+  {
+    // Writer is gone or moved to a larger segment - reconnect attaches to the new one
+    disconnect();
+    return false;
+  }
+
+  if(header->version != XP_SHARED_MEMORY_VERSION)
+  {
+    if(!versionWarningShown)
+      qWarning() << Q_FUNC_INFO << "Shared memory version mismatch" << header->version << "!=" << XP_SHARED_MEMORY_VERSION;
+    versionWarningShown = true;
+    return false;
+  }
+
+  quint32 numBuffers = header->numBuffers, bufferSize = header->bufferSize, headerSize = header->headerSize;
+  if(numBuffers == 0 || numBuffers > XP_SHARED_MEMORY_NUM_BUFFERS || headerSize < sizeof(XpSharedMemoryHeader) ||
+     static_cast<qint64>(headerSize) + static_cast<qint64>(numBuffers) * bufferSize > sharedMemory.size())
+  {
+    qWarning() << Q_FUNC_INFO << "Invalid header" << numBuffers << bufferSize << headerSize << sharedMemory.size();
+    return false;
+  }
+
+  // Retry if the writer overwrote the buffer while deserializing
+  for(int retry = 0; retry < 10; retry++)
+  {
+    quint32 index = header->latest.loadAcquire();
+    if(index >= numBuffers)
+      // Nothing written yet
+      return false;
+
+    const XpSharedMemoryBuffer& buf = header->buffers[index];
+    quint32 sequence = buf.sequence.loadAcquire();
+    quint32 size = buf.size.loadAcquire();
+    if(sequence & 1 || size > bufferSize)
+      // Writer is busy
+      continue;
+
+    // Deserialize directly from mapped memory without copying
+    const char *source = static_cast<const char *>(sharedMemory.constData()) + headerSize + index * bufferSize;
+    QByteArray bytes = QByteArray::fromRawData(source, static_cast<int>(size));
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::ReadOnly);
+
+    SimConnectData readData;
+    bool result = readData.read(&buffer);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if(buf.sequence.loadAcquire() == sequence)
+    {
+      // Buffer was not touched by writer - result is consistent
+      data = readData;
+      return result;
+    }
+  }
+
+  qDebug() << Q_FUNC_INFO << "Too many retries";
+  return false;
+}
+
+bool XpConnectHandler::fetchDataLocked(SimConnectData& data)
+{
   if(sharedMemory.lock())
   {
     quint32 size;
@@ -83,7 +169,7 @@ bool XpConnectHandler::fetchData(fs::sc::SimConnectData& data, int radiusKm, fs:
     QDataStream stream(QByteArray(static_cast<const char *>(sharedMemory.data()), prefixSize));
     stream >> size;
 
-    if(size > static_cast<quint32>(prefixSize))
+    if(size > static_cast<quint32>(prefixSize) && size <= static_cast<quint32>(sharedMemory.size()))
     {
       stream >> terminate;
 
@@ -100,15 +186,7 @@ bool XpConnectHandler::fetchData(fs::sc::SimConnectData& data, int radiusKm, fs:
         disconnect();
         return false;
       }
-
-      if(data.isUserAircraftValid() && data.getStatus() == OK)
-      {
-        if(!(options & atools::fs::sc::FETCH_AI_AIRCRAFT))
-          // Have to clear this here since the X-Plane plugin has no configuration option
-          data.clearAiAircraft();
-
-        return true;
-      }
+      return true;
     }
     else
       sharedMemory.unlock();
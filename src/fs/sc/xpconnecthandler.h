@@ -19,19 +19,17 @@
 #define ATOOLS_XPCONNECTHANDLER_H
 
 #include "fs/sc/connecthandler.h"
-
-#include <QSharedMemory>
+#include "fs/sc/xpsharedmemory.h"
 
 namespace atools {
 namespace fs {
 namespace sc {
 
-/* Defaul size of the shared memory segment */
-static const int SHARED_MEMORY_SIZE = 8196;
-static const QLatin1String SHARED_MEMORY_KEY("LittleXpconnect");
-
 /*
- * Reads data from a callback function into SimConnectData.
+ * Reads data from the shared memory segment written by the X-Plane plugin into SimConnectData.
+ *
+ * Uses the lock free protocol described in XpSharedMemoryHeader if the segment has a valid header.
+ * Falls back to the old protocol locking the segment otherwise.
  */
 class XpConnectHandler :
   public atools::fs::sc::ConnectHandler
@@ -79,7 +77,14 @@ public:
 private:
   void disconnect();
 
+  /* Lock free read from the buffers described in XpSharedMemoryHeader */
+  bool fetchDataBuffered(SimConnectData& data);
+
+  /* Old protocol using a segment locked by the writer with size and terminate prefix */
+  bool fetchDataLocked(SimConnectData& data);
+
   QSharedMemory sharedMemory;
+  bool versionWarningShown = false;
   atools::fs::sc::State state = DISCONNECTED;
 
 };
@@ -0,0 +1,175 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "fs/sc/xpsharedmemory.h"
+
+#include "fs/sc/simconnectdata.h"
+
+#include <QDebug>
+
+#include <atomic>
+#include <cstring>
+
+namespace atools {
+namespace fs {
+namespace sc {
+
+/* Align header size to cache line */
+static const int HEADER_SIZE = (sizeof(XpSharedMemoryHeader) + 63) / 64 * 64;
+
+XpSharedMemoryWriter::XpSharedMemoryWriter(const QString& key)
+{
+  sharedMemory.setKey(key);
+}
+
+XpSharedMemoryWriter::~XpSharedMemoryWriter()
+{
+  terminate();
+}
+
+bool XpSharedMemoryWriter::write(SimConnectData& data)
+{
+  // Serialize into reused block =====================
+  QBuffer buffer(&block);
+  buffer.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  data.write(&buffer);
+  buffer.close();
+
+  if(data.getStatus() != OK)
+    return false;
+
+  int size = block.size();
+  if(sharedMemory.isAttached() && size > getBufferSize())
+    // Tell readers to reattach and create a larger segment
+    detach(XP_SHARED_MEMORY_RESIZED);
+
+  if(!sharedMemory.isAttached() && !create(size))
+    return false;
+
+  XpSharedMemoryHeader *hdr = header();
+  quint32 latest = hdr->latest.loadAcquire();
+  quint32 next = latest == XP_SHARED_MEMORY_NO_BUFFER ? 0 : (latest + 1) % hdr->numBuffers;
+  XpSharedMemoryBuffer& buf = hdr->buffers[next];
+
+  // Mark buffer as being written by odd sequence number =====================
+  quint32 sequence = buf.sequence.loadAcquire();
+  buf.sequence.storeRelease(sequence + 1);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  char *dest = static_cast<char *>(sharedMemory.data()) + hdr->headerSize + next * hdr->bufferSize;
+  std::memcpy(dest, block.constData(), static_cast<size_t>(size));
+  buf.size.storeRelease(static_cast<quint32>(size));
+
+  // Publish =====================
+  buf.sequence.storeRelease(sequence + 2);
+  hdr->latest.storeRelease(next);
+  return true;
+}
+
+void XpSharedMemoryWriter::terminate()
+{
+  detach(XP_SHARED_MEMORY_TERMINATE);
+}
+
+int XpSharedMemoryWriter::getBufferSize() const
+{
+  if(sharedMemory.isAttached())
+    return static_cast<int>(static_cast<const XpSharedMemoryHeader *>(sharedMemory.constData())->bufferSize);
+  else
+    return 0;
+}
+
+bool XpSharedMemoryWriter::create(int minBufferSize)
+{
+  // Leave room for growth to avoid frequent resizing
+  int bufferSize = XP_SHARED_MEMORY_MIN_BUFFER_SIZE;
+  while(bufferSize < minBufferSize + minBufferSize / 2)
+    bufferSize *= 2;
+
+  int totalSize = HEADER_SIZE + XP_SHARED_MEMORY_NUM_BUFFERS * bufferSize;
+
+  if(!sharedMemory.create(totalSize, QSharedMemory::ReadWrite))
+  {
+    if(sharedMemory.error() == QSharedMemory::AlreadyExists)
+    {
+      // Left over by a crashed writer or still held by readers of the former segment - reuse if large enough
+      if(!sharedMemory.attach(QSharedMemory::ReadWrite))
+      {
+        qWarning() << Q_FUNC_INFO << "Cannot attach" << sharedMemory.errorString() << sharedMemory.error();
+        return false;
+      }
+
+      if(sharedMemory.size() < totalSize)
+      {
+        qInfo() << Q_FUNC_INFO << "Existing segment too small" << sharedMemory.size() << "need" << totalSize;
+        sharedMemory.detach();
+        return false;
+      }
+      bufferSize = (sharedMemory.size() - HEADER_SIZE) / XP_SHARED_MEMORY_NUM_BUFFERS;
+    }
+    else
+    {
+      qWarning() << Q_FUNC_INFO << "Cannot create" << sharedMemory.errorString() << sharedMemory.error();
+      return false;
+    }
+  }
+
+  qInfo() << Q_FUNC_INFO << "Attached to" << sharedMemory.key() << "native" << sharedMemory.nativeKey()
+          << "size" << sharedMemory.size() << "buffer size" << bufferSize;
+
+  // Initialize header - readers check the magic number last =====================
+  XpSharedMemoryHeader *hdr = header();
+  hdr->magicNumber = 0;
+  std::atomic_thread_fence(std::memory_order_release);
+
+  hdr->legacySize = 0;
+  hdr->version = XP_SHARED_MEMORY_VERSION;
+  hdr->headerSize = HEADER_SIZE;
+  hdr->numBuffers = XP_SHARED_MEMORY_NUM_BUFFERS;
+  hdr->bufferSize = static_cast<quint32>(bufferSize);
+  hdr->latest.storeRelease(XP_SHARED_MEMORY_NO_BUFFER);
+  hdr->flags.storeRelease(0);
+  for(XpSharedMemoryBuffer& buf : hdr->buffers)
+  {
+    // Keep sequences if segment was reused to let readers detect changes
+    buf.sequence.storeRelease(buf.sequence.loadAcquire() & ~1u);
+    buf.size.storeRelease(0);
+  }
+
+  std::atomic_thread_fence(std::memory_order_release);
+  hdr->magicNumber = XP_SHARED_MEMORY_MAGIC_NUMBER;
+  return true;
+}
+
+void XpSharedMemoryWriter::detach(quint32 flags)
+{
+  if(sharedMemory.isAttached())
+  {
+    header()->flags.fetchAndOrRelease(flags);
+    bool result = sharedMemory.detach();
+    qDebug() << Q_FUNC_INFO << "flags" << flags << "result" << result;
+  }
+}
+
+XpSharedMemoryHeader *XpSharedMemoryWriter::header()
+{
+  return static_cast<XpSharedMemoryHeader *>(sharedMemory.data());
+}
+
+} // namespace sc
+} // namespace fs
+} // namespace atools
@@ -0,0 +1,131 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef ATOOLS_XPSHAREDMEMORY_H
+#define ATOOLS_XPSHAREDMEMORY_H
+
+#include <QAtomicInteger>
+#include <QSharedMemory>
+
+namespace atools {
+namespace fs {
+namespace sc {
+
+class SimConnectData;
+
+/* Size of the shared memory segment used by the old locking protocol */
+static const int SHARED_MEMORY_SIZE = 8196;
+static const QLatin1String SHARED_MEMORY_KEY("LittleXpconnect");
+
+/* Number of buffers in the segment. Three allow the writer to fill one buffer while the reader
+ * copies from another without touching the same memory in most cases. */
+static const int XP_SHARED_MEMORY_NUM_BUFFERS = 3;
+
+/* Minimum size of a buffer. Grows if the serialized data does not fit. */
+static const int XP_SHARED_MEMORY_MIN_BUFFER_SIZE = 32 * 1024;
+
+static const quint32 XP_SHARED_MEMORY_MAGIC_NUMBER = 0x5C2E91B4;
+static const quint32 XP_SHARED_MEMORY_VERSION = 1;
+
+/* Bits for XpSharedMemoryHeader::flags */
+static const quint32 XP_SHARED_MEMORY_TERMINATE = 1 << 0; /* Writer is shutting down */
+static const quint32 XP_SHARED_MEMORY_RESIZED = 1 << 1; /* Writer replaces segment with a larger one. Reattach. */
+
+/* Index in XpSharedMemoryHeader::latest if nothing was written yet */
+static const quint32 XP_SHARED_MEMORY_NO_BUFFER = 0xffffffff;
+
+/* Sequence counter and size of one buffer. Sequence is odd while the writer fills the buffer. */
+struct XpSharedMemoryBuffer
+{
+  QAtomicInteger<quint32> sequence;
+  QAtomicInteger<quint32> size;
+};
+
+/*
+ * Header at the start of the shared memory segment followed by numBuffers buffers of bufferSize bytes.
+ * Uses native byte order since both sides run on the same machine.
+ *
+ * Lock free protocol for one writer and any number of readers:
+ * Writer increments the sequence of the buffer after the latest to an odd number, copies data, sets size,
+ * increments the sequence to an even number and publishes the index in latest.
+ * Reader takes the latest index, notes an even sequence, deserializes directly from the mapped memory and
+ * checks afterwards if the sequence is still the same. Reads are retried otherwise.
+ */
+struct XpSharedMemoryHeader
+{
+  /* Always 0. Occupies the size field of the old locking protocol which lets old readers ignore the segment. */
+  quint32 legacySize;
+  quint32 magicNumber, version, headerSize, numBuffers, bufferSize;
+
+  QAtomicInteger<quint32> latest; /* Index of the last completely written buffer */
+  QAtomicInteger<quint32> flags; /* XP_SHARED_MEMORY_TERMINATE and XP_SHARED_MEMORY_RESIZED */
+  XpSharedMemoryBuffer buffers[XP_SHARED_MEMORY_NUM_BUFFERS];
+};
+
+/*
+ * Writer side of the shared memory protocol. Used by the X-Plane plugin or by any local process
+ * which wants to feed aircraft data to XpConnectHandler.
+ *
+ * Creates the segment on the first write and replaces it with a larger one if data does not fit.
+ * Not thread safe. Use from one thread only.
+ */
+class XpSharedMemoryWriter
+{
+public:
+  explicit XpSharedMemoryWriter(const QString& key = SHARED_MEMORY_KEY);
+  ~XpSharedMemoryWriter();
+
+  XpSharedMemoryWriter(const XpSharedMemoryWriter& other) = delete;
+  XpSharedMemoryWriter& operator=(const XpSharedMemoryWriter& other) = delete;
+
+  /* Serialize and publish data. Returns false if the segment cannot be created. Write is retried on next call. */
+  bool write(atools::fs::sc::SimConnectData& data);
+
+  /* Tell readers to detach and detach from segment */
+  void terminate();
+
+  bool isAttached() const
+  {
+    return sharedMemory.isAttached();
+  }
+
+  QString getErrorString() const
+  {
+    return sharedMemory.errorString();
+  }
+
+  /* Size of each buffer in bytes or 0 if not created */
+  int getBufferSize() const;
+
+private:
+  /* Create segment with buffers large enough for minBufferSize bytes */
+  bool create(int minBufferSize);
+
+  /* Set flags and detach */
+  void detach(quint32 flags);
+
+  XpSharedMemoryHeader *header();
+
+  QSharedMemory sharedMemory;
+  QByteArray block; /* Serialized data - reused to avoid allocations */
+};
+
+} // namespace sc
+} // namespace fs
+} // namespace atools
+
+#endif // ATOOLS_XPSHAREDMEMORY_H
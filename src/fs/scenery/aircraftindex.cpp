@@ -20,11 +20,14 @@
 #include "atools.h"
 #include "fs/scenery/manifestjson.h"
 #include "fs/scenery/layoutjson.h"
+#include "fs/scenery/packagecache.h"
 #include "fs/util/fsutil.h"
+#include "util/parallel.h"
 
 #include <QDir>
 #include <QTextStream>
 #include <QStringBuilder>
+#include <QVector>
 #include <QDebug>
 
 namespace atools {
@@ -34,6 +37,12 @@ namespace scenery {
 AircraftIndex::AircraftIndex(bool verboseParm) :
   verbose(verboseParm)
 {
+  packageCache = new PackageCache;
+}
+
+AircraftIndex::~AircraftIndex()
+{
+  ATOOLS_DELETE_LOG(packageCache);
 }
 
 void AircraftIndex::loadIndex(const QStringList& basePaths)
@@ -45,40 +54,57 @@ void AircraftIndex::loadIndex(const QStringList& basePaths)
 
     qDebug() << Q_FUNC_INFO << "Loading from" << basePaths << "...";
 
-    for(const QString& path : basePaths)
+    if(!cacheFileLoaded && !cacheFile.isEmpty())
     {
+      packageCache->loadFile(cacheFile);
+      cacheFileLoaded = true;
+    }
+
+    // Collect all add-on folders first
+    QFileInfoList addonDirs;
+    for(const QString& path : basePaths)
       // dir = .../Microsoft.FlightSimulator_8wekyb3d8bbwe/LocalCache/Packages/Official/OneStore
-      QDir dir(path);
-      const QFileInfoList entries = dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
-      for(const QFileInfo& addonDir : entries)
-      {
-        // addonDir = .../Microsoft.FlightSimulator_8wekyb3d8bbwe/LocalCache/Packages/Official/OneStore/asobo-aircraft-208b-grand-caravan-ex
+      addonDirs.append(QDir(path).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot));
 
-        // Read manifest and check for aircraft
-        ManifestJson manifest;
-        manifest.read(addonDir.filePath() + QDir::separator() + "manifest.json");
-        if(manifest.isValid() && manifest.isAircraft())
-        {
-          // Find aircraft.cfg relative location in manifest
-          LayoutJson layout;
-          layout.read(addonDir.filePath() + QDir::separator() + "layout.json");
-          if(layout.isValid())
+    // Read manifest and layout files in parallel - mostly cache hits after first run =============
+    QVector<LayoutJson> layouts(addonDirs.size());
+    atools::util::parallelFor(addonDirs.size(), [&addonDirs, &layouts, this](int begin, int end) -> void {
+          for(int i = begin; i < end; i++)
           {
-            // There may be more than one aircraft.cfg, e.g. for wheeled and floats
-            for(QString layoutPath : layout.getAircraftCfgPaths())
-            {
-              // This is the hashmap key returned by SimConnect_RequestSystemState(EVENT_AIRCRAFT_LOADED, ...)
-              // SimObjects/Airplanes/Asobo_208B_GRAND_CARAVAN_EX/aircraft.cfg
-              QString cfgPathKey = layoutPath.replace('\\', '/').toLower(); // Clean path needs an existing path
-              QFileInfo fullCfgPathValue(addonDir.filePath() + QDir::separator() + layoutPath);
-
-              if(fullCfgPathValue.exists() && fullCfgPathValue.isFile())
-                aircraftShortToFullPathMap.insert(cfgPathKey.toLower(), atools::cleanPath(fullCfgPathValue.canonicalFilePath()));
-            }
+            // addonDir = .../Microsoft.FlightSimulator_8wekyb3d8bbwe/LocalCache/Packages/Official/OneStore/asobo-aircraft-208b-grand-caravan-ex
+            const QString addonPath = addonDirs.at(i).filePath();
+
+            // Read manifest and check for aircraft
+            ManifestJson manifest = packageCache->getManifest(addonPath + QDir::separator() + "manifest.json");
+            if(manifest.isValid() && manifest.isAircraft())
+              // Find aircraft.cfg relative location in manifest
+              layouts[i] = packageCache->getLayout(addonPath + QDir::separator() + "layout.json");
           }
+        }, 16);
+
+    // Fill index in original order =============
+    for(int i = 0; i < addonDirs.size(); i++)
+    {
+      const LayoutJson& layout = layouts.at(i);
+      if(layout.isValid())
+      {
+        // There may be more than one aircraft.cfg, e.g. for wheeled and floats
+        for(QString layoutPath : layout.getAircraftCfgPaths())
+        {
+          // This is the hashmap key returned by SimConnect_RequestSystemState(EVENT_AIRCRAFT_LOADED, ...)
+          // SimObjects/Airplanes/Asobo_208B_GRAND_CARAVAN_EX/aircraft.cfg
+          QString cfgPathKey = layoutPath.replace('\\', '/').toLower(); // Clean path needs an existing path
+          QFileInfo fullCfgPathValue(addonDirs.at(i).filePath() + QDir::separator() + layoutPath);
+
+          if(fullCfgPathValue.exists() && fullCfgPathValue.isFile())
+            aircraftShortToFullPathMap.insert(cfgPathKey.toLower(), atools::cleanPath(fullCfgPathValue.canonicalFilePath()));
         }
       }
     }
+
+    if(!cacheFile.isEmpty())
+      packageCache->saveFile(cacheFile);
+
     qDebug() << Q_FUNC_INFO << "loading done.";
 
     if(verbose)
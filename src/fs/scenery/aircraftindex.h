@@ -26,6 +26,7 @@ namespace fs {
 namespace scenery {
 
 struct AircraftProperties;
+class PackageCache;
 
 /* .../Microsoft.FlightSimulator_8wekyb3d8bbwe/LocalCache/Packages/Official/OneStore/asobo-aircraft-208b-grand-caravan-ex/
  * .../Microsoft.FlightSimulator_8wekyb3d8bbwe/LocalCache/Packages/Community
@@ -52,13 +53,24 @@ class AircraftIndex
 {
 public:
   explicit AircraftIndex(bool verboseParm);
+  ~AircraftIndex();
+
+  AircraftIndex(const AircraftIndex& other) = delete;
+  AircraftIndex& operator=(const AircraftIndex& other) = delete;
+
+  /* Binary file used to keep parsed manifest.json and layout.json files between sessions.
+   * Loaded on first call of loadIndex() and saved after each loadIndex() if changed. Nothing is saved if empty. */
+  void setCacheFile(const QString& filename)
+  {
+    cacheFile = filename;
+  }
 
   /* Load manifest and layout JSON and look for type AIRCRAFT in manifest and aircraft.cfg location in layout.
    * Store aircraft.cfg location in index but do not read aircraft.cfg.
    * layout.json "path": "SimObjects/Airplanes/Asobo_B787_10/aircraft.cfg",
    * manifest.json   "content_type": "AIRCRAFT",
    *
-   * Only for user aircraft.
+   * Only for user aircraft. Manifest and layout files are read in parallel and taken from the cache if unchanged.
    */
   void loadIndex(const QStringList& paths);
 
@@ -98,6 +110,11 @@ private:
   /* Used by load index to avoid unneeded reload */
   QStringList loadedBasePaths;
 
+  /* Parsed manifest and layout files */
+  PackageCache *packageCache;
+  QString cacheFile;
+  bool cacheFileLoaded = false;
+
   bool verbose = false;
 
 };
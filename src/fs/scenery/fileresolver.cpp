@@ -19,7 +19,9 @@
 #include "fs/navdatabaseoptions.h"
 #include "fs/scenery/fileresolver.h"
 #include "fs/scenery/layoutjson.h"
+#include "fs/scenery/packagecache.h"
 #include "fs/scenery/sceneryarea.h"
+#include "util/parallel.h"
 
 #include <QtDebug>
 #include <QFile>
@@ -30,8 +32,8 @@ namespace atools {
 namespace fs {
 namespace scenery {
 
-FileResolver::FileResolver(const NavDatabaseOptions& opts, bool noWarnings)
-  : options(opts), quiet(noWarnings)
+FileResolver::FileResolver(const NavDatabaseOptions& opts, bool noWarnings, PackageCache *cache)
+  : options(opts), packageCache(cache), quiet(noWarnings)
 {
 }
 
@@ -116,8 +118,12 @@ int FileResolver::getFiles(const SceneryArea& area, QStringList *filepaths, QStr
             if(options.getSimulatorType() == atools::fs::FsPaths::MSFS)
             {
               // Read MSFS layout file and add all BGL files ================
+              QString layoutFile = scenery.absoluteFilePath() + SEP + "layout.json";
               layout.clear();
-              layout.read(scenery.absoluteFilePath() + SEP + "layout.json");
+              if(packageCache != nullptr)
+                layout = packageCache->getLayout(layoutFile);
+              else
+                layout.read(layoutFile);
 
               for(const QString& path : layout.getBglPaths())
               {
@@ -137,14 +143,21 @@ int FileResolver::getFiles(const SceneryArea& area, QStringList *filepaths, QStr
               QDir sceneryAreaDirObj(scenery.absoluteFilePath());
               QFileInfoList dirs = sceneryAreaDirObj.entryInfoList(QDir::Dirs | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot,
                                                                    QDir::Name | QDir::IgnoreCase);
-              for(const QFileInfo& dir : qAsConst(dirs))
-              {
-                QDir dirObj(dir.absoluteFilePath());
-                bglFiles.append(dirObj.entryInfoList({"*.bgl"},
-                                                     QDir::Files | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot,
-                                                     QDir::Name | QDir::IgnoreCase));
-
-              }
+              // List all directories in parallel and keep order
+              QVector<QFileInfoList> dirFiles(dirs.size());
+              QFileInfoList *dirFilesData = dirFiles.data();
+              atools::util::parallelFor(dirs.size(), [&dirs, dirFilesData](int begin, int end) -> void {
+                    for(int i = begin; i < end; i++)
+                    {
+                      QDir dirObj(dirs.at(i).absoluteFilePath());
+                      dirFilesData[i] = dirObj.entryInfoList({"*.bgl"},
+                                                             QDir::Files | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot,
+                                                             QDir::Name | QDir::IgnoreCase);
+                    }
+                  }, 1 /* minChunkSize */);
+
+              for(const QFileInfoList& files : qAsConst(dirFiles))
+                bglFiles.append(files);
             }
             else
             {
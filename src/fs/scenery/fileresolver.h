@@ -28,6 +28,7 @@ class NavDatabaseOptions;
 namespace scenery {
 
 class SceneryArea;
+class PackageCache;
 
 /*
  * Collects all BGL files for a scenery area considering include and exclude configuration options.
@@ -40,8 +41,10 @@ public:
   /*
    * @param opts configuration optios
    * @param noWarnings do not print warning messages if files could not be found
+   * @param cache Optional cache for MSFS layout files. Files are read directly if null.
    */
-  FileResolver(const atools::fs::NavDatabaseOptions& opts, bool noWarnings = false);
+  FileResolver(const atools::fs::NavDatabaseOptions& opts, bool noWarnings = false,
+               atools::fs::scenery::PackageCache *cache = nullptr);
   virtual ~FileResolver();
 
   /*
@@ -61,6 +64,7 @@ public:
 private:
   QStringList errorMessages;
   const atools::fs::NavDatabaseOptions& options;
+  atools::fs::scenery::PackageCache *packageCache;
   bool quiet = false;
 };
 
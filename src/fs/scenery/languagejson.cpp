@@ -18,11 +18,13 @@
 #include "fs/scenery/languagejson.h"
 
 #include "atools.h"
+#include "fs/scenery/packagecache.h"
 #include "sql/sqldatabase.h"
 #include "sql/sqlquery.h"
 #include "sql/sqlutil.h"
 
 #include <QFile>
+#include <QDataStream>
 #include <QDebug>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -54,7 +56,18 @@ const static QSet<QString> NO_NAMES = {
  */
 void LanguageJson::readFromFile(const QString& filename, const QStringList& keyPrefixes)
 {
-  if(atools::checkFile(Q_FUNC_INFO, filename))
+  if(packageCache != nullptr)
+  {
+    // Get parsed file from cache and merge into index
+    LanguageJson cached = packageCache->getLanguage(filename, keyPrefixes);
+
+    // Keep language like the uncached path if file is missing or not readable - reader already warned
+    if(atools::checkFile(Q_FUNC_INFO, filename, false /* warn */))
+      language = cached.language;
+    for(auto it = cached.names.constBegin(); it != cached.names.constEnd(); ++it)
+      names.insert(it.key(), it.value());
+  }
+  else if(atools::checkFile(Q_FUNC_INFO, filename))
   {
     QFile file(filename);
     if(file.open(QIODevice::ReadOnly))
@@ -238,6 +251,18 @@ void LanguageJson::addModel(const QString& key, const QString& value)
 
 #endif
 
+QDataStream& operator<<(QDataStream& out, const LanguageJson& obj)
+{
+  out << obj.names << obj.language;
+  return out;
+}
+
+QDataStream& operator>>(QDataStream& in, LanguageJson& obj)
+{
+  in >> obj.names >> obj.language;
+  return in;
+}
+
 } // namespace scenery
 } // namespace fs
 } // namespace atools
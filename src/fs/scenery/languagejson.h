@@ -21,6 +21,8 @@
 #include <QHash>
 #include <QString>
 
+class QDataStream;
+
 namespace atools {
 namespace sql {
 class SqlDatabase;
@@ -29,6 +31,8 @@ class SqlDatabase;
 namespace fs {
 namespace scenery {
 
+class PackageCache;
+
 /*
  * Reads MSFS language files like
  * ".../Microsoft.FlightSimulator_8wekyb3d8bbwe/LocalCache/Packages/Official/OneStore/fs-base/en-US.locPak"
@@ -40,9 +44,15 @@ class LanguageJson
 {
 public:
   /* Read translations for one language from JSON file.
-   * Does not clear index before loading. */
+   * Does not clear index before loading. Uses the package cache if set. */
   void readFromFile(const QString& filename, const QStringList& keyPrefixes = {});
 
+  /* Optional cache for parsed language files used by readFromFile(). Not owned. */
+  void setPackageCache(atools::fs::scenery::PackageCache *value)
+  {
+    packageCache = value;
+  }
+
   /* Read translations for all languages from directory using given file filter.
    * Stores translations for all languages to database.
    * Clears index after reading. */
@@ -91,6 +101,10 @@ public:
   }
 
 private:
+  /* Used by PackageCache to store parsed files */
+  friend QDataStream& operator<<(QDataStream& out, const atools::fs::scenery::LanguageJson& obj);
+  friend QDataStream& operator>>(QDataStream& in, atools::fs::scenery::LanguageJson& obj);
+
   void adjustLanguage();
 
   /* Maps key like "TT:AIRPORTXX.MYNN.name" to text */
@@ -106,6 +120,8 @@ private:
   /* Loaded language */
   QString language;
 
+  atools::fs::scenery::PackageCache *packageCache = nullptr;
+
   QString valueFromMap(const QHash<QString, QString>& hash, QString key) const;
 
 };
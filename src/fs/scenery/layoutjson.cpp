@@ -20,6 +20,7 @@
 #include "atools.h"
 
 #include <QFile>
+#include <QDataStream>
 #include <QDebug>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -98,10 +99,23 @@ void LayoutJson::clear()
 {
   bglPaths.clear();
   materialPaths.clear();
+  aircraftCfgPaths.clear();
   fsArchiveFound = false;
   valid = false;
 }
 
+QDataStream& operator<<(QDataStream& out, const LayoutJson& obj)
+{
+  out << obj.bglPaths << obj.materialPaths << obj.aircraftCfgPaths << obj.fsArchiveFound << obj.valid;
+  return out;
+}
+
+QDataStream& operator>>(QDataStream& in, LayoutJson& obj)
+{
+  in >> obj.bglPaths >> obj.materialPaths >> obj.aircraftCfgPaths >> obj.fsArchiveFound >> obj.valid;
+  return in;
+}
+
 } // namespace scenery
 } // namespace fs
 } // namespace atools
@@ -20,6 +20,8 @@
 
 #include <QStringList>
 
+class QDataStream;
+
 namespace atools {
 namespace fs {
 namespace scenery {
@@ -66,6 +68,10 @@ public:
   }
 
 private:
+  /* Used by PackageCache to store parsed files */
+  friend QDataStream& operator<<(QDataStream& out, const atools::fs::scenery::LayoutJson& obj);
+  friend QDataStream& operator>>(QDataStream& in, atools::fs::scenery::LayoutJson& obj);
+
   QStringList bglPaths, materialPaths, aircraftCfgPaths;
   bool fsArchiveFound = false;
   bool valid = false;
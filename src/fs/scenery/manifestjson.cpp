@@ -20,6 +20,7 @@
 #include "atools.h"
 
 #include <QFile>
+#include <QDataStream>
 #include <QDebug>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -91,6 +92,20 @@ void ManifestJson::clear()
   valid = false;
 }
 
+QDataStream& operator<<(QDataStream& out, const ManifestJson& obj)
+{
+  out << obj.contentType << obj.title << obj.manufacturer << obj.creator << obj.packageVersion << obj.minGameVersion
+      << obj.valid;
+  return out;
+}
+
+QDataStream& operator>>(QDataStream& in, ManifestJson& obj)
+{
+  in >> obj.contentType >> obj.title >> obj.manufacturer >> obj.creator >> obj.packageVersion >> obj.minGameVersion
+  >> obj.valid;
+  return in;
+}
+
 } // namespace scenery
 } // namespace fs
 } // namespace atools
@@ -20,6 +20,8 @@
 
 #include <QString>
 
+class QDataStream;
+
 namespace atools {
 namespace fs {
 namespace scenery {
@@ -115,6 +117,10 @@ public:
   }
 
 private:
+  /* Used by PackageCache to store parsed files */
+  friend QDataStream& operator<<(QDataStream& out, const atools::fs::scenery::ManifestJson& obj);
+  friend QDataStream& operator>>(QDataStream& in, atools::fs::scenery::ManifestJson& obj);
+
   QString contentType, title, manufacturer, creator, packageVersion, minGameVersion;
   bool valid = false;
 
@@ -23,6 +23,7 @@
 #include "fs/navdatabaseoptions.h"
 #include "fs/progresshandler.h"
 #include "fs/scenery/layoutjson.h"
+#include "fs/scenery/packagecache.h"
 #include "util/xmlstream.h"
 
 #include <QDir>
@@ -44,7 +45,7 @@ MaterialLib::MaterialLib(const NavDatabaseOptions *opts, ProgressHandler *progre
 void MaterialLib::readCommunity(const QString& basePath)
 {
   LayoutJson layout;
-  layout.read(basePath + atools::SEP + "layout.json");
+  readLayout(layout, basePath + atools::SEP + "layout.json");
   for(const QString& str : layout.getMaterialPaths())
   {
     QString filepath = basePath + atools::SEP + str;
@@ -73,7 +74,7 @@ void MaterialLib::readCommunity(const QString& basePath)
 void MaterialLib::readOfficial(const QString& basePath)
 {
   LayoutJson layout;
-  layout.read(basePath + atools::SEP + "asobo-material-lib" + atools::SEP + "layout.json");
+  readLayout(layout, basePath + atools::SEP + "asobo-material-lib" + atools::SEP + "layout.json");
 
   for(const QString& str : layout.getMaterialPaths())
   {
@@ -100,7 +101,7 @@ void MaterialLib::readOfficial(const QString& basePath)
   }
 
   layout.clear();
-  layout.read(basePath + atools::SEP + "fs-base-material-lib" + atools::SEP + "layout.json");
+  readLayout(layout, basePath + atools::SEP + "fs-base-material-lib" + atools::SEP + "layout.json");
 
   for(const QString& str : layout.getMaterialPaths())
   {
@@ -144,47 +145,68 @@ void MaterialLib::read(const QString& filename)
 {
   if(options->isIncludedGui(QFileInfo(filename)))
   {
-    if(atools::checkFile(Q_FUNC_INFO, filename))
+    if(packageCache != nullptr)
     {
-      QStringList probe = atools::probeFile(filename, 10);
+      // Get parsed file from cache and merge
+      const QHash<QUuid, QString> surfaces = packageCache->getMaterials(filename);
+      for(auto it = surfaces.constBegin(); it != surfaces.constEnd(); ++it)
+        surfaceMap.insert(it.key(), it.value());
+    }
+    else
+      readFile(filename, surfaceMap);
+  }
+}
 
-      // Test if this is not another file type like aircraft checklist definitions
-      if(!probe.filter("<Library", Qt::CaseInsensitive).isEmpty() &&
-         !probe.filter("<Material", Qt::CaseInsensitive).isEmpty())
+void MaterialLib::readFile(const QString& filename, QHash<QUuid, QString>& surfaces)
+{
+  if(atools::checkFile(Q_FUNC_INFO, filename))
+  {
+    QStringList probe = atools::probeFile(filename, 10);
+
+    // Test if this is not another file type like aircraft checklist definitions
+    if(!probe.filter("<Library", Qt::CaseInsensitive).isEmpty() &&
+       !probe.filter("<Material", Qt::CaseInsensitive).isEmpty())
+    {
+      QFile xmlFile(filename);
+      if(xmlFile.open(QIODevice::ReadOnly))
       {
-        QFile xmlFile(filename);
-        if(xmlFile.open(QIODevice::ReadOnly))
-        {
-          atools::util::XmlStream xmlStream(&xmlFile, filename);
-          QXmlStreamReader& reader = xmlStream.getReader();
+        atools::util::XmlStream xmlStream(&xmlFile, filename);
+        QXmlStreamReader& reader = xmlStream.getReader();
 
-          xmlStream.readUntilElement("Library");
+        xmlStream.readUntilElement("Library");
 
-          while(xmlStream.readNextStartElement())
+        while(xmlStream.readNextStartElement())
+        {
+          if(reader.name() == QLatin1String("Material"))
           {
-            if(reader.name() == QLatin1String("Material"))
-            {
-              QString surface = reader.attributes().value("SurfaceType").toString();
-              if(surface != "UNDEFINED")
-                surfaceMap.insert(QUuid(reader.attributes().value("Guid").toString()), surface);
-
-              // Read only attributes
-              xmlStream.skipCurrentElement();
-            }
-            else
-              xmlStream.skipCurrentElement(true /* warn */);
+            QString surface = reader.attributes().value("SurfaceType").toString();
+            if(surface != "UNDEFINED")
+              surfaces.insert(QUuid(reader.attributes().value("Guid").toString()), surface);
+
+            // Read only attributes
+            xmlStream.skipCurrentElement();
           }
-          xmlFile.close();
+          else
+            xmlStream.skipCurrentElement(true /* warn */);
         }
-        else
-          qWarning() << Q_FUNC_INFO << "Cannot open file" << filename << xmlFile.errorString();
+        xmlFile.close();
       }
       else
-        qWarning() << Q_FUNC_INFO << "Cannot open file" << filename << "Not a material library file";
+        qWarning() << Q_FUNC_INFO << "Cannot open file" << filename << xmlFile.errorString();
     }
+    else
+      qWarning() << Q_FUNC_INFO << "Cannot open file" << filename << "Not a material library file";
   }
 }
 
+void MaterialLib::readLayout(LayoutJson& layout, const QString& filename)
+{
+  if(packageCache != nullptr)
+    layout = packageCache->getLayout(filename);
+  else
+    layout.read(filename);
+}
+
 } // namespace scenery
 } // namespace fs
 } // namespace atools
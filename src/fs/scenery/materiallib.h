@@ -30,6 +30,9 @@ class NavDatabaseOptions;
 
 namespace scenery {
 
+class PackageCache;
+class LayoutJson;
+
 /*
  * Reads MSFS material library XML and maps GUIDs to material name if not "UNDEFINED"
  */
@@ -49,9 +52,19 @@ public:
    */
   void readOfficial(const QString& basePath);
 
-  /* Read material from given file */
+  /* Read material from given file. Uses the package cache if set. */
   void read(const QString& filename);
 
+  /* Read a material library file and add all surfaces to the map. Does not check for excluded paths.
+   * Throws exception on XML errors. */
+  static void readFile(const QString& filename, QHash<QUuid, QString>& surfaces);
+
+  /* Optional cache for parsed layout and material library files. Not owned. */
+  void setPackageCache(atools::fs::scenery::PackageCache *value)
+  {
+    packageCache = value;
+  }
+
   void clear()
   {
     surfaceMap.clear();
@@ -64,7 +77,11 @@ public:
   }
 
 private:
+  /* Read layout file from cache if available */
+  void readLayout(LayoutJson& layout, const QString& filename);
+
   QHash<QUuid, QString> surfaceMap;
+  atools::fs::scenery::PackageCache *packageCache = nullptr;
 
   const atools::fs::NavDatabaseOptions *options = nullptr;
   atools::fs::ProgressHandler *progressHandler = nullptr;
@@ -0,0 +1,268 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "fs/scenery/packagecache.h"
+
+#include "fs/scenery/materiallib.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace atools {
+namespace fs {
+namespace scenery {
+
+/* Change version if anything in the serialization of cached classes changes */
+static const quint32 FILE_MAGIC_NUMBER = 0x5A3C91E7;
+static const quint16 FILE_VERSION = 2;
+
+FileFingerprint FileFingerprint::fromFile(const QString& filename)
+{
+  FileFingerprint fingerprint;
+  QFileInfo fileinfo(filename);
+  if(fileinfo.exists() && fileinfo.isFile())
+  {
+    fingerprint.size = fileinfo.size();
+    fingerprint.lastModified = fileinfo.lastModified().toMSecsSinceEpoch();
+  }
+  return fingerprint;
+}
+
+QDataStream& operator<<(QDataStream& out, const FileFingerprint& obj)
+{
+  out << obj.size << obj.lastModified;
+  return out;
+}
+
+QDataStream& operator>>(QDataStream& in, FileFingerprint& obj)
+{
+  in >> obj.size >> obj.lastModified;
+  return in;
+}
+
+// ================================================================================================
+PackageCache::PackageCache()
+{
+}
+
+PackageCache::~PackageCache()
+{
+}
+
+template<typename TYPE>
+TYPE PackageCache::get(QHash<QString, Entry<TYPE> >& hash, const QString& key, const QString& filename,
+                       const std::function<void(TYPE& data)>& reader)
+{
+  // Stat file outside of lock since this can be slow on network drives
+  FileFingerprint fingerprint = FileFingerprint::fromFile(filename);
+
+  if(fingerprint.isValid())
+  {
+    QReadLocker locker(&lock);
+    auto it = hash.constFind(key);
+    if(it != hash.constEnd() && it->fingerprint == fingerprint)
+    {
+      numHits.fetchAndAddRelaxed(1);
+      return it->data;
+    }
+  }
+
+  // Not found, changed or not existing - read file outside of lock =================
+  numMisses.fetchAndAddRelaxed(1);
+  TYPE data;
+  reader(data);
+
+  QWriteLocker locker(&lock);
+  if(fingerprint.isValid())
+    hash.insert(key, {fingerprint, data});
+  else
+    // File is gone - remove stale entry
+    hash.remove(key);
+  changed = true;
+
+  return data;
+}
+
+ManifestJson PackageCache::getManifest(const QString& filename)
+{
+  return get<ManifestJson>(manifests, filename, filename, [&filename](ManifestJson& manifest) -> void {
+        manifest.read(filename);
+      });
+}
+
+LayoutJson PackageCache::getLayout(const QString& filename)
+{
+  return get<LayoutJson>(layouts, filename, filename, [&filename](LayoutJson& layout) -> void {
+        layout.read(filename);
+      });
+}
+
+QHash<QUuid, QString> PackageCache::getMaterials(const QString& filename)
+{
+  return get<QHash<QUuid, QString> >(materials, filename, filename, [&filename](QHash<QUuid, QString>& surfaceMap) -> void {
+        MaterialLib::readFile(filename, surfaceMap);
+      });
+}
+
+LanguageJson PackageCache::getLanguage(const QString& filename, const QStringList& keyPrefixes)
+{
+  // Prefixes change content - add to key
+  QString key = filename + '|' + keyPrefixes.join(';');
+  return get<LanguageJson>(languages, key, filename, [&filename, &keyPrefixes](LanguageJson& language) -> void {
+        language.readFromFile(filename, keyPrefixes);
+      });
+}
+
+void PackageCache::clear()
+{
+  QWriteLocker locker(&lock);
+  manifests.clear();
+  layouts.clear();
+  materials.clear();
+  languages.clear();
+  changed = true;
+}
+
+template<typename TYPE>
+void PackageCache::writeHash(QDataStream& out, const QHash<QString, Entry<TYPE> >& hash)
+{
+  out << static_cast<qint32>(hash.size());
+  for(auto it = hash.constBegin(); it != hash.constEnd(); ++it)
+    out << it.key() << it->fingerprint << it->data;
+}
+
+template<typename TYPE>
+void PackageCache::readHash(QDataStream& in, QHash<QString, Entry<TYPE> >& hash)
+{
+  qint32 size;
+  in >> size;
+
+  hash.reserve(size);
+  for(qint32 i = 0; i < size && in.status() == QDataStream::Ok; i++)
+  {
+    QString filename;
+    Entry<TYPE> entry;
+    in >> filename >> entry.fingerprint >> entry.data;
+    hash.insert(filename, entry);
+  }
+}
+
+bool PackageCache::loadFile(const QString& filename)
+{
+  QWriteLocker locker(&lock);
+  manifests.clear();
+  layouts.clear();
+  materials.clear();
+  languages.clear();
+  changed = false;
+
+  QFile file(filename);
+  if(file.exists())
+  {
+    if(file.open(QIODevice::ReadOnly))
+    {
+      // Map file into memory and deserialize directly from the mapping - avoids reading it into a buffer first
+      uchar *mapped = file.size() > 0 ? file.map(0, file.size()) : nullptr;
+
+      if(mapped != nullptr)
+      {
+        QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), static_cast<int>(file.size()));
+        QDataStream in(bytes);
+        in.setVersion(QDataStream::Qt_5_5);
+
+        quint32 magic;
+        quint16 version;
+        in >> magic >> version;
+
+        if(magic == FILE_MAGIC_NUMBER && version == FILE_VERSION)
+        {
+          readHash(in, manifests);
+          readHash(in, layouts);
+          readHash(in, materials);
+          readHash(in, languages);
+
+          if(in.status() != QDataStream::Ok)
+          {
+            qWarning() << Q_FUNC_INFO << "Error reading" << filename << "status" << in.status();
+            manifests.clear();
+            layouts.clear();
+            materials.clear();
+            languages.clear();
+          }
+        }
+        else
+          qWarning() << Q_FUNC_INFO << "Cannot read" << filename << "Invalid magic number or version:" << magic << version;
+
+        file.unmap(mapped);
+      }
+      else
+        qWarning() << Q_FUNC_INFO << "Cannot map file" << filename << file.errorString();
+
+      file.close();
+    }
+    else
+      qWarning() << Q_FUNC_INFO << "Cannot open file" << filename << file.errorString();
+  }
+
+  qDebug() << Q_FUNC_INFO << filename << "manifests" << manifests.size() << "layouts" << layouts.size()
+           << "materials" << materials.size() << "languages" << languages.size();
+  return !manifests.isEmpty() || !layouts.isEmpty() || !materials.isEmpty() || !languages.isEmpty();
+}
+
+bool PackageCache::saveFile(const QString& filename)
+{
+  QWriteLocker locker(&lock);
+
+  qDebug() << Q_FUNC_INFO << filename << "changed" << changed << "hits" << numHits.loadAcquire()
+           << "misses" << numMisses.loadAcquire();
+
+  if(!changed)
+    return false;
+
+  // Write to temporary file first and rename on commit to avoid corrupted files
+  QSaveFile file(filename);
+  if(file.open(QIODevice::WriteOnly))
+  {
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_5);
+    out << FILE_MAGIC_NUMBER << FILE_VERSION;
+    writeHash(out, manifests);
+    writeHash(out, layouts);
+    writeHash(out, materials);
+    writeHash(out, languages);
+
+    if(file.commit())
+    {
+      changed = false;
+      return true;
+    }
+    else
+      qWarning() << Q_FUNC_INFO << "Cannot write file" << filename << file.errorString();
+  }
+  else
+    qWarning() << Q_FUNC_INFO << "Cannot open file" << filename << file.errorString();
+
+  return false;
+}
+
+} // namespace scenery
+} // namespace fs
+} // namespace atools
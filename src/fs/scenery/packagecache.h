@@ -0,0 +1,155 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef ATOOLS_PACKAGECACHE_H
+#define ATOOLS_PACKAGECACHE_H
+
+#include "fs/scenery/languagejson.h"
+#include "fs/scenery/layoutjson.h"
+#include "fs/scenery/manifestjson.h"
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QUuid>
+
+#include <functional>
+
+class QDataStream;
+
+namespace atools {
+namespace fs {
+namespace scenery {
+
+/*
+ * Size and last modification time of a file. Used to detect changed files without reading them.
+ */
+struct FileFingerprint
+{
+  /* Get size and modification time. Result is invalid if file does not exist. */
+  static FileFingerprint fromFile(const QString& filename);
+
+  bool isValid() const
+  {
+    return size >= 0;
+  }
+
+  bool operator==(const FileFingerprint& other) const
+  {
+    return size == other.size && lastModified == other.lastModified;
+  }
+
+  bool operator!=(const FileFingerprint& other) const
+  {
+    return !operator==(other);
+  }
+
+  qint64 size = -1, lastModified = -1; // Milliseconds since epoch
+};
+
+QDataStream& operator<<(QDataStream& out, const atools::fs::scenery::FileFingerprint& obj);
+QDataStream& operator>>(QDataStream& in, atools::fs::scenery::FileFingerprint& obj);
+
+/*
+ * Keeps parsed MSFS "manifest.json", "layout.json", material library "Library.xml" and language ".locPak" files
+ * keyed by absolute filename. A file is only read if it is not in the cache or if its size or
+ * modification time changed.
+ *
+ * The cache can be saved to and loaded from a binary file to avoid parsing unchanged files
+ * again on the next compilation or aircraft index load. The file is memory mapped when loading.
+ *
+ * All get methods are thread safe and can be called from several threads at the same time.
+ */
+class PackageCache
+{
+public:
+  PackageCache();
+  ~PackageCache();
+
+  PackageCache(const PackageCache& other) = delete;
+  PackageCache& operator=(const PackageCache& other) = delete;
+
+  /* Load cache file. Ignores missing files, files with wrong version or truncated files.
+   * Returns true if file was loaded. */
+  bool loadFile(const QString& filename);
+
+  /* Write cache file if anything was changed since loading. Returns true if file was written. */
+  bool saveFile(const QString& filename);
+
+  /* Get parsed manifest from cache. Reads file and updates cache if needed. */
+  ManifestJson getManifest(const QString& filename);
+
+  /* Get parsed layout from cache. Reads file and updates cache if needed. */
+  LayoutJson getLayout(const QString& filename);
+
+  /* Get material UUID to surface map of a material library file. Reads file using MaterialLib::readFile() and
+   * updates cache if needed. Exceptions from reading are passed through and nothing is cached in this case. */
+  QHash<QUuid, QString> getMaterials(const QString& filename);
+
+  /* Get translations from a language file. Uses LanguageJson::readFromFile() and caches separately for each
+   * set of key prefixes. */
+  LanguageJson getLanguage(const QString& filename, const QStringList& keyPrefixes = {});
+
+  /* Remove all entries */
+  void clear();
+
+  /* Statistics for logging */
+  int getNumHits() const
+  {
+    return numHits.loadAcquire();
+  }
+
+  int getNumMisses() const
+  {
+    return numMisses.loadAcquire();
+  }
+
+private:
+  template<typename TYPE>
+  struct Entry
+  {
+    FileFingerprint fingerprint;
+    TYPE data;
+  };
+
+  /* Look up entry by key and read file using reader if not present or changed */
+  template<typename TYPE>
+  TYPE get(QHash<QString, Entry<TYPE> >& hash, const QString& key, const QString& filename,
+           const std::function<void(TYPE& data)>& reader);
+
+  /* Serialize a whole hash */
+  template<typename TYPE>
+  static void writeHash(QDataStream& out, const QHash<QString, Entry<TYPE> >& hash);
+
+  template<typename TYPE>
+  static void readHash(QDataStream& in, QHash<QString, Entry<TYPE> >& hash);
+
+  QHash<QString, Entry<ManifestJson> > manifests;
+  QHash<QString, Entry<LayoutJson> > layouts;
+  QHash<QString, Entry<QHash<QUuid, QString> > > materials;
+  QHash<QString, Entry<LanguageJson> > languages;
+
+  QReadWriteLock lock;
+  bool changed = false;
+  QAtomicInt numHits, numMisses;
+};
+
+} // namespace scenery
+} // namespace fs
+} // namespace atools
+
+#endif // ATOOLS_PACKAGECACHE_H
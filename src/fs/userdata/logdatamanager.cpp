@@ -22,7 +22,7 @@
 #include "sql/sqlutil.h"
 #include "sql/sqlexport.h"
 #include "sql/sqldatabase.h"
-#include "util/csvreader.h"
+#include "util/csvscanner.h"
 #include "geo/pos.h"
 #include "zip/gzip.h"
 #include "geo/calculations.h"
@@ -165,8 +165,9 @@ LogdataManager::~LogdataManager()
 int LogdataManager::importCsv(const QString& filepath)
 {
   int numImported = 0;
-  QFile file(filepath);
-  if(file.open(QIODevice::ReadOnly | QIODevice::Text))
+  // Memory mapped block based reader
+  atools::util::CsvScanner scanner;
+  if(scanner.openFile(filepath))
   {
     int id = getCurrentId() + 1;
     atools::sql::DataManagerUndoHandler undoHandler(this, id);
@@ -176,17 +177,10 @@ int LogdataManager::importCsv(const QString& filepath)
     SqlQuery insertQuery(db);
     insertQuery.prepare(SqlUtil(db).buildInsertStatement(tableName, QString(), QStringList(), true /* namedBindings */));
 
-    atools::util::CsvReader reader;
-
-    QTextStream stream(&file);
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-    stream.setCodec("UTF-8");
-#endif
-
     int lineNum = 1;
-    while(!stream.atEnd())
+    while(scanner.readRecord())
     {
-      QString line = stream.readLine();
+      QString line = scanner.getRecordText();
 
       if(lineNum == 1)
       {
@@ -199,16 +193,8 @@ int LogdataManager::importCsv(const QString& filepath)
         }
       }
 
-      // Skip empty lines but add them if within an escaped field
-      if(line.isEmpty() && !reader.isInEscape())
-        continue;
-
-      reader.readCsvLine(line);
-      if(reader.isInEscape())
-        // Still in an escaped line so continue to read unchanged until " shows the end of the field
-        continue;
-
-      const QStringList& values = reader.getValues();
+      // Empty lines are skipped and escaped fields with linefeeds are joined by the scanner
+      const QStringList values = scanner.getValues();
 
       if(values.size() < csv::MIN_NUM_COLS)
         throw atools::Exception(tr("File contains invalid data.\n\"%1\"\nLine %2.").arg(line).arg(lineNum));
@@ -315,11 +301,11 @@ int LogdataManager::importCsv(const QString& filepath)
       numImported++;
     }
 
-    file.close();
+    scanner.close();
     undoHandler.finish();
-  } // if(file.open(QIODevice::ReadOnly | QIODevice::Text))
+  } // if(scanner.openFile(filepath))
   else
-    throw atools::Exception(tr("Cannot open file \"%1\". Reason: %2.").arg(filepath).arg(file.errorString()));
+    throw atools::Exception(tr("Cannot open file \"%1\". Reason: %2.").arg(filepath).arg(scanner.getErrorString()));
 
   return numImported;
 }
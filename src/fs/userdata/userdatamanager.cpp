@@ -28,7 +28,7 @@
 #include "sql/sqlexport.h"
 #include "sql/sqltransaction.h"
 #include "sql/sqlutil.h"
-#include "util/csvreader.h"
+#include "util/csvscanner.h"
 
 #include <QDir>
 #include <QRegularExpression>
@@ -217,8 +217,9 @@ int UserdataManager::importCsv(const QStringList& filepaths, atools::fs::userdat
     if(filepath.isEmpty())
       continue;
 
-    QFile file(filepath);
-    if(file.open(QIODevice::ReadOnly | QIODevice::Text))
+    // Memory mapped block based reader
+    atools::util::CsvScanner scanner(separator, escape, true /* trim */);
+    if(scanner.openFile(filepath))
     {
       QString idBinding(":" % idColumnName);
 
@@ -230,19 +231,12 @@ int UserdataManager::importCsv(const QStringList& filepaths, atools::fs::userdat
       QString absfilepath = QFileInfo(filepath).absoluteFilePath();
       QDateTime now = QDateTime::currentDateTime();
 
-      atools::util::CsvReader reader(separator, escape, true /* trim */);
-
-      QTextStream stream(&file);
-      stream.setCodec("UTF-8");
-
       int lineNum = 1;
-      while(!stream.atEnd())
+      while(scanner.readRecord())
       {
-        QString line = stream.readLine();
-
         if(lineNum == 1)
         {
-          QString header = QString(line).simplified().replace(' ', QString()).replace('"', QString()).toLower();
+          QString header = scanner.getRecordText().simplified().replace(' ', QString()).replace('"', QString()).toLower();
           if(flags & CSV_HEADER || header.startsWith("type,name,ident,latitude,longitude"))
           {
             lineNum++;
@@ -251,19 +245,11 @@ int UserdataManager::importCsv(const QStringList& filepaths, atools::fs::userdat
           }
         }
 
-        // Skip empty lines but add them if within an escaped field
-        if(line.isEmpty() && !reader.isInEscape())
-          continue;
-
-        reader.readCsvLine(line);
-        if(reader.isInEscape())
-          // Still in an escaped line so continue to read unchanged until " shows the end of the field
-          continue;
-
-        const QStringList& values = reader.getValues();
+        // Empty lines are skipped and escaped fields with linefeeds are joined by the scanner
+        if(scanner.getNumFields() < csv::MIN_NUM_COLS)
+          throw atools::Exception(tr("File contains invalid data.\n\"%1\"\nLine %2.").arg(scanner.getRecordText()).arg(lineNum));
 
-        if(values.size() < csv::MIN_NUM_COLS)
-          throw atools::Exception(tr("File contains invalid data.\n\"%1\"\nLine %2.").arg(line).arg(lineNum));
+        const QStringList values = scanner.getValues();
 
         insertQuery.bindValue(idBinding, id++);
         insertQuery.bindValue(":type", at(values, csv::TYPE));
@@ -300,7 +286,7 @@ int UserdataManager::importCsv(const QStringList& filepaths, atools::fs::userdat
 
         insertQuery.bindValue(":altitude", alt);
 
-        validateCoordinates(line, at(values, csv::LONX), at(values, csv::LATY), lineNum, false /* checkNull */);
+        validateCoordinates(scanner.getRecordText(), at(values, csv::LONX), at(values, csv::LATY), lineNum, false /* checkNull */);
         insertQuery.bindValue(":lonx", at(values, csv::LONX, true));
         insertQuery.bindValue(":laty", at(values, csv::LATY, true));
 
@@ -310,10 +296,10 @@ int UserdataManager::importCsv(const QStringList& filepaths, atools::fs::userdat
         lineNum++;
         numImported++;
       }
-      file.close();
+      scanner.close();
     }
     else
-      throw atools::Exception(tr("Cannot open file \"%1\". Reason: %2.").arg(filepath).arg(file.errorString()));
+      throw atools::Exception(tr("Cannot open file \"%1\". Reason: %2.").arg(filepath).arg(scanner.getErrorString()));
 
   } // for(const QString& filepath : filepaths)
 
@@ -19,11 +19,11 @@
 
 #include "geo/pos.h"
 #include "atools.h"
-#include "exception.h"
 
 #include <cmath>
 #include <QRegularExpression>
 #include <QLocale>
+#include <QVarLengthArray>
 
 using atools::geo::Pos;
 
@@ -33,22 +33,12 @@ namespace util {
 
 // N48194W123096
 const static QString COORDS_FLIGHTPLAN_FORMAT_GFP("%1%2%3%4%5%6");
-const static QRegularExpression LONG_FORMAT_REGEXP_GFP("^([NS])([0-9]{2})([0-9]{3})"
-                                                       "([EW])([0-9]{3})([0-9]{3})$");
-
-// 46N078W
-const static QRegularExpression LONG_FORMAT_REGEXP_DEG("^([0-9]{2})([NS])"
-                                                       "([0-9]{3})([EW])$");
 
 // 4510N06810W
 const static QString COORDS_FLIGHTPLAN_FORMAT_DEG_MIN("%1%2%3%4%5%6");
-const static QRegularExpression LONG_FORMAT_REGEXP_DEG_MIN("^([0-9]{2})([0-9]{2})([NS])"
-                                                           "([0-9]{3})([0-9]{2})([EW])$");
 
 // 481200N0112842E
 const static QString COORDS_FLIGHTPLAN_FORMAT_DEG_MIN_SEC("%1%2%3%4%5%6%7%8");
-const static QRegularExpression LONG_FORMAT_REGEXP_DEG_MIN_SEC("^([0-9]{2})([0-9]{2})([0-9]{2})([NS])"
-                                                               "([0-9]{3})([0-9]{2})([0-9]{2})([EW])$");
 
 // Pattern allows trailing garbage
 // 50:40:42 N 003:13:30 E
@@ -61,22 +51,8 @@ static QRegularExpression MATCH_COORD_OPENAIR_MIN_SEC("^([\\d]+):([\\d]+):([\\d\
 static QRegularExpression MATCH_COORD_OPENAIR_MIN("^([\\d]+):([\\d\\.]+)\\s*([NS])\\s*"
                                                   "([\\d]+):([\\d\\.]+)\\s*([EW])");
 
-// ARINC full degreee waypoints
-// 57N30 5730N 5730E 57E30
-// 57W30 5730W 5730S 57S30
-const static QRegularExpression LONG_FORMAT_REGEXP_ARINC("^([0-9]{2})"
-                                                         "([0-9]{2})([NWES])$");
-const static QRegularExpression LONG_FORMAT_REGEXP_ARINC2("^([0-9]{2})([NWES])"
-                                                          "([0-9]{2})$");
-
 // N6400 W07000 or N6400/W07000
 const static QString COORDS_FLIGHTPLAN_FORMAT_PAIR("%1%2/%3%4");
-const static QRegularExpression LONG_FORMAT_REGEXP_PAIR("^([NS])([0-9]{2})([0-9]{2})[ /]"
-                                                        "([EW])([0-9]{3})([0-9]{2})$");
-const static QRegularExpression LONG_FORMAT_REGEXP_PAIR2("^([0-9]{2})([0-9]{2})([NS])[ /]"
-                                                         "([0-9]{3})([0-9]{2})([EW])$");
-const static QRegularExpression LONG_FORMAT_REGEXP_PAIR_LAT("^([NS])([0-9]{2})([0-9]{2})$");
-const static QRegularExpression LONG_FORMAT_REGEXP_PAIR_LON("^([EW])([0-9]{3})([0-9]{2})$");
 
 atools::geo::Pos degMinSecFormatFromCapture(const QStringList& captured);
 atools::geo::Pos degMinFormatFromCapture(const QStringList& captured);
@@ -125,34 +101,55 @@ QString toDegMinSecFormat(const atools::geo::Pos& pos)
     return QString();
 }
 
+/* true if str contains only ASCII digits from pos to pos + len */
+static bool isDigits(const QString& str, int pos, int len)
+{
+  for(int i = pos; i < pos + len; i++)
+  {
+    QChar c = str.at(i);
+    if(c < QChar('0') || c > QChar('9'))
+      return false;
+  }
+  return true;
+}
+
+/* Convert digits checked by isDigits() to int. Not more than nine digits. */
+static int digitsToInt(const QString& str, int pos, int len)
+{
+  int value = 0;
+  for(int i = pos; i < pos + len; i++)
+    value = value * 10 + (str.at(i).unicode() - '0');
+  return value;
+}
+
+/* true if character at pos is one of the two given */
+static bool isChar(const QString& str, int pos, char c1, char c2)
+{
+  QChar c = str.at(pos);
+  return c == QChar(c1) || c == QChar(c2);
+}
+
 // Garmin format N48194W123096
 atools::geo::Pos fromGfpFormat(const QString& str)
 {
-  QRegularExpressionMatch match = LONG_FORMAT_REGEXP_GFP.match(str.simplified().toUpper());
+  QString coordStr = str.simplified().toUpper();
 
-  if(match.hasMatch())
+  if(coordStr.size() == 13 && isChar(coordStr, 0, 'N', 'S') && isDigits(coordStr, 1, 5) &&
+     isChar(coordStr, 6, 'E', 'W') && isDigits(coordStr, 7, 6))
   {
-    QStringList captured = match.capturedTexts();
-
-    if(captured.size() == 7)
-    {
-      bool latOk, lonOk, latMinOk, lonMinOk;
-      QString ns = captured.at(1);
-      int latYDeg = captured.at(2).toInt(&latOk);
-      float latYMin = captured.at(3).toFloat(&latMinOk) / 10.f;
-      float latYSec = (latYMin - std::floor(latYMin)) * 60.f;
-
-      QString ew = captured.at(4);
-      int lonXDeg = captured.at(5).toInt(&lonOk);
-      float lonXMin = captured.at(6).toFloat(&lonMinOk) / 10.f;
-      float lonXSec = (lonXMin - std::floor(lonXMin)) * 60.f;
-
-      if(latOk && lonOk && latMinOk && lonMinOk &&
-         -90 <= latYDeg && latYDeg <= 90 &&
-         -180 <= lonXDeg && lonXDeg <= 180)
-        return atools::geo::Pos(lonXDeg, static_cast<int>(lonXMin), lonXSec, ew == "W",
-                                latYDeg, static_cast<int>(latYMin), latYSec, ns == "S");
-    }
+    bool south = coordStr.at(0) == QChar('S');
+    int latYDeg = digitsToInt(coordStr, 1, 2);
+    float latYMin = digitsToInt(coordStr, 3, 3) / 10.f;
+    float latYSec = (latYMin - std::floor(latYMin)) * 60.f;
+
+    bool west = coordStr.at(6) == QChar('W');
+    int lonXDeg = digitsToInt(coordStr, 7, 3);
+    float lonXMin = digitsToInt(coordStr, 10, 3) / 10.f;
+    float lonXSec = (lonXMin - std::floor(lonXMin)) * 60.f;
+
+    if(latYDeg <= 90 && lonXDeg <= 180)
+      return atools::geo::Pos(lonXDeg, static_cast<int>(lonXMin), lonXSec, west,
+                              latYDeg, static_cast<int>(latYMin), latYSec, south);
   }
   return atools::geo::EMPTY_POS;
 }
@@ -160,27 +157,17 @@ atools::geo::Pos fromGfpFormat(const QString& str)
 // Degrees only 46N078W
 atools::geo::Pos fromDegFormat(const QString& str)
 {
-  QRegularExpressionMatch match = LONG_FORMAT_REGEXP_DEG.match(str.simplified().toUpper());
+  QString coordStr = str.simplified().toUpper();
 
-  if(match.hasMatch())
+  if(coordStr.size() == 7 && isDigits(coordStr, 0, 2) && isChar(coordStr, 2, 'N', 'S') &&
+     isDigits(coordStr, 3, 3) && isChar(coordStr, 6, 'E', 'W'))
   {
-    QStringList captured = match.capturedTexts();
+    int latYDeg = digitsToInt(coordStr, 0, 2);
+    int lonXDeg = digitsToInt(coordStr, 3, 3);
 
-    if(captured.size() == 5)
-    {
-      bool latOk, lonOk;
-      int latYDeg = captured.at(1).toInt(&latOk);
-      QString ns = captured.at(2);
-
-      int lonXDeg = captured.at(3).toInt(&lonOk);
-      QString ew = captured.at(4);
-
-      if(latOk && lonOk &&
-         -90.f <= latYDeg && latYDeg <= 90.f &&
-         -180.f <= lonXDeg && lonXDeg <= 180.f)
-        return atools::geo::Pos(lonXDeg, 0, 0.f, ew == "W",
-                                latYDeg, 0, 0.f, ns == "S");
-    }
+    if(latYDeg <= 90 && lonXDeg <= 180)
+      return atools::geo::Pos(lonXDeg, 0, 0.f, coordStr.at(6) == QChar('W'),
+                              latYDeg, 0, 0.f, coordStr.at(2) == QChar('S'));
   }
   return atools::geo::EMPTY_POS;
 }
@@ -188,29 +175,19 @@ atools::geo::Pos fromDegFormat(const QString& str)
 // Degrees and minutes 4510N06810W
 atools::geo::Pos fromDegMinFormat(const QString& str)
 {
-  QRegularExpressionMatch match = LONG_FORMAT_REGEXP_DEG_MIN.match(str.simplified().toUpper());
+  QString coordStr = str.simplified().toUpper();
 
-  if(match.hasMatch())
+  if(coordStr.size() == 11 && isDigits(coordStr, 0, 4) && isChar(coordStr, 4, 'N', 'S') &&
+     isDigits(coordStr, 5, 5) && isChar(coordStr, 10, 'E', 'W'))
   {
-    QStringList captured = match.capturedTexts();
-
-    if(captured.size() == 7)
-    {
-      bool latOk, lonOk, latMinOk, lonMinOk;
-      int latYDeg = captured.at(1).toInt(&latOk);
-      int latYMin = captured.at(2).toInt(&latMinOk);
-      QString ns = captured.at(3);
-
-      int lonXDeg = captured.at(4).toInt(&lonOk);
-      int lonXMin = captured.at(5).toInt(&lonMinOk);
-      QString ew = captured.at(6);
-
-      if(latOk && lonOk && latMinOk && lonMinOk &&
-         -90 <= latYDeg && latYDeg <= 90 &&
-         -180 <= lonXDeg && lonXDeg <= 180)
-        return atools::geo::Pos(lonXDeg, lonXMin, 0.f, ew == "W",
-                                latYDeg, latYMin, 0.f, ns == "S");
-    }
+    int latYDeg = digitsToInt(coordStr, 0, 2);
+    int latYMin = digitsToInt(coordStr, 2, 2);
+    int lonXDeg = digitsToInt(coordStr, 5, 3);
+    int lonXMin = digitsToInt(coordStr, 8, 2);
+
+    if(latYDeg <= 90 && lonXDeg <= 180)
+      return atools::geo::Pos(lonXDeg, lonXMin, 0.f, coordStr.at(10) == QChar('W'),
+                              latYDeg, latYMin, 0.f, coordStr.at(4) == QChar('S'));
   }
 
   return atools::geo::EMPTY_POS;
@@ -219,10 +196,22 @@ atools::geo::Pos fromDegMinFormat(const QString& str)
 // Degrees, minutes and seconds 481200N0112842E
 atools::geo::Pos fromDegMinSecFormat(const QString& str)
 {
-  QRegularExpressionMatch match = LONG_FORMAT_REGEXP_DEG_MIN_SEC.match(str.simplified().toUpper());
+  QString coordStr = str.simplified().toUpper();
 
-  if(match.hasMatch())
-    return degMinSecFormatFromCapture(match.capturedTexts());
+  if(coordStr.size() == 15 && isDigits(coordStr, 0, 6) && isChar(coordStr, 6, 'N', 'S') &&
+     isDigits(coordStr, 7, 7) && isChar(coordStr, 14, 'E', 'W'))
+  {
+    int latYDeg = digitsToInt(coordStr, 0, 2);
+    int latYMin = digitsToInt(coordStr, 2, 2);
+    float latYSec = digitsToInt(coordStr, 4, 2);
+    int lonXDeg = digitsToInt(coordStr, 7, 3);
+    int lonXMin = digitsToInt(coordStr, 10, 2);
+    float lonXSec = digitsToInt(coordStr, 12, 2);
+
+    if(latYDeg <= 90 && lonXDeg <= 180)
+      return atools::geo::Pos(lonXDeg, lonXMin, lonXSec, coordStr.at(14) == QChar('W'),
+                              latYDeg, latYMin, latYSec, coordStr.at(6) == QChar('S'));
+  }
 
   return atools::geo::EMPTY_POS;
 }
@@ -230,119 +219,80 @@ atools::geo::Pos fromDegMinSecFormat(const QString& str)
 // Degrees and minutes in pair N6400 W07000 or N6400/W07000
 atools::geo::Pos fromDegMinPairFormat(const QString& str)
 {
-  QRegularExpressionMatch match = LONG_FORMAT_REGEXP_PAIR.match(str.simplified().toUpper());
-
-  bool latOk = false, lonOk = false, latMinOk = false, lonMinOk = false;
-  QString ns, ew;
-  int latYDeg = 0, latYMin = 0, lonXDeg = 0, lonXMin = 0;
+  QString coordStr = str.simplified().toUpper();
 
-  if(match.hasMatch())
+  if(coordStr.size() == 12 && isChar(coordStr, 5, ' ', '/'))
   {
-    QStringList captured = match.capturedTexts();
-    if(captured.size() == 7)
+    int latYDeg = 0, latYMin = 0, lonXDeg = 0, lonXMin = 0;
+    bool south = false, west = false, found = false;
+
+    if(isChar(coordStr, 0, 'N', 'S') && isDigits(coordStr, 1, 4) &&
+       isChar(coordStr, 6, 'E', 'W') && isDigits(coordStr, 7, 5))
     {
-      ns = captured.at(1);
-      latYDeg = captured.at(2).toInt(&latOk);
-      latYMin = captured.at(3).toInt(&latMinOk);
-      ew = captured.at(4);
-      lonXDeg = captured.at(5).toInt(&lonOk);
-      lonXMin = captured.at(6).toInt(&lonMinOk);
+      // N6400 W07000
+      south = coordStr.at(0) == QChar('S');
+      latYDeg = digitsToInt(coordStr, 1, 2);
+      latYMin = digitsToInt(coordStr, 3, 2);
+      west = coordStr.at(6) == QChar('W');
+      lonXDeg = digitsToInt(coordStr, 7, 3);
+      lonXMin = digitsToInt(coordStr, 10, 2);
+      found = true;
     }
-  }
-  else
-  {
-    QRegularExpressionMatch match2 = LONG_FORMAT_REGEXP_PAIR2.match(str.simplified().toUpper());
-
-    if(match2.hasMatch())
+    else if(isDigits(coordStr, 0, 4) && isChar(coordStr, 4, 'N', 'S') &&
+            isDigits(coordStr, 6, 5) && isChar(coordStr, 11, 'E', 'W'))
     {
-      QStringList captured = match2.capturedTexts();
-      if(captured.size() == 7)
-      {
-        latYDeg = captured.at(1).toInt(&latOk);
-        latYMin = captured.at(2).toInt(&latMinOk);
-        ns = captured.at(3);
-        lonXDeg = captured.at(4).toInt(&lonOk);
-        lonXMin = captured.at(5).toInt(&lonMinOk);
-        ew = captured.at(6);
-      }
+      // 6400N 07000W
+      latYDeg = digitsToInt(coordStr, 0, 2);
+      latYMin = digitsToInt(coordStr, 2, 2);
+      south = coordStr.at(4) == QChar('S');
+      lonXDeg = digitsToInt(coordStr, 6, 3);
+      lonXMin = digitsToInt(coordStr, 9, 2);
+      west = coordStr.at(11) == QChar('W');
+      found = true;
     }
+
+    if(found && latYDeg <= 90 && lonXDeg <= 180)
+      return atools::geo::Pos(lonXDeg, lonXMin, 0.f, west, latYDeg, latYMin, 0.f, south);
   }
+  return atools::geo::EMPTY_POS;
+}
 
-  if(latOk && lonOk && latMinOk && lonMinOk &&
-     -90 <= latYDeg && latYDeg <= 90 &&
-     -180 <= lonXDeg && lonXDeg <= 180)
-    return atools::geo::Pos(lonXDeg, lonXMin, 0.f, ew == "W",
-                            latYDeg, latYMin, 0.f, ns == "S");
-  else
-    return atools::geo::EMPTY_POS;
+/* Apply ARINC designator to full degrees */
+static atools::geo::Pos arincPos(int latYDeg, int lonXDeg, QChar designator)
+{
+  if(designator == 'N')
+    lonXDeg = -lonXDeg;
+  else if(designator == 'W')
+  {
+    lonXDeg = -lonXDeg;
+    latYDeg = -latYDeg;
+  }
+  else if(designator == 'S')
+    latYDeg = -latYDeg;
+
+  return Pos(static_cast<float>(lonXDeg), static_cast<float>(latYDeg));
 }
 
 // 57N30 5730N 5730E 57E30 57W30 5730W 5730S 57S30
 atools::geo::Pos fromArincFormat(const QString& str)
 {
-  // 5730N 5730E 5730W 5730S
-  QRegularExpressionMatch match = LONG_FORMAT_REGEXP_ARINC.match(str.simplified().toUpper());
+  QString coordStr = str.simplified().toUpper();
 
-  if(match.hasMatch())
+  if(coordStr.size() == 5 && isDigits(coordStr, 0, 2))
   {
-    QStringList captured = match.capturedTexts();
-
-    if(captured.size() == 4)
+    if(isDigits(coordStr, 2, 2) && (isChar(coordStr, 4, 'N', 'S') || isChar(coordStr, 4, 'E', 'W')))
     {
-      bool latOk, lonOk;
-      int latYDeg = captured.at(1).toInt(&latOk);
-      int lonXDeg = captured.at(2).toInt(&lonOk);
-
-      if(latOk && lonOk)
-      {
-        QChar designator = atools::charAt(captured.at(3), 0);
-        if(designator == 'N')
-          lonXDeg = -lonXDeg;
-        else if(designator == 'W')
-        {
-          lonXDeg = -lonXDeg;
-          latYDeg = -latYDeg;
-        }
-        else if(designator == 'S')
-          latYDeg = -latYDeg;
-
-        Pos pos(static_cast<float>(lonXDeg), static_cast<float>(latYDeg));
-        if(pos.isValidRange())
-          return pos;
-      }
+      // 5730N 5730E 5730W 5730S
+      Pos pos = arincPos(digitsToInt(coordStr, 0, 2), digitsToInt(coordStr, 2, 2), coordStr.at(4));
+      if(pos.isValidRange())
+        return pos;
     }
-  }
-
-  // 57N30 57E30 57W30 57S30 longitude + 100
-  match = LONG_FORMAT_REGEXP_ARINC2.match(str.simplified().toUpper());
-
-  if(match.hasMatch())
-  {
-    QStringList captured = match.capturedTexts();
-
-    if(captured.size() == 4)
+    else if((isChar(coordStr, 2, 'N', 'S') || isChar(coordStr, 2, 'E', 'W')) && isDigits(coordStr, 3, 2))
     {
-      bool latOk, lonOk;
-      int latYDeg = captured.at(1).toInt(&latOk);
-      int lonXDeg = captured.at(3).toInt(&lonOk) + 100;
-
-      if(latOk && lonOk)
-      {
-        QChar designator = atools::charAt(captured.at(2), 0);
-        if(designator == 'N')
-          lonXDeg = -lonXDeg;
-        else if(designator == 'W')
-        {
-          lonXDeg = -lonXDeg;
-          latYDeg = -latYDeg;
-        }
-        else if(designator == 'S')
-          latYDeg = -latYDeg;
-
-        Pos pos(static_cast<float>(lonXDeg), static_cast<float>(latYDeg));
-        if(pos.isValidRange())
-          return pos;
-      }
+      // 57N30 57E30 57W30 57S30 longitude + 100
+      Pos pos = arincPos(digitsToInt(coordStr, 0, 2), digitsToInt(coordStr, 3, 2) + 100, coordStr.at(2));
+      if(pos.isValidRange())
+        return pos;
     }
   }
 
@@ -434,97 +384,199 @@ atools::geo::Pos degMinSecFormatFromCapture(const QStringList& captured)
   return atools::geo::EMPTY_POS;
 }
 
-QRegularExpressionMatch safeMatch(const QRegularExpression& regexp, const QString& str)
-{
-  if(!regexp.isValid())
-    throw atools::Exception("Invalid regular expression: " + regexp.errorString() + " at " +
-                            QString::number(regexp.patternErrorOffset()));
-  else
-    return regexp.match(str);
-}
+namespace {
 
-QString safeCaptured(const QRegularExpressionMatch& match, const QString& str)
+/* Token types for the coordinate scanner in fromAnyFormatInternal() */
+enum CoordTokenType : quint8
 {
-  QString retval = match.captured(str);
-  if(retval.isNull())
-    throw atools::Exception("Match not found: " + str + " in " + match.regularExpression().pattern() +
-                            ". Match groups: " + match.regularExpression().namedCaptureGroups().join(", "));
-  return retval;
-}
-
-atools::geo::Pos degMinSecFromMatch(const QRegularExpressionMatch& match)
+  TOKEN_NUMBER, /* Run of digits and dots */
+  TOKEN_SIGN, /* + or - */
+  TOKEN_NS, /* N or S */
+  TOKEN_EW, /* E or W */
+  TOKEN_DEG, /* ° or * */
+  TOKEN_MIN, /* ' */
+  TOKEN_SEC, /* " */
+  TOKEN_COMMA,
+  TOKEN_SPACE, /* Always single since string is simplified */
+  TOKEN_SEPARATOR /* / or # */
+};
+
+struct CoordToken
 {
-  QString ns = safeCaptured(match, "NS");
-  int latYDeg = safeCaptured(match, "LATY_DEG").toInt();
-  int latYMin = safeCaptured(match, "LATY_MIN").toInt();
-  float latYSec = safeCaptured(match, "LATY_DEC_SEC").toFloat();
-
-  QString ew = safeCaptured(match, "EW");
-  int lonXDeg = safeCaptured(match, "LONX_DEG").toInt();
-  int lonXMin = safeCaptured(match, "LONX_MIN").toInt();
-  float lonXSec = safeCaptured(match, "LONX_DEC_SEC").toFloat();
-
-  float latY = (latYDeg + latYMin / 60.f + latYSec / 3600.f) * (ns == "S" ? -1.f : 1.f);
-  float lonX = (lonXDeg + lonXMin / 60.f + lonXSec / 3600.f) * (ew == "W" ? -1.f : 1.f);
-  return Pos(lonX, latY);
-}
-
-atools::geo::Pos degMinDesignatorFromMatch(const QRegularExpressionMatch& match)
+  CoordTokenType type;
+  bool dot; /* Number contains a dot */
+  int start, length;
+};
+
+/*
+ * Splits a simplified and upper case coordinate string into tokens in one pass and allows to match the
+ * token sequence against the formats in fromAnyFormatInternal().
+ * Numbers are always scanned greedy which is the same as the previously used regular expressions
+ * since no format has a digit or dot following a number.
+ */
+class CoordScanner
 {
-  QString ns = safeCaptured(match, "NS");
-  int latYDeg = safeCaptured(match, "LATY_DEG").toInt();
-  float latYMin = safeCaptured(match, "LATY_DEC_MIN").toFloat();
+public:
+  /* Returns false if an unknown character was found which means that no format can match */
+  bool tokenize(const QString& str)
+  {
+    string = &str;
+    tokens.clear();
+    index = 0;
 
-  QString ew = safeCaptured(match, "EW");
-  int lonXDeg = safeCaptured(match, "LONX_DEG").toInt();
-  float lonXMin = safeCaptured(match, "LONX_DEC_MIN").toFloat();
+    const QChar *data = str.constData();
+    int size = str.size();
+    for(int i = 0; i < size; i++)
+    {
+      char16_t c = data[i].unicode();
 
-  float latY = (latYDeg + latYMin / 60.f) * (ns == "S" ? -1.f : 1.f);
-  float lonX = (lonXDeg + lonXMin / 60.f) * (ew == "W" ? -1.f : 1.f);
-  return Pos(lonX, latY);
-}
+      if((c >= '0' && c <= '9') || c == '.')
+      {
+        int start = i;
+        bool dot = false;
+        while(i < size && ((data[i].unicode() >= '0' && data[i].unicode() <= '9') || data[i].unicode() == '.'))
+        {
+          dot |= data[i].unicode() == '.';
+          i++;
+        }
+        tokens.append({TOKEN_NUMBER, dot, start, i - start});
+        i--;
+        continue;
+      }
 
-atools::geo::Pos degMinFromMatchGoogle(const QRegularExpressionMatch& match)
-{
-  bool latNegative = safeCaptured(match, "LATY_DEG_SIGN") == "-";
-  int latYDeg = std::abs(safeCaptured(match, "LATY_DEG").toInt());
-  float latYMin = std::abs(safeCaptured(match, "LATY_DEC_MIN").toFloat());
+      CoordTokenType type;
+      if(c == '+' || c == '-')
+        type = TOKEN_SIGN;
+      else if(c == 'N' || c == 'S')
+        type = TOKEN_NS;
+      else if(c == 'E' || c == 'W')
+        type = TOKEN_EW;
+      else if(c == 0x00B0 || c == '*')
+        type = TOKEN_DEG;
+      else if(c == '\'')
+        type = TOKEN_MIN;
+      else if(c == '"')
+        type = TOKEN_SEC;
+      else if(c == ',')
+        type = TOKEN_COMMA;
+      else if(c == ' ')
+        type = TOKEN_SPACE;
+      else if(c == '/' || c == '#')
+        type = TOKEN_SEPARATOR;
+      else
+        return false;
+
+      tokens.append({type, false, i, 1});
+    }
+    return true;
+  }
 
-  bool lonNegative = safeCaptured(match, "LONX_DEG_SIGN") == "-";
-  int lonXDeg = std::abs(safeCaptured(match, "LONX_DEG").toInt());
-  float lonXMin = std::abs(safeCaptured(match, "LONX_DEC_MIN").toFloat());
+  /* Start matching at the first token again */
+  void reset()
+  {
+    index = 0;
+  }
 
-  float latY = (latNegative ? -1.f : 1.f) * (latYDeg + latYMin / 60.f);
-  float lonX = (lonNegative ? -1.f : 1.f) * (lonXDeg + lonXMin / 60.f);
-  return Pos(lonX, latY);
-}
+  bool atEnd() const
+  {
+    return index == tokens.size();
+  }
 
-atools::geo::Pos degFromMatchSigned(const QRegularExpressionMatch& match)
-{
-  bool ok;
-  float latYDeg = safeCaptured(match, "LATY_DEC_DEG_SIGN").toFloat(&ok);
-  if(!ok)
-    return atools::geo::EMPTY_POS;
+  /* Consume token if it has the given type */
+  bool accept(CoordTokenType type)
+  {
+    if(index < tokens.size() && tokens.at(index).type == type)
+    {
+      index++;
+      return true;
+    }
+    return false;
+  }
 
-  float lonXDeg = safeCaptured(match, "LONX_DEC_DEG_SIGN").toFloat(&ok);
-  if(!ok)
-    return atools::geo::EMPTY_POS;
+  /* Consume optional space. Always returns true. */
+  bool skipSpace()
+  {
+    accept(TOKEN_SPACE);
+    return true;
+  }
 
-  return Pos(lonXDeg, latYDeg);
-}
+  /* Designator N/S or E/W followed by an optional space. negative is true for S and W. */
+  bool hemisphere(CoordTokenType type, bool& negative)
+  {
+    if(index < tokens.size() && tokens.at(index).type == type)
+    {
+      QChar c = string->at(tokens.at(index).start);
+      negative = c == QChar('S') || c == QChar('W');
+      index++;
+      accept(TOKEN_SPACE);
+      return true;
+    }
+    return false;
+  }
 
-atools::geo::Pos degFromMatch(const QRegularExpressionMatch& match)
-{
-  float latYDeg = safeCaptured(match, "LATY_DEC_DEG").toFloat();
-  QString ns = safeCaptured(match, "NS");
+  /* Unsigned number. Rejects numbers containing a dot if decimal is false. */
+  bool number(bool decimal, QString& value)
+  {
+    if(index < tokens.size())
+    {
+      const CoordToken& token = tokens.at(index);
+      if(token.type == TOKEN_NUMBER && (decimal || !token.dot))
+      {
+        value = string->mid(token.start, token.length);
+        index++;
+        return true;
+      }
+    }
+    return false;
+  }
 
-  float lonXDeg = safeCaptured(match, "LONX_DEC_DEG").toFloat();
-  QString ew = safeCaptured(match, "EW");
+  /* Number with optional leading sign. value includes the sign. */
+  bool signedNumber(bool decimal, QString& value)
+  {
+    int oldIndex = index;
+    bool sign = accept(TOKEN_SIGN);
 
-  float latY = latYDeg * (ns == "S" ? -1.f : 1.f);
-  float lonX = lonXDeg * (ew == "W" ? -1.f : 1.f);
-  return Pos(lonX, latY);
-}
+    if(number(decimal, value))
+    {
+      if(sign)
+        value.prepend(string->at(tokens.at(oldIndex).start));
+      return true;
+    }
+
+    index = oldIndex;
+    return false;
+  }
+
+  /* Degree, minute or second sign with optional space before and after.
+   * A single space is accepted instead of the sign if required is true.
+   * Everything is optional if required is false. */
+  bool separator(CoordTokenType sign, bool required)
+  {
+    bool space = accept(TOKEN_SPACE);
+    if(accept(sign))
+    {
+      accept(TOKEN_SPACE);
+      return true;
+    }
+    return space || !required;
+  }
+
+  /* One or more spaces, slashes or hashes between signed numbers */
+  bool numberSeparators()
+  {
+    bool found = false;
+    while(accept(TOKEN_SPACE) || accept(TOKEN_SEPARATOR))
+      found = true;
+    return found;
+  }
+
+private:
+  const QString *string = nullptr;
+  QVarLengthArray<CoordToken, 32> tokens;
+  int index = 0;
+};
+
+} // namespace
 
 geo::Pos fromAnyFormatInternal(const QString& coords, bool replaceDecimals, bool *hemisphere)
 {
@@ -563,123 +615,47 @@ geo::Pos fromAnyFormatInternal(const QString& coords, bool replaceDecimals, bool
 
   coordStr = coordStr.simplified();
 
-  // North/south and east/west designator
-  const static QLatin1String NS("(?<NS>[NS])");
-  const static QLatin1String EW("(?<EW>[EW])");
-
-  // Optional n-space
-  const static QLatin1String SP("\\s*"); // Optional space
-  const static QLatin1String SPREQ("\\s+"); // Required at least one space
-  const static QLatin1String COMMA(",");
-
-  // Degree, minute and seconds signs or space
-  const static QString DEG("[ °\\*]");
-  const static QLatin1String MIN("[ ']");
-  const static QLatin1String SEC("[ \"]");
-
-  // Degree, minute and seconds signs
-  const static QString DEGEND("[°\\*]?");
-  const static QLatin1String MINEND("[']?");
-  const static QLatin1String SECEND("[\"]?");
-
-  // Integer degree with named capture
-  const static QLatin1String LONX_DEG("(?<LONX_DEG>[0-9]+)");
-  const static QLatin1String LATY_DEG("(?<LATY_DEG>[0-9]+)");
-
-  // Integer degree with named capture and sign
-  const static QLatin1String LONX_DEG_SIGN("(?<LONX_DEG_SIGN>[+-]?)(?<LONX_DEG>[0-9]+)");
-  const static QLatin1String LATY_DEG_SIGN("(?<LATY_DEG_SIGN>[+-]?)(?<LATY_DEG>[0-9]+)");
-
-  // Decimal degree
-  const static QLatin1String LONX_DEC_DEG("(?<LONX_DEC_DEG>[0-9\\.]+)");
-  const static QLatin1String LATY_DEC_DEG("(?<LATY_DEC_DEG>[0-9\\.]+)");
-
-  // Decimal degree with sign
-  const static QLatin1String LONX_DEC_DEG_SIGN("(?<LONX_DEC_DEG_SIGN>[+-]?[0-9\\.]+)");
-  const static QLatin1String LATY_DEC_DEG_SIGN("(?<LATY_DEC_DEG_SIGN>[+-]?[0-9\\.]+)");
-
-  // Minutes
-  const static QLatin1String LONX_MIN("(?<LONX_MIN>[0-9]+)");
-  const static QLatin1String LATY_MIN("(?<LATY_MIN>[0-9]+)");
-
-  // Decimal minutes
-  const static QLatin1String LONX_DEC_MIN("(?<LONX_DEC_MIN>[0-9\\.]+)");
-  const static QLatin1String LATY_DEC_MIN("(?<LATY_DEC_MIN>[0-9\\.]+)");
-
-  // Decimal seconds
-  const static QLatin1String LONX_DEC_SEC("(?<LONX_DEC_SEC>[0-9\\.]+)");
-  const static QLatin1String LATY_DEC_SEC("(?<LATY_DEC_SEC>[0-9\\.]+)");
-
-  // ================================================================================
-  // Build regular expressions
-
-  // N49° 26' 41.57" E9° 12' 5.49"
-  static const QRegularExpression FORMAT_DEG_MIN_SEC_REGEXP(
-    "^" + NS + SP + LATY_DEG + SP + DEG + SP + LATY_MIN + SP + MIN + SP + LATY_DEC_SEC + SP + SEC + SP +
-    "" + EW + SP + LONX_DEG + SP + DEG + SP + LONX_MIN + SP + MIN + SP + LONX_DEC_SEC + SP + SECEND + "$");
-
-  // 49° 26' 41,57" N 9° 12' 5,49" E
-  static const QRegularExpression FORMAT_DEG_MIN_SEC_REGEXP2(
-    "^" + LATY_DEG + SP + DEG + SP + LATY_MIN + SP + MIN + SP + LATY_DEC_SEC + SP + SECEND + SP + NS + SP +
-    "" + LONX_DEG + SP + DEG + SP + LONX_MIN + SP + MIN + SP + LONX_DEC_SEC + SP + SECEND + SP + EW + "$");
-
-  // 49° 26,69' N 9° 12,09' E
-  static const QRegularExpression FORMAT_DEG_MIN_REGEXP2(
-    "^" + LATY_DEG + SP + DEG + SP + LATY_DEC_MIN + SP + MIN + SP + NS + SP +
-    "" + LONX_DEG + SP + DEG + SP + LONX_DEC_MIN + SP + MIN + SP + EW + "$");
-
-  // N54* 16.82' W008* 35.95'
-  static const QRegularExpression FORMAT_DEG_MIN_REGEXP(
-    "^" + NS + SP + LATY_DEG + SP + DEG + SP + LATY_DEC_MIN + SP + MIN + SP +
-    "" + EW + SP + LONX_DEG + SP + DEG + SP + LONX_DEC_MIN + SP + MINEND + SP + "$");
-
-  // 49,4449° N 9,2015° E
-  static const QRegularExpression FORMAT_DEG_REGEXP(
-    "^" + LATY_DEC_DEG + SP + DEGEND + SP + NS + SP +
-    "" + LONX_DEC_DEG + SP + DEGEND + SP + EW + "$");
-
-  // N 49,4449° E 9,2015°
-  static const QRegularExpression FORMAT_DEG_REGEXP2(
-    "^" + NS + SP + LATY_DEC_DEG + SP + DEG + SP +
-    "" + EW + SP + LONX_DEC_DEG + SP + DEGEND + "$");
+  CoordScanner scanner;
+  if(!scanner.tokenize(coordStr))
+    // Contains characters not used in any of the formats below
+    return fromAnyWaypointFormat(coordStr);
 
-  // Signed Lat lon or lon lat
-  static const QRegularExpression FORMAT_NUMBER_SIGNED(
-    "^" + LATY_DEC_DEG_SIGN + "[\\s\\|_/#;:]+" + LONX_DEC_DEG_SIGN + "$");
-
-  // Google format -120 19.70, 46 42.88
-  static const QRegularExpression FORMAT_NUMBER_GOOGLE(
-    "^" + LATY_DEG_SIGN + SPREQ + LATY_DEC_MIN + SP + COMMA + SP + LONX_DEG_SIGN + SPREQ + LONX_DEC_MIN + "$");
+  QString latYDeg, latYMin, latYSec, lonXDeg, lonXMin, lonXSec;
+  bool south = false, west = false;
 
   // ================================================================================
   // Decimal degree formats
   // 49,4449 -9,2015
-  QRegularExpressionMatch match = safeMatch(FORMAT_NUMBER_SIGNED, coordStr);
-  if(match.hasMatch())
+  if(scanner.signedNumber(true, latYDeg) && scanner.numberSeparators() && scanner.signedNumber(true, lonXDeg) &&
+     scanner.atEnd())
   {
-    Pos pos = degFromMatchSigned(match);
-
     if(hemisphere != nullptr)
       *hemisphere = false; // caller probably has to swap lat/lon
 
-    if(pos.isValid()) // Do not check range since lat/lon might be swapped
+    bool latOk, lonOk;
+    Pos pos(lonXDeg.toFloat(&lonOk), latYDeg.toFloat(&latOk));
+    if(latOk && lonOk && pos.isValid()) // Do not check range since lat/lon might be swapped
       return pos;
   }
 
   // 49,4449° N 9,2015° E
-  match = safeMatch(FORMAT_DEG_REGEXP, coordStr);
-  if(match.hasMatch())
+  scanner.reset();
+  if(scanner.number(true, latYDeg) && scanner.separator(TOKEN_DEG, false) && scanner.hemisphere(TOKEN_NS, south) &&
+     scanner.number(true, lonXDeg) && scanner.separator(TOKEN_DEG, false) && scanner.hemisphere(TOKEN_EW, west) &&
+     scanner.atEnd())
   {
-    Pos pos = degFromMatch(match);
+    Pos pos(lonXDeg.toFloat() * (west ? -1.f : 1.f), latYDeg.toFloat() * (south ? -1.f : 1.f));
     if(pos.isValidRange())
       return pos;
   }
 
   // N 49,4449° E 9,2015°
-  match = safeMatch(FORMAT_DEG_REGEXP2, coordStr);
-  if(match.hasMatch())
+  scanner.reset();
+  if(scanner.hemisphere(TOKEN_NS, south) && scanner.number(true, latYDeg) && scanner.separator(TOKEN_DEG, true) &&
+     scanner.hemisphere(TOKEN_EW, west) && scanner.number(true, lonXDeg) && scanner.separator(TOKEN_DEG, false) &&
+     scanner.atEnd())
   {
-    Pos pos = degFromMatch(match);
+    Pos pos(lonXDeg.toFloat() * (west ? -1.f : 1.f), latYDeg.toFloat() * (south ? -1.f : 1.f));
     if(pos.isValidRange())
       return pos;
   }
@@ -687,28 +663,48 @@ geo::Pos fromAnyFormatInternal(const QString& coords, bool replaceDecimals, bool
   // ================================================================================
   // Degree and decimal minute formats
   // N54* 16.82' W008* 35.95'
-  match = safeMatch(FORMAT_DEG_MIN_REGEXP, coordStr);
-  if(match.hasMatch())
+  scanner.reset();
+  if(scanner.hemisphere(TOKEN_NS, south) &&
+     scanner.number(false, latYDeg) && scanner.separator(TOKEN_DEG, true) &&
+     scanner.number(true, latYMin) && scanner.separator(TOKEN_MIN, true) &&
+     scanner.hemisphere(TOKEN_EW, west) &&
+     scanner.number(false, lonXDeg) && scanner.separator(TOKEN_DEG, true) &&
+     scanner.number(true, lonXMin) && scanner.separator(TOKEN_MIN, false) &&
+     scanner.atEnd())
   {
-    Pos pos = degMinDesignatorFromMatch(match);
+    Pos pos((lonXDeg.toInt() + lonXMin.toFloat() / 60.f) * (west ? -1.f : 1.f),
+            (latYDeg.toInt() + latYMin.toFloat() / 60.f) * (south ? -1.f : 1.f));
     if(pos.isValidRange())
       return pos;
   }
 
   // 49° 26,69' N 9° 12,09' E
-  match = safeMatch(FORMAT_DEG_MIN_REGEXP2, coordStr);
-  if(match.hasMatch())
+  scanner.reset();
+  if(scanner.number(false, latYDeg) && scanner.separator(TOKEN_DEG, true) &&
+     scanner.number(true, latYMin) && scanner.separator(TOKEN_MIN, true) &&
+     scanner.hemisphere(TOKEN_NS, south) &&
+     scanner.number(false, lonXDeg) && scanner.separator(TOKEN_DEG, true) &&
+     scanner.number(true, lonXMin) && scanner.separator(TOKEN_MIN, true) &&
+     scanner.hemisphere(TOKEN_EW, west) &&
+     scanner.atEnd())
   {
-    Pos pos = degMinDesignatorFromMatch(match);
+    Pos pos((lonXDeg.toInt() + lonXMin.toFloat() / 60.f) * (west ? -1.f : 1.f),
+            (latYDeg.toInt() + latYMin.toFloat() / 60.f) * (south ? -1.f : 1.f));
     if(pos.isValidRange())
       return pos;
   }
 
-  // -120 19.70, 46 42.88
-  match = safeMatch(FORMAT_NUMBER_GOOGLE, coordStr);
-  if(match.hasMatch())
+  // Google format -120 19.70, 46 42.88
+  scanner.reset();
+  if(scanner.signedNumber(false, latYDeg) && scanner.accept(TOKEN_SPACE) && scanner.number(true, latYMin) &&
+     scanner.skipSpace() && scanner.accept(TOKEN_COMMA) && scanner.skipSpace() &&
+     scanner.signedNumber(false, lonXDeg) && scanner.accept(TOKEN_SPACE) && scanner.number(true, lonXMin) &&
+     scanner.atEnd())
   {
-    Pos pos = degMinFromMatchGoogle(match);
+    bool latNegative = latYDeg.startsWith('-');
+    bool lonNegative = lonXDeg.startsWith('-');
+    Pos pos((lonNegative ? -1.f : 1.f) * (std::abs(lonXDeg.toInt()) + std::abs(lonXMin.toFloat()) / 60.f),
+            (latNegative ? -1.f : 1.f) * (std::abs(latYDeg.toInt()) + std::abs(latYMin.toFloat()) / 60.f));
     if(pos.isValidRange())
       return pos;
   }
@@ -716,19 +712,37 @@ geo::Pos fromAnyFormatInternal(const QString& coords, bool replaceDecimals, bool
   // ================================================================================
   // Degree, minute and second formats
   // N49° 26' 41.57" E9° 12' 5.49"
-  match = safeMatch(FORMAT_DEG_MIN_SEC_REGEXP, coordStr);
-  if(match.hasMatch())
+  scanner.reset();
+  if(scanner.hemisphere(TOKEN_NS, south) &&
+     scanner.number(false, latYDeg) && scanner.separator(TOKEN_DEG, true) &&
+     scanner.number(false, latYMin) && scanner.separator(TOKEN_MIN, true) &&
+     scanner.number(true, latYSec) && scanner.separator(TOKEN_SEC, true) &&
+     scanner.hemisphere(TOKEN_EW, west) &&
+     scanner.number(false, lonXDeg) && scanner.separator(TOKEN_DEG, true) &&
+     scanner.number(false, lonXMin) && scanner.separator(TOKEN_MIN, true) &&
+     scanner.number(true, lonXSec) && scanner.separator(TOKEN_SEC, false) &&
+     scanner.atEnd())
   {
-    Pos pos = degMinSecFromMatch(match);
+    Pos pos((lonXDeg.toInt() + lonXMin.toInt() / 60.f + lonXSec.toFloat() / 3600.f) * (west ? -1.f : 1.f),
+            (latYDeg.toInt() + latYMin.toInt() / 60.f + latYSec.toFloat() / 3600.f) * (south ? -1.f : 1.f));
     if(pos.isValidRange())
       return pos;
   }
 
   // 49° 26' 41,57" N 9° 12' 5,49" E
-  match = safeMatch(FORMAT_DEG_MIN_SEC_REGEXP2, coordStr);
-  if(match.hasMatch())
+  scanner.reset();
+  if(scanner.number(false, latYDeg) && scanner.separator(TOKEN_DEG, true) &&
+     scanner.number(false, latYMin) && scanner.separator(TOKEN_MIN, true) &&
+     scanner.number(true, latYSec) && scanner.separator(TOKEN_SEC, false) &&
+     scanner.hemisphere(TOKEN_NS, south) &&
+     scanner.number(false, lonXDeg) && scanner.separator(TOKEN_DEG, true) &&
+     scanner.number(false, lonXMin) && scanner.separator(TOKEN_MIN, true) &&
+     scanner.number(true, lonXSec) && scanner.separator(TOKEN_SEC, false) &&
+     scanner.hemisphere(TOKEN_EW, west) &&
+     scanner.atEnd())
   {
-    Pos pos = degMinSecFromMatch(match);
+    Pos pos((lonXDeg.toInt() + lonXMin.toInt() / 60.f + lonXSec.toFloat() / 3600.f) * (west ? -1.f : 1.f),
+            (latYDeg.toInt() + latYMin.toInt() / 60.f + latYSec.toFloat() / 3600.f) * (south ? -1.f : 1.f));
     if(pos.isValidRange())
       return pos;
   }
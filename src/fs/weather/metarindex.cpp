@@ -546,13 +546,13 @@ const atools::fs::weather::Metar& MetarIndex::getMetar(const QString& station, a
         }
 
         // Interpolate all nearest ======================
-        QVector<PosIndex> posIndexes;
+        QVector<const PosIndex *> posIndexes;
         spatialIndex->getNearest(posIndexes, pos, numInterpolation);
 
         // Collect positions ====================
         atools::fs::weather::MetarPtrVector metars;
-        for(const PosIndex& posIndex : qAsConst(posIndexes))
-          metars.append(&metarVector.at(posIndex.index));
+        for(const PosIndex *posIndex : qAsConst(posIndexes))
+          metars.append(&metarVector.at(posIndex->index));
 
         // Sort by distance to request point ====================
         std::sort(metars.begin(), metars.end(), [&pos](const Metar *t1, const Metar *t2) -> bool {
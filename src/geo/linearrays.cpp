@@ -0,0 +1,376 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "geo/linearrays.h"
+
+#include "geo/calculations.h"
+#include "geo/linestring.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace atools {
+namespace geo {
+
+/* Radius in meter as used by Pos */
+static const double RADIUS = Pos::EARTH_RADIUS_METER_DOUBLE;
+static const double DEG_TO_RAD = M_PI / 180.;
+static const double RAD_TO_DEG = 180. / M_PI;
+
+/* Angle in radians from chord length on the unit sphere */
+inline double chordToRad(double chord)
+{
+  return 2. * std::asin(std::min(1., chord * 0.5));
+}
+
+LineArrays::LineArrays(const LineString& line)
+{
+  set(line);
+}
+
+LineArrays::LineArrays(const float *lonx, const float *laty, int size)
+{
+  set(lonx, laty, size);
+}
+
+void LineArrays::clear()
+{
+  lonX.clear();
+  latY.clear();
+  sinLonX.clear();
+  cosLonX.clear();
+  sinLatY.clear();
+  cosLatY.clear();
+}
+
+void LineArrays::set(const LineString& line)
+{
+  QVector<float> lon(line.size()), lat(line.size());
+  for(int i = 0; i < line.size(); i++)
+  {
+    lon[i] = line.at(i).getLonX();
+    lat[i] = line.at(i).getLatY();
+  }
+  set(lon.constData(), lat.constData(), lon.size());
+}
+
+void LineArrays::set(const float *lonx, const float *laty, int size)
+{
+  lonX.resize(size);
+  latY.resize(size);
+  sinLonX.resize(size);
+  cosLonX.resize(size);
+  sinLatY.resize(size);
+  cosLatY.resize(size);
+
+  float *lonPtr = lonX.data(), *latPtr = latY.data();
+  double *sinLonPtr = sinLonX.data(), *cosLonPtr = cosLonX.data(), *sinLatPtr = sinLatY.data(),
+         *cosLatPtr = cosLatY.data();
+
+  for(int i = 0; i < size; i++)
+  {
+    lonPtr[i] = lonx[i];
+    latPtr[i] = laty[i];
+  }
+
+  // Separate loops without aliasing to allow vectorization
+  for(int i = 0; i < size; i++)
+  {
+    double lonRad = lonPtr[i] * DEG_TO_RAD, latRad = latPtr[i] * DEG_TO_RAD;
+    sinLonPtr[i] = std::sin(lonRad);
+    cosLonPtr[i] = std::cos(lonRad);
+    sinLatPtr[i] = std::sin(latRad);
+    cosLatPtr[i] = std::cos(latRad);
+  }
+}
+
+float LineArrays::lengthMeter() const
+{
+  const double *sinLon = sinLonX.constData(), *cosLon = cosLonX.constData(),
+               *sinLat = sinLatY.constData(), *cosLat = cosLatY.constData();
+
+  // Sum up in double to avoid accumulating rounding errors for long strings
+  double length = 0.;
+  for(int i = 0; i < size() - 1; i++)
+  {
+    double dx = cosLat[i + 1] * cosLon[i + 1] - cosLat[i] * cosLon[i];
+    double dy = cosLat[i + 1] * sinLon[i + 1] - cosLat[i] * sinLon[i];
+    double dz = sinLat[i + 1] - sinLat[i];
+    length += chordToRad(std::sqrt(dx * dx + dy * dy + dz * dz));
+  }
+  return static_cast<float>(length * Pos::EARTH_RADIUS_METER_DOUBLE);
+}
+
+void LineArrays::segmentDistancesMeter(QVector<float>& distances) const
+{
+  distances.resize(std::max(size() - 1, 0));
+  float *dist = distances.data();
+  const double *sinLon = sinLonX.constData(), *cosLon = cosLonX.constData(),
+               *sinLat = sinLatY.constData(), *cosLat = cosLatY.constData();
+
+  for(int i = 0; i < size() - 1; i++)
+  {
+    double dx = cosLat[i + 1] * cosLon[i + 1] - cosLat[i] * cosLon[i];
+    double dy = cosLat[i + 1] * sinLon[i + 1] - cosLat[i] * sinLon[i];
+    double dz = sinLat[i + 1] - sinLat[i];
+    dist[i] = static_cast<float>(chordToRad(std::sqrt(dx * dx + dy * dy + dz * dz)) * RADIUS);
+  }
+}
+
+void LineArrays::cumulativeDistancesMeter(QVector<float>& distances) const
+{
+  QVector<float> segments;
+  segmentDistancesMeter(segments);
+
+  distances.resize(size());
+  if(!distances.isEmpty())
+  {
+    double total = 0.;
+    distances[0] = 0.f;
+    for(int i = 0; i < segments.size(); i++)
+    {
+      total += segments.at(i);
+      distances[i + 1] = static_cast<float>(total);
+    }
+  }
+}
+
+void LineArrays::segmentCoursesDeg(QVector<float>& courses) const
+{
+  courses.resize(std::max(size() - 1, 0));
+  float *course = courses.data();
+  const double *sinLon = sinLonX.constData(), *cosLon = cosLonX.constData(),
+               *sinLat = sinLatY.constData(), *cosLat = cosLatY.constData();
+
+  for(int i = 0; i < size() - 1; i++)
+  {
+    // Same as Pos::courseRad() using sin(a - b) and cos(a - b) expansions to avoid trigonometric functions
+    double sinDLon = sinLon[i + 1] * cosLon[i] - cosLon[i + 1] * sinLon[i];
+    double cosDLon = cosLon[i + 1] * cosLon[i] + sinLon[i + 1] * sinLon[i];
+    double yVal = sinDLon * cosLat[i + 1];
+    double xVal = cosLat[i] * sinLat[i + 1] - sinLat[i] * cosLat[i + 1] * cosDLon;
+
+    if(lonX.at(i) == lonX.at(i + 1) && latY.at(i) == latY.at(i + 1))
+      course[i] = Pos::INVALID_VALUE;
+    else
+    {
+      double deg = std::atan2(yVal, xVal) * RAD_TO_DEG;
+      course[i] = static_cast<float>(deg < 0. ? deg + 360. : deg);
+    }
+  }
+}
+
+double LineArrays::distanceRad(int i, double px, double py, double pz) const
+{
+  double dx = x(i) - px, dy = y(i) - py, dz = z(i) - pz;
+  return chordToRad(std::sqrt(dx * dx + dy * dy + dz * dz));
+}
+
+int LineArrays::nearestSegment(const Pos& pos, LineDistance& result) const
+{
+  result.status = INVALID;
+  result.distance = result.distanceFrom1 = result.distanceFrom2 = std::numeric_limits<float>::max();
+
+  if(size() < 2 || !pos.isValid())
+    return -1;
+
+  double lonRad = pos.getLonX() * DEG_TO_RAD, latRad = pos.getLatY() * DEG_TO_RAD;
+  double px = std::cos(latRad) * std::cos(lonRad), py = std::cos(latRad) * std::sin(lonRad), pz = std::sin(latRad);
+
+  int closestIndex = -1;
+  double closestDist = std::numeric_limits<double>::max(), closestAlong = 0.;
+  CrossTrackStatus closestStatus = INVALID;
+
+  for(int i = 0; i < size() - 1; i++)
+  {
+    double ax = x(i), ay = y(i), az = z(i), bx = x(i + 1), by = y(i + 1), bz = z(i + 1);
+
+    // Normal of the great circle plane - length is sine of segment angle
+    double nx = ay * bz - az * by, ny = az * bx - ax * bz, nz = ax * by - ay * bx;
+    double nlen = std::sqrt(nx * nx + ny * ny + nz * nz);
+
+    double dist, along;
+    CrossTrackStatus status;
+    if(nlen < 1.e-12)
+    {
+      // Zero length segment
+      status = ALONG_TRACK;
+      dist = distanceRad(i, px, py, pz);
+      along = 0.;
+    }
+    else
+    {
+      nx /= nlen;
+      ny /= nlen;
+      nz /= nlen;
+
+      // Components of A x P and P x B along the normal tell if projection of P is between A and B
+      double axp = (ay * pz - az * py) * nx + (az * px - ax * pz) * ny + (ax * py - ay * px) * nz;
+      double pxb = (py * bz - pz * by) * nx + (pz * bx - px * bz) * ny + (px * by - py * bx) * nz;
+
+      // Angle from A to projection of P on the great circle
+      along = std::atan2(axp, ax * px + ay * py + az * pz);
+
+      if(axp >= 0. && pxb >= 0.)
+      {
+        // Positive cross track means right of course which is opposite to the normal
+        status = ALONG_TRACK;
+        dist = -std::asin(std::max(-1., std::min(1., px * nx + py * ny + pz * nz)));
+      }
+      else
+      {
+        double distFrom1 = distanceRad(i, px, py, pz), distFrom2 = distanceRad(i + 1, px, py, pz);
+        status = distFrom1 < distFrom2 ? BEFORE_START : AFTER_END;
+        dist = std::min(distFrom1, distFrom2);
+      }
+    }
+
+    if(std::abs(dist) < std::abs(closestDist))
+    {
+      closestDist = dist;
+      closestAlong = std::abs(along);
+      closestStatus = status;
+      closestIndex = i;
+    }
+  }
+
+  if(closestIndex != -1)
+  {
+    // Same status handling as in LineString::distanceMeterToLineString()
+    if(closestIndex == 0)
+    {
+      if(closestStatus != BEFORE_START)
+        closestStatus = ALONG_TRACK;
+    }
+    else if(closestIndex == size() - 2)
+    {
+      if(closestStatus != AFTER_END)
+        closestStatus = ALONG_TRACK;
+    }
+    else
+      closestStatus = ALONG_TRACK;
+
+    double distFrom1 = 0.;
+    for(int i = 0; i < closestIndex; i++)
+      distFrom1 += distanceRad(i, x(i + 1), y(i + 1), z(i + 1));
+    distFrom1 += closestAlong;
+
+    result.status = closestStatus;
+    result.distance = static_cast<float>(closestDist * RADIUS);
+    result.distanceFrom1 = static_cast<float>(distFrom1 * Pos::EARTH_RADIUS_METER_DOUBLE);
+    result.distanceFrom2 = lengthMeter() - result.distanceFrom1;
+  }
+  return closestIndex;
+}
+
+void LineArrays::slerp(int i, double distRad, double fraction, float& lonxResult, float& latyResult) const
+{
+  double sinDist = std::sin(distRad);
+  double xVal, yVal, zVal;
+  if(sinDist < 1.e-12)
+  {
+    xVal = x(i);
+    yVal = y(i);
+    zVal = z(i);
+  }
+  else
+  {
+    double a = std::sin((1. - fraction) * distRad) / sinDist;
+    double b = std::sin(fraction * distRad) / sinDist;
+    xVal = a * x(i) + b * x(i + 1);
+    yVal = a * y(i) + b * y(i + 1);
+    zVal = a * z(i) + b * z(i + 1);
+  }
+  latyResult = static_cast<float>(std::atan2(zVal, std::sqrt(xVal * xVal + yVal * yVal)) * RAD_TO_DEG);
+  lonxResult = static_cast<float>(std::atan2(yVal, xVal) * RAD_TO_DEG);
+}
+
+void LineArrays::interpolate(const float *fractions, int numFractions, float *lonxResult, float *latyResult) const
+{
+  if(isEmpty())
+    return;
+
+  // Cumulative angles in double to keep precision for long lines
+  QVector<double> cumulative(size());
+  cumulative[0] = 0.;
+  for(int i = 0; i < size() - 1; i++)
+    cumulative[i + 1] = cumulative.at(i) + distanceRad(i, x(i + 1), y(i + 1), z(i + 1));
+  double total = cumulative.constLast();
+
+  for(int j = 0; j < numFractions; j++)
+  {
+    float fraction = std::max(0.f, std::min(1.f, fractions[j]));
+
+    if(size() == 1 || fraction <= 0.f || total <= 0.)
+    {
+      lonxResult[j] = lonX.constFirst();
+      latyResult[j] = latY.constFirst();
+    }
+    else if(fraction >= 1.f)
+    {
+      lonxResult[j] = lonX.constLast();
+      latyResult[j] = latY.constLast();
+    }
+    else
+    {
+      // Find segment containing the distance
+      double dist = fraction * total;
+      int i = static_cast<int>(std::upper_bound(cumulative.constBegin(), cumulative.constEnd(), dist) -
+                               cumulative.constBegin()) - 1;
+      i = std::max(0, std::min(i, size() - 2));
+
+      // Segment angle directly from unit vectors instead of the difference of sums
+      double segRad = distanceRad(i, x(i + 1), y(i + 1), z(i + 1));
+      double segFraction = segRad > 0. ? std::min(1., (dist - cumulative.at(i)) / segRad) : 0.;
+      slerp(i, segRad, segFraction, lonxResult[j], latyResult[j]);
+    }
+  }
+}
+
+void LineArrays::interpolate(const QVector<float>& fractions, LineString& positions) const
+{
+  if(isEmpty())
+    return;
+
+  QVector<float> lon(fractions.size()), lat(fractions.size());
+  interpolate(fractions.constData(), fractions.size(), lon.data(), lat.data());
+
+  positions.reserve(positions.size() + fractions.size());
+  for(int i = 0; i < lon.size(); i++)
+    positions.append(Pos(lon.at(i), lat.at(i)));
+}
+
+void LineArrays::interpolatePoints(const Pos& pos1, const Pos& pos2, int numPoints, LineString& positions)
+{
+  if(!pos1.isValid() || !pos2.isValid() || pos1 == pos2 || numPoints <= 0)
+    return;
+
+  float lon[2] = {pos1.getLonX(), pos2.getLonX()}, lat[2] = {pos1.getLatY(), pos2.getLatY()};
+  LineArrays line(lon, lat, 2);
+  double distRad = line.distanceRad(0, line.x(1), line.y(1), line.z(1));
+
+  positions.reserve(positions.size() + numPoints);
+  float step = 1.f / numPoints, lonx, laty;
+  for(int j = 0; j < numPoints; j++)
+  {
+    line.slerp(0, distRad, step * static_cast<float>(j), lonx, laty);
+    positions.append(lonx, laty);
+  }
+}
+
+} // namespace geo
+} // namespace atools
@@ -0,0 +1,140 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef ATOOLS_GEO_LINEARRAYS_H
+#define ATOOLS_GEO_LINEARRAYS_H
+
+#include <QVector>
+
+namespace atools {
+namespace geo {
+
+class Pos;
+class LineString;
+struct LineDistance;
+
+/*
+ * Line string stored as structure of arrays for batch great circle calculations.
+ *
+ * Sine and cosine of all coordinates are calculated once on construction. Calculations use double
+ * and the cartesian unit vector shortcuts from Point3D which avoid the haversine formula. Loops work
+ * on plain arrays without Pos member calls and can be vectorized by the compiler. Results are float.
+ *
+ * Accuracy compared to the double precision scalar functions in Pos and LineString:
+ * Distances differ by less than one centimeter per segment plus the float rounding of the result.
+ * Courses differ by less than 0.0001 degree for segments longer than 100 meters.
+ *
+ * All positions have to be valid. Altitude is ignored.
+ */
+class LineArrays
+{
+public:
+  LineArrays()
+  {
+  }
+
+  explicit LineArrays(const atools::geo::LineString& line);
+  explicit LineArrays(const float *lonx, const float *laty, int size);
+
+  /* Replace all points */
+  void set(const atools::geo::LineString& line);
+  void set(const float *lonx, const float *laty, int size);
+
+  void clear();
+
+  int size() const
+  {
+    return lonX.size();
+  }
+
+  bool isEmpty() const
+  {
+    return lonX.isEmpty();
+  }
+
+  /* Coordinates in degree */
+  const QVector<float>& getLonX() const
+  {
+    return lonX;
+  }
+
+  const QVector<float>& getLatY() const
+  {
+    return latY;
+  }
+
+  /* Total length in meter. Compare with LineString::lengthMeter(). */
+  float lengthMeter() const;
+
+  /* Distance in meter for each segment i from point i to i + 1. Result has size() - 1 elements. */
+  void segmentDistancesMeter(QVector<float>& distances) const;
+
+  /* Distance from start in meter for each point. First element is 0 and result has size() elements. */
+  void cumulativeDistancesMeter(QVector<float>& distances) const;
+
+  /* Initial great circle course in degree true for each segment. Compare with Pos::angleDegTo().
+   * Result has size() - 1 elements. Course is Pos::INVALID_VALUE for zero length segments. */
+  void segmentCoursesDeg(QVector<float>& courses) const;
+
+  /* Find segment nearest to pos. Returns segment index i for Line(i, i + 1) or -1 if less than two points.
+   * Fills result like LineString::distanceMeterToLineString(). */
+  int nearestSegment(const atools::geo::Pos& pos, atools::geo::LineDistance& result) const;
+
+  /* Get positions for a list of fractions of the total length. Fractions are clamped to 0 <= fraction <= 1.
+   * Compare with LineString::interpolate(). */
+  void interpolate(const float *fractions, int numFractions, float *lonxResult, float *latyResult) const;
+  void interpolate(const QVector<float>& fractions, atools::geo::LineString& positions) const;
+
+  /* Same as Pos::interpolatePoints() without altitude. Adds numPoints positions from pos1 (inclusive)
+   * to pos2 (exclusive) at equal steps. */
+  static void interpolatePoints(const atools::geo::Pos& pos1, const atools::geo::Pos& pos2, int numPoints,
+                                atools::geo::LineString& positions);
+
+private:
+  /* Unit vector for point i */
+  double x(int i) const
+  {
+    return cosLatY.at(i) * cosLonX.at(i);
+  }
+
+  double y(int i) const
+  {
+    return cosLatY.at(i) * sinLonX.at(i);
+  }
+
+  double z(int i) const
+  {
+    return sinLatY.at(i);
+  }
+
+  /* Great circle distance in radians between point i and given unit vector */
+  double distanceRad(int i, double px, double py, double pz) const;
+
+  /* Spherical linear interpolation between points i and i + 1 having distance distRad */
+  void slerp(int i, double distRad, double fraction, float& lonxResult, float& latyResult) const;
+
+  QVector<float> lonX, latY;
+
+  /* Double is needed for the unit vectors since the chord of short segments is the difference of nearly
+   * equal values. Float loses up to a tenth of a degree in course for one kilometer segments. */
+  QVector<double> sinLonX, cosLonX, sinLatY, cosLatY;
+};
+
+} // namespace geo
+} // namespace atools
+
+#endif // ATOOLS_GEO_LINEARRAYS_H
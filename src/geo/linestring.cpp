@@ -423,6 +423,8 @@ QDataStream& operator>>(QDataStream& in, LineString& obj)
 {
   quint32 size;
   in >> size;
+  // Limit to avoid huge allocations for corrupted data
+  obj.reserve(obj.size() + static_cast<int>(std::min(size, 100000u)));
   for(quint32 i = 0; i < size; i++)
   {
     Pos p;
@@ -29,10 +29,13 @@ namespace geo {
 class Line;
 
 /*
- * List of geographic positions
+ * List of geographic positions.
+ *
+ * Positions are stored in one contiguous implicitly shared array. Copies share the array until modified.
+ * Note that QList in Qt 5 would allocate every position separately.
  */
 class LineString :
-  public QList<atools::geo::Pos>
+  public QVector<atools::geo::Pos>
 {
 public:
   LineString()
@@ -43,24 +46,34 @@ public:
   explicit LineString(const std::initializer_list<float>& coordinatePairs);
 
   explicit LineString(const std::initializer_list<atools::geo::Pos>& list)
-    : QList(list)
+    : QVector<atools::geo::Pos>(list)
   {
   }
 
+  explicit LineString(const QVector<atools::geo::Pos>& vector)
+    : QVector<atools::geo::Pos>(vector)
+  {
+
+  }
+
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+  /* Copies positions into contiguous storage. QList and QVector are the same in Qt 6. */
   explicit LineString(const QList<atools::geo::Pos>& list)
-    : QList(list)
+    : QVector<atools::geo::Pos>(list.toVector())
   {
 
   }
 
+#endif
+
   explicit LineString(const atools::geo::Pos& pos)
-    : QList({pos})
+    : QVector<atools::geo::Pos>({pos})
   {
 
   }
 
   explicit LineString(const atools::geo::Pos& pos1, const atools::geo::Pos& pos2)
-    : QList({pos1, pos2})
+    : QVector<atools::geo::Pos>({pos1, pos2})
   {
 
   }
@@ -73,34 +86,34 @@ public:
                       const atools::geo::Pos& end, bool clockwise, int numSegments);
 
   LineString(const atools::geo::LineString& other)
-    : QList(other)
+    : QVector<atools::geo::Pos>(other)
   {
   }
 
   atools::geo::LineString& operator=(const atools::geo::LineString& other)
   {
-    QList::operator=(other);
+    QVector<atools::geo::Pos>::operator=(other);
     return *this;
   }
 
   void append(const atools::geo::Pos& pos)
   {
-    QList::append(pos);
+    QVector<atools::geo::Pos>::append(pos);
   }
 
   void append(const atools::geo::LineString& linestring)
   {
-    QList::append(linestring);
+    QVector<atools::geo::Pos>::append(linestring);
   }
 
   void append(float longitudeX, float latitudeY, float alt = 0.f)
   {
-    QList::append(Pos(longitudeX, latitudeY, alt));
+    QVector<atools::geo::Pos>::append(Pos(longitudeX, latitudeY, alt));
   }
 
   void append(double longitudeX, double latitudeY, double alt = 0.f)
   {
-    QList::append(Pos(longitudeX, latitudeY, alt));
+    QVector<atools::geo::Pos>::append(Pos(longitudeX, latitudeY, alt));
   }
 
   LineString reversed();
@@ -150,22 +163,23 @@ public:
   /* Typed version of mid.
    * Returns a sub-vector which contains elements from this vector, starting at position pos.
    * If length is -1 (the default), all elements after pos are included; otherwise length elements
-   * (or all remaining elements if there are less than length elements) are included.*/
+   * (or all remaining elements if there are less than length elements) are included.
+   * Slices covering the whole string share the data. Others are copied in one block. */
   const atools::geo::LineString mid(int pos, int len = -1) const
   {
-    return atools::geo::LineString(QList::mid(pos, len));
+    return atools::geo::LineString(QVector<atools::geo::Pos>::mid(pos, len));
   }
 
   /* Returns a string with len number of coordinates from the beginning of the list */
   const atools::geo::LineString left(int len) const
   {
-    return atools::geo::LineString(QList::mid(0, len));
+    return atools::geo::LineString(QVector<atools::geo::Pos>::mid(0, len));
   }
 
   /* Returns a string with len number of coordinates from the end of the list */
   const atools::geo::LineString right(int len) const
   {
-    return atools::geo::LineString(QList::mid(size() - len));
+    return atools::geo::LineString(QVector<atools::geo::Pos>::mid(size() - len));
   }
 
   /* Calculate Length of the line string in meter */
@@ -49,22 +49,26 @@ struct DataSource
 
     if(size > 0)
     {
-      points = new Point3D[static_cast<size_t>(size)];
-      pointsSize = size;
+      xs.resize(size);
+      ys.resize(size);
+      zs.resize(size);
     }
   }
 
   void free()
   {
-    delete[] points;
-    points = nullptr;
-    pointsSize = 0;
+    xs.clear();
+    xs.squeeze();
+    ys.clear();
+    ys.squeeze();
+    zs.clear();
+    zs.squeeze();
   }
 
   // Must return the number of data points
   size_t kdtree_get_point_count() const
   {
-    return static_cast<size_t>(pointsSize);
+    return static_cast<size_t>(xs.size());
   }
 
   // Returns the dim'th component of the idx'th point in the class:
@@ -73,11 +77,11 @@ struct DataSource
   float kdtree_get_pt(const size_t idx, const size_t dim) const
   {
     if(dim == 0)
-      return points[idx].getX();
+      return xs[static_cast<int>(idx)];
     else if(dim == 1)
-      return points[idx].getY();
+      return ys[static_cast<int>(idx)];
     else
-      return points[idx].getZ();
+      return zs[static_cast<int>(idx)];
   }
 
   // Optional bounding-box computation: return false to default to a standard bbox computation loop.
@@ -92,8 +96,8 @@ struct DataSource
   constexpr static int DIMENSIONS = 3;
   constexpr static int MAX_LEAF_SIZE = 20;
 
-  int pointsSize = 0;
-  Point3D *points = nullptr; // Must be initialized before the index
+  /* Coordinates as structure of arrays. Must be initialized before the index. */
+  QVector<float> xs, ys, zs;
   KDTreeSingleIndexAdaptor<L1_Adaptor<float, DataSource>, DataSource, DIMENSIONS, int> index;
 };
 
@@ -181,7 +185,7 @@ void SpatialIndexPrivate::pointsInRadius(QVector<int>& indexes, const Pos& origi
   Point3D originPt(originPtArr[0], originPtArr[1], originPtArr[2]);
 
   QVector<IndexEntry> indicesDists;
-  indicesDists.reserve(100000);
+  indicesDists.reserve(std::min(p->xs.size(), 1000));
   RadiusResults resultCallback(indicesDists, radiusMaxMeter, callback);
 
   nanoflann::SearchParams params;
@@ -200,7 +204,24 @@ void SpatialIndexPrivate::buildIndex()
 
 void SpatialIndexPrivate::set(const Point3D& point, int index)
 {
-  p->points[index] = point;
+  p->xs[index] = point.getX();
+  p->ys[index] = point.getY();
+  p->zs[index] = point.getZ();
+}
+
+float *SpatialIndexPrivate::dataX()
+{
+  return p->xs.data();
+}
+
+float *SpatialIndexPrivate::dataY()
+{
+  return p->ys.data();
+}
+
+float *SpatialIndexPrivate::dataZ()
+{
+  return p->zs.data();
 }
 
 void SpatialIndexPrivate::clear()
@@ -213,9 +234,29 @@ void SpatialIndexPrivate::reserve(int size)
   p->init(size);
 }
 
-const atools::geo::Point3D *SpatialIndexPrivate::points3D()
+int SpatialIndexPrivate::size() const
+{
+  return p->xs.size();
+}
+
+atools::geo::Point3D SpatialIndexPrivate::point3D(int index) const
+{
+  return Point3D(p->xs.at(index), p->ys.at(index), p->zs.at(index));
+}
+
+const float *SpatialIndexPrivate::pointsX() const
+{
+  return p->xs.constData();
+}
+
+const float *SpatialIndexPrivate::pointsY() const
+{
+  return p->ys.constData();
+}
+
+const float *SpatialIndexPrivate::pointsZ() const
 {
-  return p->points;
+  return p->zs.constData();
 }
 
 SpatialIndexPrivate::SpatialIndexPrivate()
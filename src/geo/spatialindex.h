@@ -19,6 +19,7 @@
 #define ATOOLS_GEO_SPATIALINDEX_H
 
 #include "geo/point3d.h"
+#include "util/parallel.h"
 
 #include <QVector>
 #include <functional>
@@ -57,7 +58,20 @@ class SpatialIndexPrivate
   void buildIndex();
   void clear();
   void reserve(int size);
-  const Point3D *points3D();
+  int size() const;
+
+  /* Point in 3D space built from the coordinate arrays */
+  Point3D point3D(int index) const;
+
+  /* Coordinate arrays (structure of arrays) having size() elements */
+  const float *pointsX() const;
+  const float *pointsY() const;
+  const float *pointsZ() const;
+
+  /* Writeable coordinate arrays. Used to fill the arrays in parallel. */
+  float *dataX();
+  float *dataY();
+  float *dataZ();
 
   /* Data source containing nanoflann structures. */
   DataSource *p = nullptr;
@@ -74,6 +88,12 @@ class SpatialIndexPrivate
  *
  * Note that squared distance is used internally for lookup and resulting distances are therefore not accurate.
  *
+ * Cartesian coordinates are kept as separate float arrays for X, Y and Z (structure of arrays) which are
+ * filled in parallel for large vectors.
+ *
+ * All const query methods are read-only and can be called from several threads at the same time
+ * as long as neither the vector nor the index are modified.
+ *
  * T needs a method const atools::geo::Pos& getPosition() const .
  */
 template<typename T>
@@ -99,7 +119,7 @@ public:
   void getNearest(T& obj, const atools::geo::Pos& pos) const;
 
   /* Get index of one nearest object. Index can be used to access objects from the underlying vector or
-   * the Point3D vector using getPoints3D().*/
+   * the coordinate arrays using getPointsX(), getPointsY() and getPointsZ().*/
   int getNearestIndex(const atools::geo::Pos& pos) const
   {
     return p->nearestPoint(pos);
@@ -108,6 +128,10 @@ public:
   /* Get number nearest objects or indexes from the vector. */
   void getNearest(QVector<T>& objects, const atools::geo::Pos& pos, int number) const;
 
+  /* As above but returns pointers into the underlying vector which avoids copying. Pointers are valid until
+   * the vector is changed. */
+  void getNearest(QVector<const T *>& objects, const atools::geo::Pos& pos, int number) const;
+
   void getNearestIndexes(QVector<int>& indexes, const atools::geo::Pos& pos, int number) const
   {
     p->nearestPoints(indexes, pos, number);
@@ -125,24 +149,50 @@ public:
 
   void getRadius(QVector<T>& objects, const atools::geo::Pos& pos, float radiusMeter) const;
 
+  /* As above but returns pointers into the underlying vector which avoids copying. Pointers are valid until
+   * the vector is changed. */
+  void getRadius(QVector<const T *>& objects, const atools::geo::Pos& pos, float radiusMeter,
+                 const RadiusCallbackType& callback) const;
+  void getRadius(QVector<const T *>& objects, const atools::geo::Pos& pos, float radiusMeter) const;
+
   void getRadiusIndexes(QVector<int>& indexes, const atools::geo::Pos& pos, float radiusMaxMeter) const
   {
     p->pointsInRadius(indexes, pos, radiusMaxMeter, RadiusCallbackType());
   }
 
-  /* Rebuild the KD-tree and Point3D vector. Call this after changing the base class vector. */
+  /* Rebuild the KD-tree and coordinate arrays. Call this after changing the base class vector.
+   * Coordinates are converted in parallel for large vectors. */
   void updateIndex();
 
-  /* Get points converted to 3D euclidian space from base vector.
+  /* Replace the content of the base vector by moving objects in and rebuild the index. Avoids copying. */
+  void updateIndex(QVector<T>&& objects)
+  {
+    QVector<T>::swap(objects);
+    objects.clear();
+    updateIndex();
+  }
+
+  /* Get point converted to 3D euclidian space from base vector. */
+  Point3D atPoint3D(int index) const
+  {
+    return p->point3D(index);
+  }
+
+  /* Get coordinate arrays of points converted to 3D euclidian space.
    * Size is the same as in the underlying parent QVector. */
-  const Point3D *getPoints3D() const
+  const float *getPointsX() const
+  {
+    return p->pointsX();
+  }
+
+  const float *getPointsY() const
   {
-    return p->points3D();
+    return p->pointsY();
   }
 
-  const Point3D& atPoint3D(int index) const
+  const float *getPointsZ() const
   {
-    return p->points3D()[index];
+    return p->pointsZ();
   }
 
   /* Clears vector and updates index to clear it */
@@ -155,13 +205,26 @@ public:
 private:
   using QVector<T>::clear;
 
+  /* Minimum number of objects per thread when converting coordinates in updateIndex() */
+  static constexpr int MIN_PARALLEL_CHUNK_SIZE = 20000;
+
   /* Copy objects from base vector to result set. */
-  void copyData(QVector<T>& objects, QVector<int>& indexes) const
+  void copyData(QVector<T>& objects, const QVector<int>& indexes) const
   {
+    objects.reserve(objects.size() + indexes.size());
     for(int idx : indexes)
       objects.append(this->at(idx));
   }
 
+  /* Copy pointers to objects from base vector to result set. */
+  void copyData(QVector<const T *>& objects, const QVector<int>& indexes) const
+  {
+    objects.reserve(objects.size() + indexes.size());
+    const T *data = this->constData();
+    for(int idx : indexes)
+      objects.append(data + idx);
+  }
+
   atools::geo::internal::SpatialIndexPrivate *p = nullptr;
 };
 
@@ -191,6 +254,31 @@ void SpatialIndex<T>::getNearest(QVector<T>& objects, const Pos& pos, int number
   copyData(objects, indexes);
 }
 
+template<typename T>
+void SpatialIndex<T>::getNearest(QVector<const T *>& objects, const Pos& pos, int number) const
+{
+  QVector<int> indexes;
+  p->nearestPoints(indexes, pos, number);
+  copyData(objects, indexes);
+}
+
+template<typename T>
+void SpatialIndex<T>::getRadius(QVector<const T *>& objects, const Pos& pos, float radiusMaxMeter,
+                                const RadiusCallbackType& callback) const
+{
+  QVector<int> indexes;
+  p->pointsInRadius(indexes, pos, radiusMaxMeter, callback);
+  copyData(objects, indexes);
+}
+
+template<typename T>
+void SpatialIndex<T>::getRadius(QVector<const T *>& objects, const Pos& pos, float radiusMaxMeter) const
+{
+  QVector<int> indexes;
+  p->pointsInRadius(indexes, pos, radiusMaxMeter, RadiusCallbackType());
+  copyData(objects, indexes);
+}
+
 template<typename T>
 void SpatialIndex<T>::getRadius(QVector<T>& objects, const Pos& pos, float radiusMaxMeter, const RadiusCallbackType& callback) const
 {
@@ -210,10 +298,19 @@ void SpatialIndex<T>::getRadius(QVector<T>& objects, const Pos& pos, float radiu
 template<typename T>
 void SpatialIndex<T>::updateIndex()
 {
-  p->reserve(QVector<T>::size());
+  int size = QVector<T>::size();
+  p->reserve(size);
 
-  for(int i = 0; i < QVector<T>::size(); i++)
-    p->set(QVector<T>::at(i).getPosition().toCartesian(), i);
+  if(size > 0)
+  {
+    // Fill coordinate arrays in parallel - each range writes to a disjoint part of the arrays
+    const T *objects = QVector<T>::constData();
+    float *xs = p->dataX(), *ys = p->dataY(), *zs = p->dataZ();
+    atools::util::parallelFor(size, [objects, xs, ys, zs](int begin, int end) -> void {
+          for(int i = begin; i < end; i++)
+            objects[i].getPosition().toCartesian(xs[i], ys[i], zs[i]);
+        }, MIN_PARALLEL_CHUNK_SIZE);
+  }
 
   p->buildIndex();
 }
@@ -219,22 +219,7 @@ void HttpConnectionHandler::read()
 
       // Copy the Connection:close header to the response
       HttpResponse response(socket);
-      bool closeConnection = QString::compare(currentRequest->getHeader("Connection"), "close", Qt::CaseInsensitive) == 0;
-      if(closeConnection)
-      {
-        response.setHeader("Connection", "close");
-      }
-      // In case of HTTP 1.0 protocol add the Connection:close header.
-      // This ensures that the HttpResponse does not activate chunked mode, which is not spported by HTTP 1.0.
-      else
-      {
-        bool http1_0 = QString::compare(currentRequest->getVersion(), "HTTP/1.0", Qt::CaseInsensitive) == 0;
-        if(http1_0)
-        {
-          closeConnection = true;
-          response.setHeader("Connection", "close");
-        }
-      }
+      bool closeConnection = prepareResponse(*currentRequest, response);
 
       // Call the request mapper
       try
@@ -247,40 +232,12 @@ void HttpConnectionHandler::read()
                   static_cast<void *>(this));
       }
 
-      // Finalize sending the response if not already done
-      if(!response.hasSentLastPart())
-      {
-        response.write(QByteArray(), true);
-      }
+      // Finalize sending the response if not already done and find out whether the connection must be closed
+      closeConnection = finishResponse(response, closeConnection);
       #ifdef DEBUG_INFORMATION_HTTP
       qDebug("HttpConnectionHandler (%p): finished request", static_cast<void *>(this));
       #endif
 
-      // Find out whether the connection must be closed
-      if(!closeConnection)
-      {
-        // Maybe the request handler or mapper added a Connection:close header in the meantime
-        bool closeResponse = QString::compare(response.getHeaders().value("Connection"), "close", Qt::CaseInsensitive) == 0;
-        if(closeResponse == true)
-        {
-          closeConnection = true;
-        }
-        else
-        {
-          // If we have no Content-Length header and did not use chunked mode, then we have to close the
-          // connection to tell the HTTP client that the end of the response has been reached.
-          bool hasContentLength = response.getHeaders().contains("Content-Length");
-          if(!hasContentLength)
-          {
-            bool hasChunkedMode = QString::compare(response.getHeaders().value("Transfer-Encoding"), "chunked", Qt::CaseInsensitive) == 0;
-            if(!hasChunkedMode)
-            {
-              closeConnection = true;
-            }
-          }
-        }
-      }
-
       // Close the connection or prepare for the next request on the same connection.
       if(closeConnection)
       {
@@ -301,3 +258,60 @@ void HttpConnectionHandler::read()
     }
   }
 }
+
+bool HttpConnectionHandler::prepareResponse(HttpRequest& request, HttpResponse& response)
+{
+  // Copy the Connection:close header to the response
+  bool closeConnection = QString::compare(request.getHeader("Connection"), "close", Qt::CaseInsensitive) == 0;
+  if(closeConnection)
+  {
+    response.setHeader("Connection", "close");
+  }
+  // In case of HTTP 1.0 protocol add the Connection:close header.
+  // This ensures that the HttpResponse does not activate chunked mode, which is not spported by HTTP 1.0.
+  else
+  {
+    bool http1_0 = QString::compare(request.getVersion(), "HTTP/1.0", Qt::CaseInsensitive) == 0;
+    if(http1_0)
+    {
+      closeConnection = true;
+      response.setHeader("Connection", "close");
+    }
+  }
+  return closeConnection;
+}
+
+bool HttpConnectionHandler::finishResponse(HttpResponse& response, bool closeConnection)
+{
+  // Finalize sending the response if not already done
+  if(!response.hasSentLastPart())
+  {
+    response.write(QByteArray(), true);
+  }
+
+  // Find out whether the connection must be closed
+  if(!closeConnection)
+  {
+    // Maybe the request handler or mapper added a Connection:close header in the meantime
+    bool closeResponse = QString::compare(response.getHeaders().value("Connection"), "close", Qt::CaseInsensitive) == 0;
+    if(closeResponse == true)
+    {
+      closeConnection = true;
+    }
+    else
+    {
+      // If we have no Content-Length header and did not use chunked mode, then we have to close the
+      // connection to tell the HTTP client that the end of the response has been reached.
+      bool hasContentLength = response.getHeaders().contains("Content-Length");
+      if(!hasContentLength)
+      {
+        bool hasChunkedMode = QString::compare(response.getHeaders().value("Transfer-Encoding"), "chunked", Qt::CaseInsensitive) == 0;
+        if(!hasChunkedMode)
+        {
+          closeConnection = true;
+        }
+      }
+    }
+  }
+  return closeConnection;
+}
@@ -18,6 +18,8 @@
 
 namespace stefanfrings {
 
+class HttpResponse;
+
 /** Alias type definition, for compatibility to different Qt versions */
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
 typedef qintptr tSocketDescriptor;
@@ -73,6 +75,19 @@ public:
   /** Mark this handler as busy */
   void setBusy();
 
+  /**
+   *  Copy the Connection:close header to the response and force close for HTTP 1.0.
+   *  @return true if the connection has to be closed after the response.
+   */
+  static bool prepareResponse(HttpRequest& request, HttpResponse& response);
+
+  /**
+   *  Send the last part of the response if not already done after HttpRequestHandler::service() returned.
+   *  @param closeConnection Value returned by prepareResponse()
+   *  @return true if the connection has to be closed after the response.
+   */
+  static bool finishResponse(HttpResponse& response, bool closeConnection);
+
 private:
   /** Configuration settings */
   QHash<QString, QVariant> settings;
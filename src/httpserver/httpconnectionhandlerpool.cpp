@@ -15,8 +15,7 @@ HttpConnectionHandlerPool::HttpConnectionHandlerPool(const QHash<QString, QVaria
 {
   this->settings = settings;
   this->requestHandler = requestHandler;
-  this->sslConfiguration = nullptr;
-  loadSslConfig();
+  this->sslConfiguration = loadSslConfig(settings);
   cleanupTimer.start(settings.value("cleanupInterval", 1000).toInt());
   connect(&cleanupTimer, SIGNAL(timeout()), SLOT(cleanup()));
 }
@@ -84,8 +83,10 @@ void HttpConnectionHandlerPool::cleanup()
   mutex.unlock();
 }
 
-void HttpConnectionHandlerPool::loadSslConfig()
+QSslConfiguration *HttpConnectionHandlerPool::loadSslConfig(const QHash<QString, QVariant>& settings)
 {
+  QSslConfiguration *sslConfiguration = nullptr;
+
   // If certificate and key files are configured, then load them
   QString sslKeyFileName = settings.value("sslKeyFile", "").toString();
   QString sslCertFileName = settings.value("sslCertFile", "").toString();
@@ -113,7 +114,7 @@ void HttpConnectionHandlerPool::loadSslConfig()
     if(!certFile.open(QIODevice::ReadOnly))
     {
       qCritical("HttpConnectionHandlerPool: cannot open sslCertFile %s", qPrintable(sslCertFileName));
-      return;
+      return nullptr;
     }
     QSslCertificate certificate(&certFile, QSsl::Pem);
     certFile.close();
@@ -123,7 +124,7 @@ void HttpConnectionHandlerPool::loadSslConfig()
     if(!keyFile.open(QIODevice::ReadOnly))
     {
       qCritical("HttpConnectionHandlerPool: cannot open sslKeyFile %s", qPrintable(sslKeyFileName));
-      return;
+      return nullptr;
     }
     QSslKey sslKey(&keyFile, QSsl::Rsa, QSsl::Pem);
     keyFile.close();
@@ -152,7 +153,7 @@ void HttpConnectionHandlerPool::loadSslConfig()
       if(!caCertFile.open(QIODevice::ReadOnly))
       {
         qCritical("HttpConnectionHandlerPool: cannot open caCertFile %s", qPrintable(caCertFileName));
-        return;
+        return sslConfiguration;
       }
       QSslCertificate caCertificate(&caCertFile, QSsl::Pem);
       caCertFile.close();
@@ -175,4 +176,5 @@ void HttpConnectionHandlerPool::loadSslConfig()
     qDebug("HttpConnectionHandlerPool: SSL settings loaded");
          #endif
   }
+  return sslConfiguration;
 }
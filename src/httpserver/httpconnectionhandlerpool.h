@@ -101,6 +101,12 @@ public:
   /** Get a free connection handler, or 0 if not available. */
   HttpConnectionHandler *getConnectionHandler();
 
+  /**
+   *  Load SSL configuration from the settings.
+   *  @return Configuration or 0 if SSL is not configured. Caller takes ownership.
+   */
+  static QSslConfiguration *loadSslConfig(const QHash<QString, QVariant>& settings);
+
 private:
   /** Settings for this pool */
   QHash<QString, QVariant> settings;
@@ -120,9 +126,6 @@ private:
   /** The SSL configuration (certificate, key and other settings) */
   QSslConfiguration *sslConfiguration;
 
-  /** Load SSL configuration */
-  void loadSslConfig();
-
 private slots:
   /** Received from the clean-up timer.  */
   void cleanup();
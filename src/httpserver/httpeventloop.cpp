@@ -0,0 +1,351 @@
+/**
+ *  @file
+ */
+
+#ifndef QT_NO_SSL
+  #include <QSslSocket>
+#endif
+#include <QCoreApplication>
+#include <QRunnable>
+#include <QThread>
+#include <algorithm>
+#include "httpeventloop.h"
+#include "httpconnectionhandlerpool.h"
+#include "httpresponse.h"
+
+using namespace stefanfrings;
+
+namespace stefanfrings {
+
+/**
+ *  Runs the request handler in a worker thread and posts the response back to the connection.
+ *  A runnable is used instead of a lambda since QThreadPool::start(std::function) needs Qt 5.15.
+ */
+class HttpServiceTask :
+  public QRunnable
+{
+public:
+  HttpServiceTask(HttpRequest *request, HttpRequestHandler *handler, HttpEventConnection *connection)
+    : request(request), handler(handler), connection(connection)
+  {
+    setAutoDelete(true);
+  }
+
+  virtual void run() override
+  {
+    // Collect response in memory since the socket belongs to the event loop thread
+    QByteArray output;
+    HttpResponse response(&output);
+    bool closeConnection = HttpConnectionHandler::prepareResponse(*request, response);
+
+    try
+    {
+      handler->service(*request, response);
+    }
+    catch(...)
+    {
+      qCritical("HttpEventConnection (%p): An uncatched exception occurred in the request handler",
+                static_cast<void *>(connection));
+    }
+
+    closeConnection = HttpConnectionHandler::finishResponse(response, closeConnection);
+
+    // Connection is not deleted while the request is pending
+    QMetaObject::invokeMethod(connection, "serviceDone", Qt::QueuedConnection,
+                              Q_ARG(QByteArray, output), Q_ARG(bool, closeConnection));
+  }
+
+private:
+  HttpRequest *request;
+  HttpRequestHandler *handler;
+  HttpEventConnection *connection;
+};
+
+} // namespace stefanfrings
+
+HttpEventConnection::HttpEventConnection(const QHash<QString, QVariant>& settings, HttpRequestHandler *requestHandler,
+                                         QThreadPool *workerPool, const QSslConfiguration *sslConfiguration,
+                                         HttpEventLoop *parent)
+  : QObject(parent)
+{
+  this->eventLoop = parent;
+  this->settings = settings;
+  this->requestHandler = requestHandler;
+  this->workerPool = workerPool;
+  readTimeoutMs = settings.value("readTimeout", 10000).toInt();
+  readTimer.setSingleShot(true);
+
+  // Create TCP or SSL socket
+#ifndef QT_NO_SSL
+  if(sslConfiguration)
+  {
+    QSslSocket *sslSocket = new QSslSocket(this);
+    sslSocket->setSslConfiguration(*sslConfiguration);
+    socket = sslSocket;
+  }
+  else
+#else
+  Q_UNUSED(sslConfiguration);
+#endif
+  socket = new QTcpSocket(this);
+
+  connect(socket, SIGNAL(readyRead()), SLOT(read()));
+  connect(socket, SIGNAL(disconnected()), SLOT(disconnected()));
+  connect(&readTimer, SIGNAL(timeout()), SLOT(readTimeout()));
+}
+
+HttpEventConnection::~HttpEventConnection()
+{
+  readTimer.stop();
+  delete currentRequest;
+  eventLoop->connectionClosed();
+}
+
+bool HttpEventConnection::handleConnection(tSocketDescriptor socketDescriptor)
+{
+  if(!socket->setSocketDescriptor(socketDescriptor))
+  {
+    qCritical("HttpEventConnection (%p): cannot initialize socket: %s",
+              static_cast<void *>(this), qPrintable(socket->errorString()));
+    return false;
+  }
+
+#ifndef QT_NO_SSL
+  // Switch on encryption, if SSL is configured
+  QSslSocket *sslSocket = qobject_cast<QSslSocket *>(socket);
+  if(sslSocket)
+  {
+    sslSocket->startServerEncryption();
+  }
+#endif
+
+  // Start timer for read timeout
+  readTimer.start(readTimeoutMs);
+  return true;
+}
+
+void HttpEventConnection::readTimeout()
+{
+  qDebug("HttpEventConnection (%p): read timeout occurred", static_cast<void *>(this));
+
+  // Closes after all pending data is written
+  socket->disconnectFromHost();
+  if(!servicePending)
+  {
+    delete currentRequest;
+    currentRequest = nullptr;
+  }
+}
+
+void HttpEventConnection::disconnected()
+{
+  readTimer.stop();
+  if(servicePending)
+  {
+    // Delete after the worker is done
+    socketDisconnected = true;
+  }
+  else
+  {
+    deleteLater();
+  }
+}
+
+void HttpEventConnection::abort(const QByteArray& message)
+{
+  socket->write(message);
+  socket->disconnectFromHost();
+  delete currentRequest;
+  currentRequest = nullptr;
+}
+
+void HttpEventConnection::read()
+{
+  // The loop adds support for HTTP pipelinig - next request is read after the response was sent
+  while(!servicePending && socket->bytesAvailable())
+  {
+    // Create new HttpRequest object if necessary
+    if(!currentRequest)
+    {
+      currentRequest = new HttpRequest(settings);
+    }
+
+    // Collect data for the request object
+    while(socket->bytesAvailable() &&
+          currentRequest->getStatus() != HttpRequest::complete &&
+          currentRequest->getStatus() != HttpRequest::abort_size &&
+          currentRequest->getStatus() != HttpRequest::abort_broken)
+    {
+      currentRequest->readFromSocket(socket);
+      if(currentRequest->getStatus() == HttpRequest::waitForBody)
+      {
+        // Restart timer for read timeout, otherwise it would
+        // expire during large file uploads.
+        readTimer.start(readTimeoutMs);
+      }
+    }
+
+    // If the request is aborted, return error message and close the connection
+    if(currentRequest->getStatus() == HttpRequest::abort_size)
+    {
+      abort("HTTP/1.1 413 entity too large\r\nConnection: close\r\n\r\n413 Entity too large\r\n");
+      return;
+    }
+    // another reson to abort the request
+    else if(currentRequest->getStatus() == HttpRequest::abort_broken)
+    {
+      abort("HTTP/1.1 400 bad request\r\nConnection: close\r\n\r\n400 Bad request\r\n");
+      return;
+    }
+    // If the request is complete, let the worker pool dispatch it
+    else if(currentRequest->getStatus() == HttpRequest::complete)
+    {
+      readTimer.stop();
+      servicePending = true;
+
+      workerPool->start(new HttpServiceTask(currentRequest, requestHandler, this));
+    }
+  }
+}
+
+void HttpEventConnection::serviceDone(const QByteArray& output, bool closeConnection)
+{
+  servicePending = false;
+  delete currentRequest;
+  currentRequest = nullptr;
+
+  if(socketDisconnected)
+  {
+    deleteLater();
+    return;
+  }
+
+  socket->write(output);
+
+  // Close the connection or prepare for the next request on the same connection.
+  if(closeConnection)
+  {
+    // Closes after all pending data is written
+    socket->disconnectFromHost();
+  }
+  else
+  {
+    // Start timer for next request and read already received data of pipelined requests
+    readTimer.start(readTimeoutMs);
+    read();
+  }
+}
+
+// ======================================================================================
+HttpEventLoop::HttpEventLoop(const QHash<QString, QVariant>& settings, HttpRequestHandler *requestHandler,
+                             QThreadPool *workerPool, const QSslConfiguration *sslConfiguration,
+                             QAtomicInt *numConnections)
+  : QObject()
+{
+  this->settings = settings;
+  this->requestHandler = requestHandler;
+  this->workerPool = workerPool;
+  this->sslConfiguration = sslConfiguration;
+  this->numConnections = numConnections;
+
+  // execute signals in a new thread
+  thread = new QThread();
+  thread->setObjectName("HttpEventLoop");
+  moveToThread(thread);
+
+  // Direct connection to run the slot in the finishing thread
+  connect(thread, SIGNAL(finished()), this, SLOT(threadDone()), Qt::DirectConnection);
+  thread->start();
+  qDebug("HttpEventLoop (%p): thread started", static_cast<void *>(this));
+}
+
+HttpEventLoop::~HttpEventLoop()
+{
+  thread->quit();
+
+  // Process main events if threads do not terminate withing one second
+  // This is needed to avoid deadlocks if handlers require functions from main threads through blocking queued connections
+  while(!thread->wait(1))
+    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+
+  delete thread;
+  qDebug("HttpEventLoop (%p): destroyed", static_cast<void *>(this));
+}
+
+void HttpEventLoop::threadDone()
+{
+  // Delete connections in their own thread
+  qDeleteAll(findChildren<HttpEventConnection *>(QString(), Qt::FindDirectChildrenOnly));
+  qDebug("HttpEventLoop (%p): thread stopped", static_cast<void *>(this));
+}
+
+void HttpEventLoop::connectionClosed()
+{
+  numConnections->fetchAndSubRelaxed(1);
+}
+
+void HttpEventLoop::handleConnection(const tSocketDescriptor socketDescriptor)
+{
+  HttpEventConnection *connection =
+    new HttpEventConnection(settings, requestHandler, workerPool, sslConfiguration, this);
+
+  if(!connection->handleConnection(socketDescriptor))
+  {
+    delete connection;
+  }
+}
+
+// ======================================================================================
+HttpEventLoopPool::HttpEventLoopPool(const QHash<QString, QVariant>& settings, HttpRequestHandler *requestHandler)
+  : QObject()
+{
+  this->settings = settings;
+  maxConnections = settings.value("maxConnections", 1000).toInt();
+  sslConfiguration = HttpConnectionHandlerPool::loadSslConfig(settings);
+
+  int workerThreads = settings.value("workerThreads", 0).toInt();
+  if(workerThreads > 0)
+  {
+    workerPool.setMaxThreadCount(workerThreads);
+  }
+
+  int numEventLoops = std::max(settings.value("eventLoopThreads", 1).toInt(), 1);
+  for(int i = 0; i < numEventLoops; i++)
+  {
+    eventLoops.append(new HttpEventLoop(settings, requestHandler, &workerPool, sslConfiguration, &numConnections));
+  }
+
+  qDebug("HttpEventLoopPool: event loops=%i, workers=%i, max connections=%i", static_cast<int>(eventLoops.size()),
+         workerPool.maxThreadCount(), maxConnections);
+}
+
+HttpEventLoopPool::~HttpEventLoopPool()
+{
+  // Wait for pending requests first since they post their responses to the event loops
+  while(!workerPool.waitForDone(1))
+    QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
+
+  qDeleteAll(eventLoops);
+  eventLoops.clear();
+  delete sslConfiguration;
+  qDebug("HttpEventLoopPool (%p): destroyed", static_cast<void *>(this));
+}
+
+bool HttpEventLoopPool::handleConnection(tSocketDescriptor socketDescriptor)
+{
+  if(numConnections.loadAcquire() >= maxConnections)
+  {
+    return false;
+  }
+
+  numConnections.fetchAndAddRelaxed(1);
+
+  // Distribute connections evenly
+  HttpEventLoop *eventLoop = eventLoops.at(nextEventLoop);
+  nextEventLoop = (nextEventLoop + 1) % eventLoops.size();
+
+  // The descriptor is passed via event queue because the loop lives in another thread
+  QMetaObject::invokeMethod(eventLoop, "handleConnection", Qt::QueuedConnection,
+                            Q_ARG(tSocketDescriptor, socketDescriptor));
+  return true;
+}
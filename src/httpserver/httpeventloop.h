@@ -0,0 +1,205 @@
+/**
+ *  @file
+ */
+
+#ifndef HTTPEVENTLOOP_H
+#define HTTPEVENTLOOP_H
+
+#include <QAtomicInt>
+#include <QList>
+#include <QObject>
+#include <QThreadPool>
+#include <QTimer>
+#include "httpglobal.h"
+#include "httpconnectionhandler.h"
+
+namespace stefanfrings {
+
+class HttpEventLoop;
+
+/**
+ *  Connection in event driven mode. Lives in the thread of a HttpEventLoop and reads requests
+ *  from the socket. Complete requests are passed to the worker pool. Only one request per connection
+ *  is processed at a time. Pipelined requests are read after the response was sent.
+ *  <p>
+ *  The object deletes itself after the socket was disconnected and no request is pending.
+ */
+class DECLSPEC HttpEventConnection :
+  public QObject
+{
+  Q_OBJECT
+  Q_DISABLE_COPY(HttpEventConnection)
+
+public:
+  /**
+   *  Constructor.
+   *  @param settings Configuration settings of the HTTP webserver
+   *  @param requestHandler Handler that will process each incoming HTTP request
+   *  @param workerPool Pool running HttpRequestHandler::service()
+   *  @param sslConfiguration SSL (HTTPS) will be used if not NULL
+   *  @param parent Event loop owning this connection
+   */
+  HttpEventConnection(const QHash<QString, QVariant>& settings, HttpRequestHandler *requestHandler,
+                      QThreadPool *workerPool, const QSslConfiguration *sslConfiguration, HttpEventLoop *parent);
+
+  /** Destructor */
+  virtual ~HttpEventConnection();
+
+  /**
+   *  Take over the accepted connection.
+   *  @return false if the socket cannot be initialized.
+   */
+  bool handleConnection(tSocketDescriptor socketDescriptor);
+
+public slots:
+  /** Called from the worker thread through the event queue when a response is ready */
+  void serviceDone(const QByteArray& output, bool closeConnection);
+
+private:
+  /** Configuration settings */
+  QHash<QString, QVariant> settings;
+
+  /** Event loop owning this connection */
+  HttpEventLoop *eventLoop;
+
+  /** TCP socket of the connection */
+  QTcpSocket *socket;
+
+  /** Time for read timeout detection */
+  QTimer readTimer;
+
+  /** Storage for the current incoming HTTP request */
+  HttpRequest *currentRequest = nullptr;
+
+  /** Dispatches received requests to services */
+  HttpRequestHandler *requestHandler;
+
+  /** Runs the request handler */
+  QThreadPool *workerPool;
+
+  /** A request is processed by the worker pool */
+  bool servicePending = false;
+
+  /** Socket was disconnected while a request is pending */
+  bool socketDisconnected = false;
+
+  /** Read timeout in milliseconds */
+  int readTimeoutMs;
+
+  /** Send error message and close the connection */
+  void abort(const QByteArray& message);
+
+private slots:
+  /** Received from the socket when a read-timeout occured */
+  void readTimeout();
+
+  /** Received from the socket when incoming data can be read */
+  void read();
+
+  /** Received from the socket when a connection has been closed */
+  void disconnected();
+};
+
+/**
+ *  Event loop thread multiplexing many connections. Owns all HttpEventConnection objects of its thread.
+ */
+class DECLSPEC HttpEventLoop :
+  public QObject
+{
+  Q_OBJECT
+  Q_DISABLE_COPY(HttpEventLoop)
+
+public:
+  /**
+   *  Constructor. Starts the thread and moves this object into it.
+   *  @param numConnections Counter for open connections which is shared by all loops
+   */
+  HttpEventLoop(const QHash<QString, QVariant>& settings, HttpRequestHandler *requestHandler, QThreadPool *workerPool,
+                const QSslConfiguration *sslConfiguration, QAtomicInt *numConnections);
+
+  /** Destructor. Stops the thread and closes all connections. */
+  virtual ~HttpEventLoop();
+
+  /** Called by connections when they are deleted */
+  void connectionClosed();
+
+public slots:
+  /**
+   *  Received from the pool through the event queue to process a new incoming connection.
+   *  @param socketDescriptor references the accepted connection.
+   */
+  void handleConnection(const tSocketDescriptor socketDescriptor);
+
+private slots:
+  /** Close all connections in this thread when the thread is stopped */
+  void threadDone();
+
+private:
+  QHash<QString, QVariant> settings;
+  HttpRequestHandler *requestHandler;
+  QThreadPool *workerPool;
+  const QSslConfiguration *sslConfiguration;
+  QAtomicInt *numConnections;
+  QThread *thread;
+};
+
+/**
+ *  Alternative to HttpConnectionHandlerPool using a small fixed number of event loop threads
+ *  which multiplex all connections. Requests are processed by a bounded pool of worker threads.
+ *  HttpRequestHandler::service() is called the same way as in thread per connection mode but the response
+ *  is collected in memory and sent by the event loop thread.
+ *  <p>
+ *  Enabled in HttpListener by setting eventLoopThreads to a value greater than 0.
+ *  <code><pre>
+ *  eventLoopThreads=2
+ *  workerThreads=8
+ *  maxConnections=1000
+ *  </pre></code>
+ *  <p>
+ *  workerThreads uses the number of CPU cores if 0 or missing. Connections above maxConnections are rejected.
+ *  SSL settings are the same as for HttpConnectionHandlerPool.
+ */
+class DECLSPEC HttpEventLoopPool :
+  public QObject
+{
+  Q_OBJECT
+  Q_DISABLE_COPY(HttpEventLoopPool)
+
+public:
+  /**
+   *  Constructor.
+   *  @param settings Configuration settings for the HTTP server.
+   *  @param requestHandler The handler that will process each received HTTP request.
+   */
+  HttpEventLoopPool(const QHash<QString, QVariant>& settings, HttpRequestHandler *requestHandler);
+
+  /** Destructor. Waits for all pending requests and stops all threads. */
+  virtual ~HttpEventLoopPool();
+
+  /**
+   *  Pass the connection to the next event loop.
+   *  @return false if the maximum number of connections is reached.
+   */
+  bool handleConnection(tSocketDescriptor socketDescriptor);
+
+private:
+  QHash<QString, QVariant> settings;
+
+  /** Threads running HttpRequestHandler::service() */
+  QThreadPool workerPool;
+
+  /** Event loops which are used in turn for new connections */
+  QList<HttpEventLoop *> eventLoops;
+  int nextEventLoop = 0;
+
+  /** Number of open connections in all event loops */
+  QAtomicInt numConnections;
+  int maxConnections;
+
+  /** The SSL configuration (certificate, key and other settings) */
+  QSslConfiguration *sslConfiguration;
+};
+
+} // end of namespace
+
+#endif // HTTPEVENTLOOP_H
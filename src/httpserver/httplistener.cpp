@@ -15,6 +15,7 @@ HttpListener::HttpListener(const QHash<QString, QVariant>& settings, HttpRequest
 {
   Q_ASSERT(requestHandler != nullptr);
   pool = nullptr;
+  eventLoopPool = nullptr;
   this->settings = settings;
   this->requestHandler = requestHandler;
   // Reqister type of socketDescriptor for signal/slot handling
@@ -31,7 +32,14 @@ HttpListener::~HttpListener()
 
 void HttpListener::listen()
 {
-  if(!pool)
+  if(settings.value("eventLoopThreads", 0).toInt() > 0)
+  {
+    if(!eventLoopPool)
+    {
+      eventLoopPool = new HttpEventLoopPool(settings, requestHandler);
+    }
+  }
+  else if(!pool)
   {
     pool = new HttpConnectionHandlerPool(settings, requestHandler);
   }
@@ -57,6 +65,11 @@ void HttpListener::close()
     delete pool;
     pool = nullptr;
   }
+  if(eventLoopPool)
+  {
+    delete eventLoopPool;
+    eventLoopPool = nullptr;
+  }
 }
 
 void HttpListener::incomingConnection(tSocketDescriptor socketDescriptor)
@@ -65,6 +78,14 @@ void HttpListener::incomingConnection(tSocketDescriptor socketDescriptor)
   qDebug("HttpListener: New connection");
 #endif
 
+  if(eventLoopPool)
+  {
+    if(eventLoopPool->handleConnection(socketDescriptor))
+    {
+      return;
+    }
+  }
+
   HttpConnectionHandler *freeHandler = nullptr;
   if(pool)
   {
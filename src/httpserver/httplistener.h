@@ -11,6 +11,7 @@
 #include "httpglobal.h"
 #include "httpconnectionhandler.h"
 #include "httpconnectionhandlerpool.h"
+#include "httpeventloop.h"
 #include "httprequesthandler.h"
 
 namespace stefanfrings {
@@ -50,7 +51,17 @@ namespace stefanfrings {
  *  are started on demand when requests come in. The cleanup timer reduces
  *  the number of idle threads slowly by closing one thread in each interval.
  *  But the configured minimum number of threads are kept running.
+ *  <p>
+ *  Alternatively, connections can be handled by a few event loop threads which pass requests to
+ *  a bounded pool of worker threads. This avoids one thread per connection for many keep-alive clients.
+ *  The settings minThreads, maxThreads and cleanupInterval are not used in this mode.
+ *  <code><pre>
+ *  eventLoopThreads=2
+ *  workerThreads=8
+ *  maxConnections=1000
+ *  </pre></code>
  *  @see HttpConnectionHandlerPool for description of the optional ssl settings
+ *  @see HttpEventLoopPool
  */
 
 class DECLSPEC HttpListener :
@@ -103,6 +114,9 @@ private:
   /** Pool of connection handlers */
   HttpConnectionHandlerPool *pool;
 
+  /** Event loops and workers if eventLoopThreads is set. pool is null in this case. */
+  HttpEventLoopPool *eventLoopPool;
+
 signals:
   /**
    *  Sent to the connection handler to process a new incoming connection.
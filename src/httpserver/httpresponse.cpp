@@ -10,6 +10,19 @@ using namespace stefanfrings;
 HttpResponse::HttpResponse(QTcpSocket *socket)
 {
   this->socket = socket;
+  outputBuffer = nullptr;
+  statusCode = 200;
+  statusText = "OK";
+  sentHeaders = false;
+  sentLastPart = false;
+  chunkedMode = false;
+}
+
+HttpResponse::HttpResponse(QByteArray *outputBuffer)
+{
+  Q_ASSERT(outputBuffer != nullptr);
+  this->socket = nullptr;
+  this->outputBuffer = outputBuffer;
   statusCode = 200;
   statusText = "OK";
   sentHeaders = false;
@@ -69,14 +82,21 @@ void HttpResponse::writeHeaders()
   }
   buffer.append("\r\n");
   writeToSocket(buffer);
-  socket->flush();
+  flush();
   sentHeaders = true;
 }
 
 bool HttpResponse::writeToSocket(QByteArray data)
 {
+  if(!socket)
+  {
+    outputBuffer->append(data);
+    return true;
+  }
+
   int remaining = data.size();
-  char *ptr = data.data();
+  // Read only access avoids a deep copy of raw data like memory mapped files
+  const char *ptr = data.constData();
   while(socket->isOpen() && remaining > 0)
   {
     // If the output buffer has become large, then wait until it has been sent.
@@ -108,7 +128,11 @@ void HttpResponse::write(QByteArray data, bool lastPart)
     if(lastPart)
     {
       // Automatically set the Content-Length header
-      headers.insert("Content-Length", QByteArray::number(data.size()));
+      // Not for responses without body where a length of zero would be wrong
+      if(statusCode != 204 && statusCode != 304)
+      {
+        headers.insert("Content-Length", QByteArray::number(data.size()));
+      }
     }
     // else if we will not close the connection at the end and there is no Content-Length header,
     // then we must use the chunked mode.
@@ -153,7 +177,7 @@ void HttpResponse::write(QByteArray data, bool lastPart)
     {
       writeToSocket("0\r\n\r\n");
     }
-    socket->flush();
+    flush();
     sentLastPart = true;
   }
 }
@@ -186,10 +210,14 @@ void HttpResponse::redirect(const QByteArray& url)
 
 void HttpResponse::flush()
 {
-  socket->flush();
+  if(socket)
+  {
+    socket->flush();
+  }
 }
 
 bool HttpResponse::isConnected() const
 {
-  return socket->isOpen();
+  // Buffered responses are sent later by the event loop thread
+  return socket ? socket->isOpen() : true;
 }
@@ -44,6 +44,14 @@ public:
    */
   HttpResponse(QTcpSocket *socket);
 
+  /**
+   *  Constructor for a response which is collected in a buffer instead of being written to a socket.
+   *  Used by the event driven mode where the service runs in a worker thread while the
+   *  socket belongs to an event loop thread.
+   *  @param outputBuffer receives status line, headers and body. Must not be 0.
+   */
+  HttpResponse(QByteArray *outputBuffer);
+
   /**
    *  Set a HTTP response header.
    *  You must call this method before the first write().
@@ -128,6 +136,9 @@ private:
   /** Socket for writing output */
   QTcpSocket *socket;
 
+  /** Buffer for writing output if socket is 0 */
+  QByteArray *outputBuffer;
+
   /** HTTP status code*/
   int statusCode;
 
@@ -16,6 +16,9 @@ HttpSessionStore::HttpSessionStore(const QHash<QString, QVariant>& settings, QOb
   connect(&cleanupTimer, SIGNAL(timeout()), this, SLOT(sessionTimerEvent()));
   cleanupTimer.start(60000);
   cookieName = settings.value("cookieName", "sessionid").toByteArray();
+  cookiePath = settings.value("cookiePath").toByteArray();
+  cookieComment = settings.value("cookieComment").toByteArray();
+  cookieDomain = settings.value("cookieDomain").toByteArray();
   expirationTime = settings.value("expirationTime", 3600000).toInt();
   qDebug("HttpSessionStore: Sessions expire after %i milliseconds", expirationTime);
 }
@@ -25,10 +28,9 @@ HttpSessionStore::~HttpSessionStore()
   cleanupTimer.stop();
 }
 
-QByteArray HttpSessionStore::getSessionId(HttpRequest& request, HttpResponse& response)
+QByteArray HttpSessionStore::getCookieSessionId(HttpRequest& request, HttpResponse& response) const
 {
   // The session ID in the response has priority because this one will be used in the next request.
-  mutex.lock();
   // Get the session ID from the response cookie
   QByteArray sessionId = response.getCookies().value(cookieName).getValue();
   if(sessionId.isEmpty())
@@ -36,95 +38,132 @@ QByteArray HttpSessionStore::getSessionId(HttpRequest& request, HttpResponse& re
     // Get the session ID from the request cookie
     sessionId = request.getCookie(cookieName);
   }
+  return sessionId;
+}
+
+void HttpSessionStore::setSessionCookie(HttpResponse& response, const QByteArray& sessionId) const
+{
+  response.setCookie(HttpCookie(cookieName, sessionId, expirationTime / 1000,
+                                cookiePath, cookieComment, cookieDomain, false, false, "Lax"));
+}
+
+QByteArray HttpSessionStore::getSessionId(HttpRequest& request, HttpResponse& response)
+{
+  QByteArray sessionId = getCookieSessionId(request, response);
   // Clear the session ID if there is no such session in the storage.
   if(!sessionId.isEmpty())
   {
-    if(!sessions.contains(sessionId))
+    SessionShard& sessionShard = shard(sessionId);
+    sessionShard.mutex.lock();
+    bool found = sessionShard.sessions.contains(sessionId);
+    sessionShard.mutex.unlock();
+
+    if(!found)
     {
       qDebug("HttpSessionStore: received invalid session cookie with ID %s", sessionId.data());
       sessionId.clear();
     }
   }
-  mutex.unlock();
   return sessionId;
 }
 
 HttpSession HttpSessionStore::getSession(HttpRequest& request, HttpResponse& response, bool allowCreate)
 {
-  QByteArray sessionId = getSessionId(request, response);
-  mutex.lock();
+  QByteArray sessionId = getCookieSessionId(request, response);
   if(!sessionId.isEmpty())
   {
-    HttpSession session = sessions.value(sessionId);
+    SessionShard& sessionShard = shard(sessionId);
+    sessionShard.mutex.lock();
+    HttpSession session = sessionShard.sessions.value(sessionId);
+    sessionShard.mutex.unlock();
+
     if(!session.isNull())
     {
-      mutex.unlock();
       // Refresh the session cookie
-      QByteArray cookieName = settings.value("cookieName", "sessionid").toByteArray();
-      QByteArray cookiePath = settings.value("cookiePath").toByteArray();
-      QByteArray cookieComment = settings.value("cookieComment").toByteArray();
-      QByteArray cookieDomain = settings.value("cookieDomain").toByteArray();
-      response.setCookie(HttpCookie(cookieName, session.getId(), expirationTime / 1000,
-                                    cookiePath, cookieComment, cookieDomain, false, false, "Lax"));
+      setSessionCookie(response, session.getId());
       session.setLastAccess();
       return session;
     }
+    else
+    {
+      qDebug("HttpSessionStore: received invalid session cookie with ID %s", sessionId.data());
+    }
   }
   // Need to create a new session
   if(allowCreate)
   {
-    QByteArray cookieName = settings.value("cookieName", "sessionid").toByteArray();
-    QByteArray cookiePath = settings.value("cookiePath").toByteArray();
-    QByteArray cookieComment = settings.value("cookieComment").toByteArray();
-    QByteArray cookieDomain = settings.value("cookieDomain").toByteArray();
     HttpSession session(true);
     qDebug("HttpSessionStore: create new session with ID %s", session.getId().data());
-    sessions.insert(session.getId(), session);
-    response.setCookie(HttpCookie(cookieName, session.getId(), expirationTime / 1000,
-                                  cookiePath, cookieComment, cookieDomain, false, false, "Lax"));
-    mutex.unlock();
+    SessionShard& sessionShard = shard(session.getId());
+    sessionShard.mutex.lock();
+    sessionShard.sessions.insert(session.getId(), session);
+    sessionShard.expiry.push(ExpiryEntry(session.getLastAccess() + expirationTime, session.getId()));
+    sessionShard.mutex.unlock();
+    setSessionCookie(response, session.getId());
     return session;
   }
   // Return a null session
-  mutex.unlock();
   return HttpSession();
 }
 
 HttpSession HttpSessionStore::getSession(const QByteArray id)
 {
-  mutex.lock();
-  HttpSession session = sessions.value(id);
-  mutex.unlock();
+  SessionShard& sessionShard = shard(id);
+  sessionShard.mutex.lock();
+  HttpSession session = sessionShard.sessions.value(id);
+  sessionShard.mutex.unlock();
   session.setLastAccess();
   return session;
 }
 
 void HttpSessionStore::sessionTimerEvent()
 {
-  mutex.lock();
   qint64 now = QDateTime::currentMSecsSinceEpoch();
-  QMap<QByteArray, HttpSession>::iterator i = sessions.begin();
-  while(i != sessions.end())
+  QList<QByteArray> expiredIds;
+  for(SessionShard& sessionShard : shards)
   {
-    QMap<QByteArray, HttpSession>::iterator prev = i;
-    ++i;
-    HttpSession session = prev.value();
-    qint64 lastAccess = session.getLastAccess();
-    if(now - lastAccess > expirationTime)
+    sessionShard.mutex.lock();
+    // Look only at entries which are due - the heap top has the earliest time
+    while(!sessionShard.expiry.empty() && sessionShard.expiry.top().first < now)
     {
-      qDebug("HttpSessionStore: session %s expired", session.getId().data());
-      emit sessionDeleted(session.getId());
-      sessions.erase(prev);
+      QByteArray sessionId = sessionShard.expiry.top().second;
+      sessionShard.expiry.pop();
+
+      // Entry is stale if session was removed already
+      auto it = sessionShard.sessions.find(sessionId);
+      if(it != sessionShard.sessions.end())
+      {
+        qint64 lastAccess = it.value().getLastAccess();
+        if(now - lastAccess > expirationTime)
+        {
+          qDebug("HttpSessionStore: session %s expired", sessionId.data());
+          expiredIds.append(sessionId);
+          sessionShard.sessions.erase(it);
+        }
+        else
+        {
+          // Session was used in the meantime - put back with updated time
+          sessionShard.expiry.push(ExpiryEntry(lastAccess + expirationTime, sessionId));
+        }
+      }
     }
+    sessionShard.mutex.unlock();
+  }
+
+  // Notify outside of locks
+  for(const QByteArray& sessionId : expiredIds)
+  {
+    emit sessionDeleted(sessionId);
   }
-  mutex.unlock();
 }
 
 /** Delete a session */
 void HttpSessionStore::removeSession(HttpSession session)
 {
-  mutex.lock();
   emit sessionDeleted(session.getId());
-  sessions.remove(session.getId());
-  mutex.unlock();
+  SessionShard& sessionShard = shard(session.getId());
+  sessionShard.mutex.lock();
+  // Heap entry is dropped lazily in the cleanup
+  sessionShard.sessions.remove(session.getId());
+  sessionShard.mutex.unlock();
 }
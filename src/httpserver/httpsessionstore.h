@@ -7,9 +7,12 @@
 #define HTTPSESSIONSTORE_H
 
 #include <QObject>
-#include <QMap>
+#include <QHash>
 #include <QTimer>
 #include <QMutex>
+#include <functional>
+#include <queue>
+#include <vector>
 #include "httpglobal.h"
 #include "httpsession.h"
 #include "httpresponse.h"
@@ -30,6 +33,10 @@ namespace stefanfrings {
  *  cookieComment=Session ID
  *  ;cookieDomain=stefanfrings.de
  *  </pre></code>
+ *  Sessions are distributed over a number of shards by the hash of their ID. Each shard
+ *  has its own lock so requests for different sessions do not block each other.
+ *  Each shard keeps a heap ordered by expiration time which allows the cleanup timer to look
+ *  only at sessions which might have expired instead of scanning all sessions.
  */
 
 class DECLSPEC HttpSessionStore :
@@ -89,11 +96,41 @@ public:
   /** Delete a session */
   void removeSession(const HttpSession session);
 
-protected:
-  /** Storage for the sessions */
-  QMap<QByteArray, HttpSession> sessions;
-
 private:
+  /** Number of independently locked shards */
+  static const int NUM_SHARDS = 16;
+
+  /** Expiration time and ID of a session in the expiry heap */
+  typedef std::pair<qint64, QByteArray> ExpiryEntry;
+
+  /** Part of the session storage with own lock */
+  struct SessionShard
+  {
+    /** Storage for the sessions */
+    QHash<QByteArray, HttpSession> sessions;
+
+    /**
+     *  Min heap with one entry per session. The stored time can be outdated since sessions
+     *  are refreshed without touching the heap. It is checked and renewed in the cleanup.
+     */
+    std::priority_queue<ExpiryEntry, std::vector<ExpiryEntry>, std::greater<ExpiryEntry> > expiry;
+
+    /** Used to synchronize threads */
+    QMutex mutex;
+  };
+
+  /** Get the shard for a session ID */
+  SessionShard& shard(const QByteArray& sessionId)
+  {
+    return shards[qHash(sessionId) % NUM_SHARDS];
+  }
+
+  /** Set the session cookie in the response */
+  void setSessionCookie(HttpResponse& response, const QByteArray& sessionId) const;
+
+  /** Get the session ID from the response or request cookie without checking the storage */
+  QByteArray getCookieSessionId(HttpRequest& request, HttpResponse& response) const;
+
   /** Configuration settings */
   QHash<QString, QVariant> settings;
 
@@ -103,14 +140,17 @@ private:
   /** Name of the session cookie */
   QByteArray cookieName;
 
+  /** Cookie attributes read from settings */
+  QByteArray cookiePath, cookieComment, cookieDomain;
+
   /** Time when sessions expire (in ms)*/
   int expirationTime;
 
-  /** Used to synchronize threads */
-  QMutex mutex;
+  /** Session storage */
+  SessionShard shards[NUM_SHARDS];
 
 private slots:
-  /** Called every minute to cleanup expired sessions. */
+  /** Called every minute to cleanup expired sessions. Only looks at sessions which are due in the heaps. */
   void sessionTimerEvent();
 
 signals:
@@ -9,6 +9,8 @@
 #include <QDateTime>
 #include <QThread>
 #include <QCoreApplication>
+#include <algorithm>
+#include "zip/gzip.h"
 
 using namespace stefanfrings;
 
@@ -31,32 +33,47 @@ StaticFileController::StaticFileController(const QHash<QString, QVariant>& setti
 
   qDebug("StaticFileController: docroot=%s, encoding=%s, maxAge=%i", qPrintable(docroot), qPrintable(encoding), maxAge);
   maxCachedFileSize = settings.value("maxCachedFileSize", "65536").toInt();
-  cache.setMaxCost(settings.value("cacheSize", "1000000").toInt());
+  gzip = settings.value("gzip", "true").toBool();
+  int cacheMaxCost = settings.value("cacheSize", "1000000").toInt();
+
+  // Entry cost is document plus compressed variant - use fewer shards for small caches
+  // to fit at least one file of maximum size while keeping the sum at cacheMaxCost
+  numShards = std::max(1, std::min(NUM_SHARDS, cacheMaxCost / std::max(1, 2 * maxCachedFileSize)));
+  for(int i = 0; i < numShards; i++)
+    shards[i].cache.setMaxCost(cacheMaxCost / numShards);
   cacheTimeout = settings.value("cacheTime", "60000").toInt();
-  long int cacheMaxCost = (long int)cache.maxCost();
-  qDebug("StaticFileController: cache timeout=%i, size=%li", cacheTimeout, cacheMaxCost);
+  qDebug("StaticFileController: cache timeout=%i, size=%i, shards=%i, gzip=%i", cacheTimeout, cacheMaxCost, numShards, gzip);
 }
 
 void StaticFileController::service(HttpRequest& request, HttpResponse& response)
 {
   QByteArray path = request.getPath();
+  CacheShard& cacheShard = shard(path);
+
   // Check if we have the file in cache
   qint64 now = QDateTime::currentMSecsSinceEpoch();
-  mutex.lock();
-  CacheEntry *entry = cache.object(path);
+  cacheShard.mutex.lock();
+  CacheEntry *entry = cacheShard.cache.object(path);
   if(entry && (cacheTimeout == 0 || entry->created > now - cacheTimeout))
   {
-    QByteArray document = entry->document; // copy the cached document, because other threads may destroy the cached entry immediately after mutex unlock.
+    // copy the cached document, because other threads may destroy the cached entry immediately after mutex unlock.
+    // Copies are cheap since QByteArray is implicitly shared.
+    QByteArray document = entry->document;
+    QByteArray gzipDocument = entry->gzipDocument;
+    QByteArray etag = entry->etag;
     QByteArray filename = entry->filename;
-    mutex.unlock();
+    cacheShard.mutex.unlock();
     qDebug("StaticFileController: Cache hit for %s", path.data());
     setContentType(filename, response);
     response.setHeader("Cache-Control", "max-age=" + QByteArray::number(maxAge / 1000));
-    response.write(document, true);
+    if(!notModified(etag, request, response))
+    {
+      writeDocument(document, gzipDocument, request, response);
+    }
   }
   else
   {
-    mutex.unlock();
+    cacheShard.mutex.unlock();
     // The file is not in cache.
     qDebug("StaticFileController: Cache miss for %s", path.data());
     // Forbid access to files outside the docroot directory
@@ -77,31 +94,62 @@ void StaticFileController::service(HttpRequest& request, HttpResponse& response)
     qDebug("StaticFileController: Open file %s", qPrintable(file.fileName()));
     if(file.open(QIODevice::ReadOnly))
     {
+      QByteArray etag = etagForFile(file);
       setContentType(path, response);
       response.setHeader("Cache-Control", "max-age=" + QByteArray::number(maxAge / 1000));
-      response.setHeader("Content-Length", QByteArray::number(file.size()));
+      if(notModified(etag, request, response))
+      {
+        file.close();
+        return;
+      }
+
       if(file.size() <= maxCachedFileSize)
       {
         // Return the file content and store it also in the cache
         entry = new CacheEntry();
-        while(!file.atEnd() && !file.error())
+        entry->document = file.readAll();
+        if(gzip && isCompressible(path))
         {
-          QByteArray buffer = file.read(65536);
-          response.write(buffer);
-          entry->document.append(buffer);
+          // Build compressed variant once and keep it only if it saves space
+          QByteArray compressed = atools::zip::gzipCompress(entry->document);
+          if(!compressed.isEmpty() && compressed.size() < entry->document.size())
+          {
+            entry->gzipDocument = compressed;
+          }
         }
+        entry->etag = etag;
         entry->created = now;
         entry->filename = path;
-        mutex.lock();
-        cache.insert(request.getPath(), entry, entry->document.size());
-        mutex.unlock();
+
+        writeDocument(entry->document, entry->gzipDocument, request, response);
+
+        cacheShard.mutex.lock();
+        cacheShard.cache.insert(request.getPath(), entry, entry->document.size() + entry->gzipDocument.size());
+        cacheShard.mutex.unlock();
       }
       else
       {
         // Return the file content, do not store in cache
-        while(!file.atEnd() && !file.error())
+        response.setHeader("Content-Length", QByteArray::number(file.size()));
+
+        // Map large files into memory to avoid copying them into buffers - not possible for resources
+        uchar *mapped = file.map(0, file.size());
+        if(mapped != nullptr)
         {
-          response.write(file.read(65536));
+          const char *data = reinterpret_cast<const char *>(mapped);
+          for(qint64 offset = 0; offset < file.size(); offset += 65536)
+          {
+            response.write(QByteArray::fromRawData(data + offset,
+                                                   static_cast<int>(std::min(file.size() - offset, qint64(65536)))));
+          }
+          file.unmap(mapped);
+        }
+        else
+        {
+          while(!file.atEnd() && !file.error())
+          {
+            response.write(file.read(65536));
+          }
         }
       }
       file.close();
@@ -123,6 +171,96 @@ void StaticFileController::service(HttpRequest& request, HttpResponse& response)
   }
 }
 
+QByteArray StaticFileController::etagForFile(const QFile& file)
+{
+  QFileInfo fileInfo(file);
+  return '"' + QByteArray::number(fileInfo.size(), 16) + '-' +
+         QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch(), 16) + '"';
+}
+
+bool StaticFileController::notModified(const QByteArray& etag, HttpRequest& request, HttpResponse& response) const
+{
+  response.setHeader("ETag", etag);
+
+  QByteArray ifNoneMatch = request.getHeader("If-None-Match");
+  if(!ifNoneMatch.isEmpty() && !etag.isEmpty())
+  {
+    // Header can contain a list of tags or "*"
+    for(const QByteArray& tag : ifNoneMatch.split(','))
+    {
+      QByteArray trimmed = tag.trimmed();
+      if(trimmed.startsWith("W/"))
+      {
+        trimmed = trimmed.mid(2);
+      }
+
+      if(trimmed == etag || trimmed == "*")
+      {
+        response.setStatus(304, "Not Modified");
+        response.write(QByteArray(), true);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void StaticFileController::writeDocument(const QByteArray& document, const QByteArray& gzipDocument,
+                                         HttpRequest& request, HttpResponse& response) const
+{
+  if(!gzipDocument.isEmpty())
+  {
+    // Caches have to keep both variants
+    response.setHeader("Vary", "Accept-Encoding");
+    if(acceptsGzip(request.getHeader("Accept-Encoding")))
+    {
+      response.setHeader("Content-Encoding", "gzip");
+      response.write(gzipDocument, true);
+      return;
+    }
+  }
+  response.write(document, true);
+}
+
+bool StaticFileController::acceptsGzip(const QByteArray& acceptEncoding)
+{
+  // List of codings with optional quality like "gzip;q=0.8, deflate, *;q=0" where q=0 means not acceptable
+  int gzipAccepted = -1, anyAccepted = -1;
+  for(const QByteArray& coding : acceptEncoding.split(','))
+  {
+    QList<QByteArray> params = coding.split(';');
+    QByteArray name = params.first().trimmed().toLower();
+    bool accepted = true;
+    for(int i = 1; i < params.size(); i++)
+    {
+      QByteArray param = params.at(i).trimmed().toLower();
+      if(param.startsWith("q="))
+      {
+        accepted = param.mid(2).toDouble() > 0.;
+      }
+    }
+
+    if(name == "gzip" || name == "x-gzip")
+    {
+      gzipAccepted = accepted;
+    }
+    else if(name == "*")
+    {
+      anyAccepted = accepted;
+    }
+  }
+
+  // Explicit gzip entry takes precedence over wildcard
+  return gzipAccepted != -1 ? gzipAccepted == 1 : anyAccepted == 1;
+}
+
+bool StaticFileController::isCompressible(const QString& fileName) const
+{
+  return fileName.endsWith(".html") || fileName.endsWith(".htm") || fileName.endsWith(".css") ||
+         fileName.endsWith(".js") || fileName.endsWith(".json") || fileName.endsWith(".svg") ||
+         fileName.endsWith(".txt") || fileName.endsWith(".xml");
+}
+
 void StaticFileController::setContentType(const QString fileName, HttpResponse& response) const
 {
   if(fileName.endsWith(".png"))
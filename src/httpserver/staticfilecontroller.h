@@ -27,6 +27,7 @@ namespace stefanfrings {
  *  cacheTime=60000
  *  cacheSize=1000000
  *  maxCachedFileSize=65536
+ *  gzip=true
  *  </pre></code>
  *  The path is relative to the directory of the config file. In case of windows, if the
  *  settings are in the registry, the path is relative to the current working directory.
@@ -36,6 +37,16 @@ namespace stefanfrings {
  *  The cache improves performance of small files when loaded from a network
  *  drive. Large files are not cached. Files are cached as long as possible,
  *  when cacheTime=0. The maxAge value (in msec!) controls the remote browsers cache.
+ *  The cache is split into shards with separate locks to avoid contention between handler threads.
+ *  The cacheSize is divided evenly between the shards. Fewer shards are used if cacheSize is too small
+ *  to hold two files of maxCachedFileSize per shard, so the total never exceeds cacheSize.
+ *  <p>
+ *  Text files in the cache get a gzip compressed variant which is built once and sent if the browser
+ *  accepts it. Disable with gzip=false.
+ *  Large files which are not cached are memory mapped and sent without copying them into a buffer.
+ *  <p>
+ *  An ETag built from file size and modification time is sent with each file. Requests with a
+ *  matching If-None-Match header get a 304 response without body.
  *  <p>
  *  Do not instantiate this class in each request, because this would make the file cache
  *  useless. Better create one instance during start-up and call it when the application
@@ -77,25 +88,66 @@ private:
   struct CacheEntry
   {
     QByteArray document;
+
+    /** gzip compressed document or empty if not compressible */
+    QByteArray gzipDocument;
+    QByteArray etag;
     qint64 created;
     QByteArray filename;
   };
 
+  /** Part of the cache with its own lock */
+  struct CacheShard
+  {
+    /** Cache storage */
+    QCache<QString, CacheEntry> cache;
+
+    /** Used to synchronize cache access for threads */
+    QMutex mutex;
+  };
+
+  /** Maximum number of cache shards */
+  static const int NUM_SHARDS = 16;
+
+  /** Number of shards in use depending on cache size */
+  int numShards;
+
   /** Timeout for each cached file */
   int cacheTimeout;
 
   /** Maximum size of files in cache, larger files are not cached */
   int maxCachedFileSize;
 
-  /** Cache storage */
-  QCache<QString, CacheEntry> cache;
+  /** Build compressed variants for text files */
+  bool gzip;
+
+  /** Cache storage split by hash of path */
+  CacheShard shards[NUM_SHARDS];
 
-  /** Used to synchronize cache access for threads */
-  QMutex mutex;
+  CacheShard& shard(const QString& path)
+  {
+    return shards[qHash(path) % static_cast<uint>(numShards)];
+  }
 
   /** Set a content-type header in the response depending on the ending of the filename */
   void setContentType(const QString file, HttpResponse& response) const;
 
+  /** true if the file is text and worth compressing */
+  bool isCompressible(const QString& fileName) const;
+
+  /** Send 304 and return true if the client already has the file */
+  bool notModified(const QByteArray& etag, HttpRequest& request, HttpResponse& response) const;
+
+  /** Send document or compressed variant if accepted */
+  void writeDocument(const QByteArray& document, const QByteArray& gzipDocument, HttpRequest& request,
+                     HttpResponse& response) const;
+
+  /** Build ETag from size and last modification time */
+  static QByteArray etagForFile(const QFile& file);
+
+  /** true if gzip is acceptable according to the Accept-Encoding header value including quality values */
+  static bool acceptsGzip(const QByteArray& acceptEncoding);
+
 };
 
 } // end of namespace
@@ -0,0 +1,228 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "logging/loggingasync.h"
+#include "logging/loggingconfig.h"
+
+#include <QTextStream>
+
+namespace atools {
+namespace logging {
+namespace internal {
+
+// ================================================================================================
+LogRingBuffer::LogRingBuffer(int capacity)
+{
+  quint64 size = 2;
+  while(size < static_cast<quint64>(capacity))
+    size <<= 1;
+
+  ringSlots = std::vector<Slot>(size);
+  mask = size - 1;
+
+  // Sequence equal to position means slot is free for the producer at this position
+  for(quint64 i = 0; i < size; i++)
+    ringSlots[i].sequence.store(i, std::memory_order_relaxed);
+
+  enqueuePos.store(0, std::memory_order_relaxed);
+  dequeuePos.store(0, std::memory_order_relaxed);
+}
+
+bool LogRingBuffer::push(LogRecord& record)
+{
+  Slot *slot;
+  quint64 pos = enqueuePos.load(std::memory_order_relaxed);
+  while(true)
+  {
+    slot = &ringSlots[pos & mask];
+    quint64 seq = slot->sequence.load(std::memory_order_acquire);
+    qint64 diff = static_cast<qint64>(seq) - static_cast<qint64>(pos);
+
+    if(diff == 0)
+    {
+      // Slot is free - try to reserve it
+      if(enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        break;
+    }
+    else if(diff < 0)
+      // Slot still contains a record one round behind - full
+      return false;
+    else
+      // Another producer was faster
+      pos = enqueuePos.load(std::memory_order_relaxed);
+  }
+
+  slot->record = std::move(record);
+
+  // Publish to consumer
+  slot->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool LogRingBuffer::pop(LogRecord& record)
+{
+  quint64 pos = dequeuePos.load(std::memory_order_relaxed);
+  Slot *slot = &ringSlots[pos & mask];
+
+  // Not published yet
+  if(slot->sequence.load(std::memory_order_acquire) != pos + 1)
+    return false;
+
+  record = std::move(slot->record);
+  slot->record = LogRecord();
+
+  // Free slot for producers in the next round
+  slot->sequence.store(pos + mask + 1, std::memory_order_release);
+  dequeuePos.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+// ================================================================================================
+LoggingWriterThread::LoggingWriterThread(LoggingConfig *config, QMutex *streamMutex, int queueSize,
+                                         LoggingOverflow overflowPolicy)
+  : logConfig(config), mutex(streamMutex), overflow(overflowPolicy), buffer(queueSize)
+{
+  setObjectName("LoggingWriterThread");
+  terminate.store(false);
+  idle.store(false);
+  numDropped.store(0);
+  numDroppedReported.store(0);
+}
+
+LoggingWriterThread::~LoggingWriterThread()
+{
+  stop();
+}
+
+void LoggingWriterThread::enqueue(LogRecord& record)
+{
+  if(!buffer.push(record))
+  {
+    // Never block the writer itself or after stopping since nobody would empty the queue
+    if(overflow == OVERFLOW_DROP || QThread::currentThread() == this || terminate.load())
+    {
+      numDropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    // Block until writer made room ==============
+    while(!buffer.push(record))
+    {
+      waitMutex.lock();
+      dataAvailable.wakeOne();
+      spaceAvailable.wait(&waitMutex, 10);
+      waitMutex.unlock();
+    }
+  }
+
+  // Wake writer only if it is waiting to avoid locking for each message
+  if(idle.load())
+  {
+    waitMutex.lock();
+    dataAvailable.wakeOne();
+    waitMutex.unlock();
+  }
+}
+
+void LoggingWriterThread::flush()
+{
+  mutex->lock();
+  writeQueued();
+  mutex->unlock();
+
+  waitMutex.lock();
+  spaceAvailable.wakeAll();
+  waitMutex.unlock();
+}
+
+void LoggingWriterThread::stop()
+{
+  if(isRunning())
+  {
+    terminate.store(true);
+    waitMutex.lock();
+    dataAvailable.wakeOne();
+    waitMutex.unlock();
+    wait();
+  }
+
+  // Write anything which came in after the thread stopped
+  flush();
+}
+
+void LoggingWriterThread::run()
+{
+  while(!terminate.load())
+  {
+    mutex->lock();
+    writeQueued();
+    mutex->unlock();
+
+    waitMutex.lock();
+    spaceAvailable.wakeAll();
+
+    // Producers wake this thread if idle is set - timeout covers the case
+    // where a record is published just after checking the buffer
+    idle.store(true);
+    if(buffer.isEmpty() && !terminate.load())
+      dataAvailable.wait(&waitMutex, 100);
+    idle.store(false);
+    waitMutex.unlock();
+  }
+}
+
+void LoggingWriterThread::writeQueued()
+{
+  // Channels written in this batch for flushing
+  ChannelVector written;
+
+  LogRecord record;
+  while(buffer.pop(record))
+  {
+    for(Channel *channel : *record.channels)
+    {
+      // No endl to avoid flushing each message
+      (*channel->stream) << record.message << '\n';
+      if(!written.contains(channel))
+        written.append(channel);
+    }
+  }
+
+  // Report dropped messages to the warning channels ==============
+  quint64 dropped = numDropped.load(std::memory_order_relaxed);
+  quint64 reported = numDroppedReported.load(std::memory_order_relaxed);
+  if(dropped > reported)
+  {
+    for(Channel *channel : logConfig->getStream(QtWarningMsg))
+    {
+      (*channel->stream) << "LoggingWriterThread: Queue full. Dropped " << (dropped - reported) << " messages." << '\n';
+      if(!written.contains(channel))
+        written.append(channel);
+    }
+    numDroppedReported.store(dropped, std::memory_order_relaxed);
+  }
+
+  for(Channel *channel : written)
+  {
+    channel->stream->flush();
+    logConfig->checkStreamSize(channel);
+  }
+}
+
+} // namespace internal
+} // namespace logging
+} // namespace atools
@@ -0,0 +1,143 @@
+/*****************************************************************************
+* Copyright 2015-2023 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef ATOOLS_LOGGINGASYNC_H
+#define ATOOLS_LOGGINGASYNC_H
+
+#include "logging/loggingtypes.h"
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <vector>
+
+namespace atools {
+namespace logging {
+namespace internal {
+
+class LoggingConfig;
+
+/* Formatted log message and the channels it has to be written to */
+struct LogRecord
+{
+  QString message;
+  const ChannelVector *channels = nullptr;
+};
+
+/*
+ * Bounded lock-free queue for many producers and one consumer.
+ *
+ * Each slot has a sequence number which tells producers and consumer if the slot is free or filled.
+ * Producers reserve a slot by incrementing the enqueue position with compare and swap.
+ * Only one thread at a time is allowed to call pop().
+ */
+class LogRingBuffer
+{
+public:
+  /* Capacity is rounded up to the next power of two */
+  explicit LogRingBuffer(int capacity);
+
+  LogRingBuffer(const LogRingBuffer& other) = delete;
+  LogRingBuffer& operator=(const LogRingBuffer& other) = delete;
+
+  /* Returns false if buffer is full */
+  bool push(LogRecord& record);
+
+  /* Returns false if buffer is empty */
+  bool pop(LogRecord& record);
+
+  bool isEmpty() const
+  {
+    return enqueuePos.load(std::memory_order_acquire) == dequeuePos.load(std::memory_order_acquire);
+  }
+
+private:
+  struct Slot
+  {
+    std::atomic<quint64> sequence;
+    LogRecord record;
+  };
+
+  std::vector<Slot> ringSlots;
+  quint64 mask;
+  std::atomic<quint64> enqueuePos, dequeuePos;
+};
+
+/* What to do if the queue is full */
+enum LoggingOverflow
+{
+  OVERFLOW_BLOCK, /* Wait until writer thread made room */
+  OVERFLOW_DROP /* Discard message and count it */
+};
+
+/*
+ * Background thread which takes formatted messages from the queue and writes them into the channel streams.
+ * Streams are flushed and checked for rolling once per batch instead of once per message.
+ *
+ * The given mutex has to be locked for all stream access. It also serializes pop() between
+ * this thread and flush().
+ */
+class LoggingWriterThread :
+  public QThread
+{
+  Q_OBJECT
+
+public:
+  LoggingWriterThread(LoggingConfig *config, QMutex *streamMutex, int queueSize, LoggingOverflow overflowPolicy);
+  virtual ~LoggingWriterThread() override;
+
+  /* Add message to the queue. Thread safe. Blocks or drops depending on policy if queue is full. */
+  void enqueue(LogRecord& record);
+
+  /* Write all queued messages in the calling thread. Used on abort and shutdown.
+   * Caller must not hold the stream mutex. */
+  void flush();
+
+  /* Stop thread after writing all pending messages and wait for it */
+  void stop();
+
+  quint64 getNumDropped() const
+  {
+    return numDropped.load(std::memory_order_relaxed);
+  }
+
+private:
+  virtual void run() override;
+
+  /* Write all queued records and flush streams. Has to be called with stream mutex locked. */
+  void writeQueued();
+
+  LoggingConfig *logConfig;
+  QMutex *mutex;
+  LoggingOverflow overflow;
+  LogRingBuffer buffer;
+
+  /* Used to wake up the writer thread when idle or blocked producers when room is available */
+  QMutex waitMutex;
+  QWaitCondition dataAvailable, spaceAvailable;
+
+  std::atomic<bool> terminate, idle;
+  std::atomic<quint64> numDropped, numDroppedReported;
+};
+
+} // namespace internal
+} // namespace logging
+} // namespace atools
+
+#endif // ATOOLS_LOGGINGASYNC_H
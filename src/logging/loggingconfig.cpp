@@ -336,6 +336,17 @@ void LoggingConfig::readConfigurationSection(QSettings *settings)
   rolling = settings->value("configuration/files").toString() == "roll";
   maximumBackupFiles = settings->value("configuration/maxfiles").toInt();
 
+  async = settings->value("configuration/async", false).toBool();
+  asyncQueueSize = std::max(settings->value("configuration/asyncqueuesize", 8192).toInt(), 16);
+
+  QString overflow = settings->value("configuration/asyncoverflow", QVariant("block")).toString();
+  if(overflow == "drop")
+    asyncDrop = true;
+  else if(overflow == "block")
+    asyncDrop = false;
+  else
+    qWarning() << "Invalid value for configuration/asyncoverflow:" << overflow << "use either block (default) or drop.";
+
   QString abortOn = settings->value("configuration/abort", QVariant("fatal")).toString();
   if(abortOn == "warning")
     abortType = QtWarningMsg;
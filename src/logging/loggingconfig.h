@@ -32,6 +32,8 @@ namespace logging {
 class LoggingHandler;
 namespace internal {
 
+class LoggingWriterThread;
+
 /* Internal logging class that reads the configuration and sets up all the
  * streams. */
 class LoggingConfig
@@ -45,6 +47,7 @@ public:
 
 private:
   friend class atools::logging::LoggingHandler;
+  friend class atools::logging::internal::LoggingWriterThread;
 
   /* get a list of log files (excluding stdout and stderr) */
   QStringList getLogFiles(bool includeBackups) const;
@@ -120,6 +123,15 @@ private:
   /* Shorten file and method names if true. */
   bool narrow = false;
 
+  /* Write messages in a background thread if true */
+  bool async = false;
+
+  /* Maximum number of queued messages for async mode */
+  int asyncQueueSize = 8192;
+
+  /* Drop messages instead of waiting if async queue is full */
+  bool asyncDrop = false;
+
   QString logConfig, logDir, logPrefix;
 
   // Messages of this type or worse cause a call to abort()
@@ -17,6 +17,7 @@
 
 #include "logging/logginghandler.h"
 #include "logging/loggingconfig.h"
+#include "logging/loggingasync.h"
 
 #include <QDebug>
 #include <QDir>
@@ -45,6 +46,13 @@ LoggingHandler::LoggingHandler(const QString& logConfiguration,
 {
   logConfig = new LoggingConfig(logConfiguration, logDirectory, logFilePrefix);
 
+  if(logConfig->async)
+  {
+    writerThread = new internal::LoggingWriterThread(logConfig, &mutex, logConfig->asyncQueueSize,
+                                                     logConfig->asyncDrop ? internal::OVERFLOW_DROP : internal::OVERFLOW_BLOCK);
+    writerThread->start(QThread::LowPriority);
+  }
+
   // Override category filter since some systems disable debug logging in the qtlogging.ini
   oldCategoryFilter = QLoggingCategory::installFilter(categoryFilter);
 
@@ -59,6 +67,15 @@ LoggingHandler::~LoggingHandler()
 {
   qInstallMessageHandler(oldMessageHandler);
   QLoggingCategory::installFilter(oldCategoryFilter);
+
+  if(writerThread != nullptr)
+  {
+    // Write all pending messages before closing streams
+    writerThread->stop();
+    delete writerThread;
+    writerThread = nullptr;
+  }
+
   delete logConfig;
 }
 
@@ -142,7 +159,44 @@ void LoggingHandler::logToCatChannels(internal::ChannelMap& streamListCat,
   }
 }
 
-void LoggingHandler::checkAbortType(QtMsgType type, const QMessageLogContext& context, const QString& msg)
+void LoggingHandler::logMessage(QtMsgType type, const QMessageLogContext& context, const QString& msg,
+                                const QString& category)
+{
+  internal::ChannelVector& streamList = logConfig->getStream(type);
+  internal::ChannelMap& streamListCat = logConfig->getCatStream(type);
+
+  if(writerThread != nullptr && !isAbortType(type))
+  {
+    // Async mode - format here and leave writing to the thread ===============
+    internal::LogRecord record;
+    if(category.isEmpty())
+      record.channels = &streamList;
+    else
+    {
+      auto it = streamListCat.constFind(category);
+      if(it != streamListCat.constEnd())
+        record.channels = &it.value();
+    }
+
+    if(record.channels != nullptr && !record.channels->isEmpty())
+    {
+      record.message = qFormatLogMessage(type, context, msg);
+      writerThread->enqueue(record);
+    }
+  }
+  else
+  {
+    // Write all pending messages synchronously before this one in async mode since application stops
+    if(writerThread != nullptr)
+      writerThread->flush();
+
+    logToCatChannels(streamListCat, streamList, qFormatLogMessage(type, context, msg), category);
+  }
+
+  checkAbortType(type, context, msg);
+}
+
+bool LoggingHandler::isAbortType(QtMsgType type) const
 {
   QtMsgType abortType = logConfig->getAbortType();
   bool doAbort = false;
@@ -164,8 +218,12 @@ void LoggingHandler::checkAbortType(QtMsgType type, const QMessageLogContext& co
       doAbort = abortType == QtWarningMsg || abortType == QtCriticalMsg || abortType == QtFatalMsg;
       break;
   }
+  return doAbort;
+}
 
-  if(doAbort)
+void LoggingHandler::checkAbortType(QtMsgType type, const QMessageLogContext& context, const QString& msg)
+{
+  if(isAbortType(type))
   {
     if(abortFunc)
       abortFunc(type, context, msg);
@@ -185,10 +243,7 @@ void LoggingHandler::messageHandler(QtMsgType type, const QMessageLogContext& co
   if(category == DEFAULT)
     category.clear();
 
-  instance->logToCatChannels(instance->logConfig->getCatStream(type), instance->logConfig->getStream(type),
-                             qFormatLogMessage(type, context, msg), category);
-
-  instance->checkAbortType(type, context, msg);
+  instance->logMessage(type, context, msg, category);
 }
 
 void LoggingHandler::messageHandlerNarrow(QtMsgType type, const QMessageLogContext& context, const QString& msg)
@@ -273,10 +328,7 @@ void LoggingHandler::messageHandlerNarrow(QtMsgType type, const QMessageLogConte
   if(category == DEFAULT)
     category.clear();
 
-  instance->logToCatChannels(instance->logConfig->getCatStream(type), instance->logConfig->getStream(type),
-                             qFormatLogMessage(type, ctx, message), category);
-
-  instance->checkAbortType(type, ctx, message);
+  instance->logMessage(type, ctx, message, category);
 
   // Null pointers to avoid double free
   ctx.file = nullptr;
@@ -34,6 +34,7 @@ namespace atools {
 namespace logging {
 namespace internal {
 class LoggingConfig;
+class LoggingWriterThread;
 }
 
 class LoggingGuiAbortHandler;
@@ -55,6 +56,13 @@ class LoggingGuiAbortHandler;
  * maxfiles = 2
  * abort = fatal
  *
+ * # Format messages on the calling thread and write them in a background thread.
+ * # Messages causing an abort and all pending messages are written synchronously before aborting.
+ * async = true
+ * asyncqueuesize = 8192
+ * # Either block (default) to wait for the writer or drop to discard messages if the queue is full
+ * asyncoverflow = block
+ *
  * [channels]
  * console     = stdio
  * console-err = stderr
@@ -146,6 +154,12 @@ private:
   void logToCatChannels(atools::logging::internal::ChannelMap& streamListCat, atools::logging::internal::ChannelVector& streamList,
                         const QString& message, const QString& category = QString());
 
+  /* Format message and write it to channels or pass it to the writer thread in async mode. Checks for abort. */
+  void logMessage(QtMsgType type, const QMessageLogContext& context, const QString& msg, const QString& category);
+
+  /* true if message type causes an abort with the current configuration */
+  bool isAbortType(QtMsgType type) const;
+
   void checkAbortType(QtMsgType type, const QMessageLogContext& context, const QString& msg);
 
   static void messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg);
@@ -156,6 +170,9 @@ private:
   static LoggingHandler *instance;
 
   atools::logging::internal::LoggingConfig *logConfig;
+
+  /* Not null if running in async mode */
+  atools::logging::internal::LoggingWriterThread *writerThread = nullptr;
   QtMessageHandler oldMessageHandler = nullptr;
   QLoggingCategory::CategoryFilter oldCategoryFilter = nullptr;
 
@@ -177,7 +177,7 @@ int RouteNetwork::searchNearest(Result& result, const Node& origin,
       if(excludeIndexes != nullptr)
         ok &= !excludeIndexes->contains(index);
 
-      const Point3D& curPt = points[index];
+      const Point3D curPt(pointsX[index], pointsY[index], pointsZ[index]);
 
       if(ok)
       {
@@ -221,7 +221,7 @@ int RouteNetwork::searchNearest(Result& result, const Node& origin,
     // All distances in meter
     float originToDestDist = 0.f, radiusMin = 0.f, directDistFactor = 1.f;
     Point3D origin, dest;
-    const Point3D *points;
+    const float *pointsX, *pointsY, *pointsZ;
     bool radionav = false, originDeparture = false;
     const QSet<int> *excludeIndexes = nullptr;
   };
@@ -229,7 +229,9 @@ int RouteNetwork::searchNearest(Result& result, const Node& origin,
   // Prepare callback with data =========================
   RadiusCallback callbackObj;
   callbackObj.origin = nodeToCartesian(origin);
-  callbackObj.points = nodeIndex.getPoints3D();
+  callbackObj.pointsX = nodeIndex.getPointsX();
+  callbackObj.pointsY = nodeIndex.getPointsY();
+  callbackObj.pointsZ = nodeIndex.getPointsZ();
   callbackObj.excludeIndexes = (excludeIndexes == nullptr || excludeIndexes->isEmpty()) ? nullptr : excludeIndexes;
   callbackObj.radionav = isRadionavRouting();
   callbackObj.originDeparture = origin.isDeparture();
@@ -383,7 +385,7 @@ void RouteNetwork::setNearestDestDistanceNm(float value)
   nearestDestDistanceM = nmToMeter(value);
 }
 
-const geo::Point3D& RouteNetwork::point3D(int index) const
+geo::Point3D RouteNetwork::point3D(int index) const
 {
   const static Point3D INVALID;
 
@@ -202,7 +202,7 @@ private:
   bool matchEdge(const atools::routing::Edge& edge) const;
 
   /* Get point in 3D space. Returns destination or departure for appropriate indexes. */
-  const atools::geo::Point3D& point3D(int index) const;
+  atools::geo::Point3D point3D(int index) const;
 
   /* All distances in meter */
   float minNearestDistanceRadioM, maxNearestDistanceRadioM,
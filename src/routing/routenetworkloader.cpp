@@ -20,6 +20,7 @@
 #include "geo/calculations.h"
 #include "io/binaryutil.h"
 #include "routing/routenetwork.h"
+#include "sql/sqlcursor.h"
 #include "sql/sqldatabase.h"
 #include "sql/sqlquery.h"
 #include "sql/sqlrecord.h"
@@ -30,6 +31,7 @@
 
 using atools::sql::SqlUtil;
 using atools::sql::SqlQuery;
+using atools::sql::SqlCursor;
 using atools::geo::nmToMeter;
 using atools::geo::Point3D;
 using atools::charAt;
@@ -161,8 +163,7 @@ void RouteNetworkLoader::load(atools::routing::RouteNetwork *networkParam)
                       "where w.type = 'N' and (w.num_jet_airway > 0 or w.num_victor_airway > 0)",
                       false, true /* NDB */, false, false);
 
-    // Insert outgoing edges to each node and copy node to the index ========================
-    network->nodeIndex.reserve(nodeVector.size());
+    // Insert outgoing edges to each node ========================
     for(Node& node : nodeVector)
     {
       for(auto it = nodeEdgeMap.find(node.id); it != nodeEdgeMap.end() && it.key() == node.id; ++it)
@@ -171,9 +172,10 @@ void RouteNetworkLoader::load(atools::routing::RouteNetwork *networkParam)
       // Replace database ids in Edge::toIndex with array indexes
       for(Edge& edge : node.edges)
         edge.toIndex = nodeIdIndexMap.value(edge.toIndex);
-
-      network->nodeIndex.append(node);
     }
+
+    // Move nodes into the empty index without copying ========================
+    network->nodeIndex.swap(nodeVector);
   } // else if(network->source == SOURCE_AIRWAY)
 
   // Update spatial index
@@ -288,29 +290,30 @@ void RouteNetworkLoader::readEdgesAirway(QMultiHash<int, Edge>& nodeEdgeMap, boo
 
   SqlQuery query(queryTxt, track ? dbTrack : dbNav);
   query.exec();
-  while(query.next())
+  SqlCursor cursor(query);
+  while(cursor.next())
   {
     Edge edge;
-    edge.id = query.valueInt(ID);
+    edge.id = cursor.valueInt(ID);
 
-    edge.minAltFt = static_cast<quint16>(std::min(query.valueInt(MIN), static_cast<int>(Edge::MAX_ALTITUDE)));
+    edge.minAltFt = static_cast<quint16>(std::min(cursor.valueInt(MIN), static_cast<int>(Edge::MAX_ALTITUDE)));
 
     // Assign max altitude if given - otherwise max
-    if(query.valueInt(MAX) > 0)
-      edge.maxAltFt = static_cast<quint16>(std::min(query.valueInt(MAX), static_cast<int>(Edge::MAX_ALTITUDE)));
+    if(cursor.valueInt(MAX) > 0)
+      edge.maxAltFt = static_cast<quint16>(std::min(cursor.valueInt(MAX), static_cast<int>(Edge::MAX_ALTITUDE)));
     else
       edge.maxAltFt = Edge::MAX_ALTITUDE;
 
     // From and to waypoint ids
-    int fromId = query.valueInt(FROM);
-    int toId = query.valueInt(TO);
+    int fromId = cursor.valueInt(FROM);
+    int toId = cursor.valueInt(TO);
 
     if(!track)
     {
       // Assign route type ======================================
-      QString typeStr = query.valueStr(AIRWAY_TYPE);
-      edge.airwayHash = airwayHash(query.valueStr(NAME));
-      char routeType = atools::strToChar(query.valueStr(ROUTE_TYPE));
+      QString typeStr = cursor.valueStr(AIRWAY_TYPE);
+      edge.airwayHash = airwayHash(cursor.valueStr(NAME));
+      char routeType = atools::strToChar(cursor.valueStr(ROUTE_TYPE));
       if(routeType == 'A')
         edge.routeType = AIRLINE; /* A Airline Airway (Tailored Data) */
       else if(routeType == 'C')
@@ -339,7 +342,7 @@ void RouteNetworkLoader::readEdgesAirway(QMultiHash<int, Edge>& nodeEdgeMap, boo
 
       // Assign towards node ======================================
       // Add one edge for each allowed direction
-      char dir = atools::strToChar(query.valueStr(DIRECTION));
+      char dir = atools::strToChar(cursor.valueStr(DIRECTION));
 
       if(dir == '\0' || dir == 'F' || dir == 'N')
       {
@@ -360,27 +363,27 @@ void RouteNetworkLoader::readEdgesAirway(QMultiHash<int, Edge>& nodeEdgeMap, boo
     else
     {
       // Calculate hash including type to avoid jumping between tracks
-      edge.airwayHash = trackHash(query.valueStr(NAME), query.valueStr(TRACK_TYPE));
+      edge.airwayHash = trackHash(cursor.valueStr(NAME), cursor.valueStr(TRACK_TYPE));
 
       /* T NAT or PACOTS track */
       edge.routeType = TRACK;
       edge.type = EDGE_TRACK;
 
       // Read altitude levels from array ====================
-      if(!query.isNull(ALT_LEVELS_EAST))
+      if(!cursor.isNull(ALT_LEVELS_EAST))
       {
         edge.hasAltLevels = true;
         network->altLevelsEast.insert(edge.id,
                                       atools::io::readVector<quint16, quint16>(
-                                        query.value(ALT_LEVELS_EAST).toByteArray()));
+                                        cursor.value(ALT_LEVELS_EAST).toByteArray()));
       }
 
-      if(!query.isNull(ALT_LEVELS_WEST))
+      if(!cursor.isNull(ALT_LEVELS_WEST))
       {
         edge.hasAltLevels = true;
         network->altLevelsWest.insert(edge.id,
                                       atools::io::readVector<quint16, quint16>(
-                                        query.value(ALT_LEVELS_WEST).toByteArray()));
+                                        cursor.value(ALT_LEVELS_WEST).toByteArray()));
       }
 
       // Forward only track is always running from/to
@@ -438,14 +441,15 @@ void RouteNetworkLoader::readNodesAirway(QVector<Node>& nodes, QHash<int, int>&
 
   SqlQuery query(queryStr, track ? dbTrack : dbNav);
   query.exec();
-  while(query.next())
+  SqlCursor cursor(query);
+  while(cursor.next())
   {
-    int nodeId = query.valueInt(ID);
+    int nodeId = cursor.valueInt(ID);
     if(procNodeIds.contains(nodeId))
       // Not part of an airway but part of a procedure or part of an airport (terminal waypoint) - ignore
       continue;
 
-    atools::geo::Pos pos(query.valueFloat(LONX), query.valueFloat(LATY));
+    atools::geo::Pos pos(cursor.valueFloat(LONX), cursor.valueFloat(LATY));
 
     // No name and grid filter for NDB and VOR waypoints
     if(!ndb && !vor && filterProc)
@@ -458,7 +462,7 @@ void RouteNetworkLoader::readNodesAirway(QVector<Node>& nodes, QHash<int, int>&
       // if not confluence points
       if(!ok)
       {
-        QString ident = query.valueStr(IDENT);
+        QString ident = cursor.valueStr(IDENT);
         if(charAt(ident, 2).isDigit() && charAt(ident, 3).isDigit() && charAt(ident, 4).isDigit())
           continue;
       }
@@ -471,18 +475,18 @@ void RouteNetworkLoader::readNodesAirway(QVector<Node>& nodes, QHash<int, int>&
     node.type = NODE_WAYPOINT;
 
     if(vor || ndb)
-      node.range = nmToMeter(query.valueInt(RANGE));
+      node.range = nmToMeter(cursor.valueInt(RANGE));
 
     if(vor)
     {
       // Query uses VOR table ====================
-      QString vortype = query.valueStr(RADIO_TYPE);
+      QString vortype = cursor.valueStr(RADIO_TYPE);
       if(vortype == "H" || vortype == "L" || vortype == "T" || vortype.startsWith("VT"))
       {
-        if(query.valueBool(DME_ONLY))
+        if(cursor.valueBool(DME_ONLY))
           node.subtype = NODE_DME;
         else
-          node.subtype = query.isNull(DME_ALTITUDE) ? NODE_VOR : NODE_VORDME;
+          node.subtype = cursor.isNull(DME_ALTITUDE) ? NODE_VOR : NODE_VORDME;
       }
     }
 
@@ -515,17 +519,18 @@ void RouteNetworkLoader::readNodesRadio(const QString& queryStr, bool vor)
 
   SqlQuery query(queryStr, dbNav);
   query.exec();
-  while(query.next())
+  SqlCursor cursor(query);
+  while(cursor.next())
   {
     Node node;
     node.index = network->nodeIndex.size();
-    node.id = query.valueInt(ID);
-    node.pos.setLonX(query.valueFloat(LONX));
-    node.pos.setLatY(query.valueFloat(LATY));
-    node.range = nmToMeter(query.valueInt(RANGE));
+    node.id = cursor.valueInt(ID);
+    node.pos.setLonX(cursor.valueFloat(LONX));
+    node.pos.setLatY(cursor.valueFloat(LATY));
+    node.range = nmToMeter(cursor.valueInt(RANGE));
 
     if(vor)
-      node.type = query.valueBool(HAS_DME) ? NODE_VORDME : NODE_VOR;
+      node.type = cursor.valueBool(HAS_DME) ? NODE_VORDME : NODE_VOR;
     else
       node.type = NODE_NDB;
 
@@ -0,0 +1,77 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "sql/sqlcursor.h"
+
+#include "sql/sqlexception.h"
+
+#include <QSqlRecord>
+#include <QStringBuilder>
+
+namespace atools {
+namespace sql {
+
+SqlCursor::SqlCursor(SqlQuery& sqlQuery)
+  : query(&sqlQuery)
+{
+}
+
+SqlCursor::SqlCursor(SqlQuery *sqlQuery)
+  : query(sqlQuery)
+{
+}
+
+void SqlCursor::check()
+{
+  query->checkError(query->isSelect(), QLatin1String(Q_FUNC_INFO) % " on query which is not a select");
+  query->checkError(query->isActive(), QLatin1String(Q_FUNC_INFO) % " on inactive query");
+  numColumns = query->query.record().count();
+  checked = true;
+}
+
+void SqlCursor::resolveColumns() const
+{
+  query->checkError(query->isActive(), QLatin1String(Q_FUNC_INFO) % " on inactive query");
+
+  QSqlRecord rec = query->query.record();
+  for(int i = 0; i < rec.count(); i++)
+  {
+    // Case insensitive and first column for duplicate names like QSqlRecord::indexOf()
+    QString name = rec.fieldName(i).toLower();
+    if(!columnIndexes.contains(name))
+      columnIndexes.insert(name, i);
+  }
+}
+
+int SqlCursor::columnIf(const QString& name) const
+{
+  if(columnIndexes.isEmpty())
+    resolveColumns();
+  return columnIndexes.value(name.toLower(), -1);
+}
+
+int SqlCursor::column(const QString& name) const
+{
+  int index = columnIf(name);
+  if(index == -1)
+    throw SqlException(query, QLatin1String(Q_FUNC_INFO) % ": Value name \"" % name %
+                       "\" does not exist in query \"" % query->getQueryString() % "\"");
+  return index;
+}
+
+} // namespace sql
+} // namespace atools
@@ -0,0 +1,137 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef ATOOLS_SQL_SQLCURSOR_H
+#define ATOOLS_SQL_SQLCURSOR_H
+
+#include "atools.h"
+#include "sql/sqlquery.h"
+
+#include <QHash>
+
+namespace atools {
+namespace sql {
+
+/*
+ * Fast typed read access to the rows of an executed SqlQuery for loaders reading millions of values.
+ *
+ * Query state is checked only once on the first call of next() instead of for each value.
+ * Column names can be resolved to indexes once using column() before iterating.
+ * Getters do not check state or indexes in release builds and do not throw exceptions.
+ *
+ * The Qt SQLite driver buffers each row as QVariant values. The getters convert these directly
+ * without creating further copies.
+ */
+class SqlCursor
+{
+public:
+  /* Query has to be executed and has to be valid as long as the cursor is used */
+  explicit SqlCursor(atools::sql::SqlQuery& sqlQuery);
+  explicit SqlCursor(atools::sql::SqlQuery *sqlQuery);
+
+  /* Get column index for case insensitive name. Throws exception if column does not exist. */
+  int column(const QString& name) const;
+
+  /* Get column index for name or -1 if column does not exist. */
+  int columnIf(const QString& name) const;
+
+  /* Move to next row. Throws exception if the query is not an active select on the first call.
+   * Returns false if no more rows are available. */
+  bool next()
+  {
+    if(!checked)
+      check();
+    return query->query.next();
+  }
+
+  /* Getters without checks. Use only after next() returned true. */
+  QVariant value(int i) const
+  {
+    Q_ASSERT(i >= 0 && i < numColumns);
+    return query->query.value(i);
+  }
+
+  bool isNull(int i) const
+  {
+    Q_ASSERT(i >= 0 && i < numColumns);
+    return query->query.isNull(i);
+  }
+
+  int valueInt(int i) const
+  {
+    return value(i).toInt();
+  }
+
+  qint64 valueLongLong(int i) const
+  {
+    return value(i).toLongLong();
+  }
+
+  float valueFloat(int i) const
+  {
+    return value(i).toFloat();
+  }
+
+  double valueDouble(int i) const
+  {
+    return value(i).toDouble();
+  }
+
+  bool valueBool(int i) const
+  {
+    return value(i).toBool();
+  }
+
+  QString valueStr(int i) const
+  {
+    return value(i).toString();
+  }
+
+  QChar valueChar(int i) const
+  {
+    return atools::strToChar(valueStr(i));
+  }
+
+  /* Blob values */
+  QByteArray valueBytes(int i) const
+  {
+    return value(i).toByteArray();
+  }
+
+  /* Number of columns in result. Valid after first call of next(). */
+  int getNumColumns() const
+  {
+    return numColumns;
+  }
+
+private:
+  /* Check query state and fetch number of columns */
+  void check();
+
+  /* Build column name to index hash */
+  void resolveColumns() const;
+
+  atools::sql::SqlQuery *query;
+  mutable QHash<QString, int> columnIndexes;
+  int numColumns = 0;
+  bool checked = false;
+};
+
+} // namespace sql
+} // namespace atools
+
+#endif // ATOOLS_SQL_SQLCURSOR_H
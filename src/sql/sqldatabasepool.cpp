@@ -0,0 +1,269 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "sql/sqldatabasepool.h"
+
+#include "sql/sqldatabase.h"
+#include "sql/sqlexception.h"
+#include "sql/sqlquery.h"
+
+#include <QDebug>
+#include <QThread>
+
+namespace atools {
+namespace sql {
+
+using internal::SqlPoolEntry;
+
+// ================================================================================================
+SqlPoolConnection::SqlPoolConnection(SqlDatabasePool *poolParam, SqlPoolEntry *entryParam)
+  : pool(poolParam), entry(entryParam)
+{
+}
+
+SqlPoolConnection::SqlPoolConnection(SqlPoolConnection&& other)
+  : pool(other.pool), entry(other.entry)
+{
+  other.pool = nullptr;
+  other.entry = nullptr;
+}
+
+SqlPoolConnection& SqlPoolConnection::operator=(SqlPoolConnection&& other)
+{
+  if(this != &other)
+  {
+    release();
+    pool = other.pool;
+    entry = other.entry;
+    other.pool = nullptr;
+    other.entry = nullptr;
+  }
+  return *this;
+}
+
+SqlPoolConnection::~SqlPoolConnection()
+{
+  release();
+}
+
+SqlDatabase *SqlPoolConnection::getDatabase() const
+{
+  Q_ASSERT(entry != nullptr);
+  return entry->db;
+}
+
+SqlQuery& SqlPoolConnection::query(const QString& queryString)
+{
+  Q_ASSERT(entry != nullptr);
+  Q_ASSERT(entry->thread == QThread::currentThreadId());
+
+  SqlQuery *query = entry->queries.value(queryString, nullptr);
+  if(query == nullptr)
+  {
+    // Prepare on first use - prepare() throws an exception on error
+    query = new SqlQuery(entry->db);
+    try
+    {
+      query->prepare(queryString);
+    }
+    catch(...)
+    {
+      delete query;
+      throw;
+    }
+    entry->queries.insert(queryString, query);
+  }
+  return *query;
+}
+
+void SqlPoolConnection::release()
+{
+  if(pool != nullptr && entry != nullptr)
+    pool->release(entry);
+  pool = nullptr;
+  entry = nullptr;
+}
+
+// ================================================================================================
+SqlDatabasePool::SqlDatabasePool(const QString& filename, const QStringList& pragmas, int maxConnections)
+  : filename(filename), pragmas(pragmas), maxConnections(maxConnections)
+{
+  if(this->maxConnections <= 0)
+    this->maxConnections = QThread::idealThreadCount();
+  if(this->maxConnections <= 0)
+    this->maxConnections = 1;
+}
+
+SqlDatabasePool::~SqlDatabasePool()
+{
+  QMutexLocker locker(&mutex);
+  qDebug() << Q_FUNC_INFO << filename << "connections" << entries.size();
+
+  for(SqlPoolEntry *entry : qAsConst(entries))
+  {
+    if(entry->checkedOut)
+      qWarning() << Q_FUNC_INFO << "Connection" << entry->connectionName << "still checked out";
+    close(entry);
+  }
+  entries.clear();
+}
+
+QStringList SqlDatabasePool::defaultPragmas()
+{
+  return QStringList({"PRAGMA mmap_size=268435456", "PRAGMA query_only=ON", "PRAGMA temp_store=MEMORY",
+                      "PRAGMA cache_size=-16000"});
+}
+
+SqlPoolConnection SqlDatabasePool::checkout()
+{
+  Qt::HANDLE thread = QThread::currentThreadId();
+
+  QMutexLocker locker(&mutex);
+  while(true)
+  {
+    // Reuse a free connection of this thread ===================
+    for(SqlPoolEntry *entry : qAsConst(entries))
+    {
+      if(!entry->checkedOut && entry->thread == thread)
+      {
+        entry->checkedOut = true;
+        return SqlPoolConnection(this, entry);
+      }
+    }
+
+    // Open a new connection if below limit ===================
+    if(entries.size() + numOpening < maxConnections)
+      break;
+
+    // Replace a free connection of another thread ===================
+    // Closing is safe here since only connections without active queries are free
+    // and Qt allows removing connections from other threads
+    SqlPoolEntry *freeEntry = nullptr;
+    for(SqlPoolEntry *entry : qAsConst(entries))
+    {
+      if(!entry->checkedOut)
+      {
+        freeEntry = entry;
+        break;
+      }
+    }
+
+    if(freeEntry != nullptr)
+    {
+      entries.removeOne(freeEntry);
+      close(freeEntry);
+      break;
+    }
+
+    // All connections in use - wait for release
+    released.wait(&mutex);
+  }
+
+  // Open outside of lock since opening and pragmas take a while ===================
+  numOpening++;
+  QString connectionName = QString("SqlDatabasePool-%1-%2").
+                           arg(reinterpret_cast<quintptr>(this), 0, 16).arg(connectionNumber++);
+  locker.unlock();
+
+  SqlPoolEntry *entry = nullptr;
+  try
+  {
+    entry = new SqlPoolEntry;
+    entry->connectionName = connectionName;
+    entry->thread = thread;
+    entry->checkedOut = true;
+
+    SqlDatabase::addDatabase("QSQLITE", connectionName);
+    entry->db = new SqlDatabase(connectionName);
+    entry->db->setDatabaseName(filename);
+    entry->db->open(pragmas, true /* readonly */);
+  }
+  catch(...)
+  {
+    locker.relock();
+    numOpening--;
+    close(entry);
+    released.wakeOne();
+    throw;
+  }
+
+  locker.relock();
+  numOpening--;
+  entries.append(entry);
+  return SqlPoolConnection(this, entry);
+}
+
+void SqlDatabasePool::release(SqlPoolEntry *entry)
+{
+  // Finish queries in the calling thread which owns the connection to release locks and result sets
+  for(SqlQuery *query : qAsConst(entry->queries))
+  {
+    if(query->isActive())
+      query->finish();
+  }
+
+  QMutexLocker locker(&mutex);
+  entry->checkedOut = false;
+  released.wakeAll();
+}
+
+void SqlDatabasePool::closeUnused()
+{
+  QMutexLocker locker(&mutex);
+  for(auto it = entries.begin(); it != entries.end();)
+  {
+    if(!(*it)->checkedOut)
+    {
+      close(*it);
+      it = entries.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+int SqlDatabasePool::getNumConnections() const
+{
+  QMutexLocker locker(&mutex);
+  return entries.size();
+}
+
+void SqlDatabasePool::close(SqlPoolEntry *entry)
+{
+  if(entry == nullptr)
+    return;
+
+  qDeleteAll(entry->queries);
+  entry->queries.clear();
+
+  if(entry->db != nullptr)
+  {
+    if(entry->db->isOpen())
+      entry->db->close();
+    delete entry->db;
+    entry->db = nullptr;
+  }
+
+  // Remove only after all SqlDatabase and SqlQuery objects referring to the connection are deleted
+  if(!entry->connectionName.isEmpty())
+    SqlDatabase::removeDatabase(entry->connectionName);
+
+  delete entry;
+}
+
+} // namespace sql
+} // namespace atools
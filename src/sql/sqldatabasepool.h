@@ -0,0 +1,144 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef ATOOLS_SQL_SQLDATABASEPOOL_H
+#define ATOOLS_SQL_SQLDATABASEPOOL_H
+
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+#include <QVector>
+#include <QWaitCondition>
+
+namespace atools {
+namespace sql {
+
+class SqlDatabase;
+class SqlDatabasePool;
+class SqlQuery;
+
+namespace internal {
+
+/* Open connection and prepared queries. Used by one thread only. */
+struct SqlPoolEntry
+{
+  atools::sql::SqlDatabase *db = nullptr;
+  QString connectionName;
+  Qt::HANDLE thread = nullptr; /* Thread which created the connection */
+  QHash<QString, atools::sql::SqlQuery *> queries; /* Prepared statements by query text */
+  bool checkedOut = false;
+};
+
+} // namespace internal
+
+/*
+ * Connection checked out from SqlDatabasePool. Returns the connection to the pool when destroyed.
+ * Can be moved but not copied. Must be used only in the thread which called SqlDatabasePool::checkout().
+ */
+class SqlPoolConnection
+{
+public:
+  SqlPoolConnection(SqlPoolConnection&& other);
+  SqlPoolConnection& operator=(SqlPoolConnection&& other);
+  ~SqlPoolConnection();
+
+  SqlPoolConnection(const SqlPoolConnection& other) = delete;
+  SqlPoolConnection& operator=(const SqlPoolConnection& other) = delete;
+
+  /* Read-only database connection */
+  atools::sql::SqlDatabase *getDatabase() const;
+
+  /* Get prepared query from the statement cache of this connection. Query is prepared on first use.
+   * Values bound in a former checkout stay bound. Throws SqlException if preparing fails. */
+  atools::sql::SqlQuery& query(const QString& queryString);
+
+  /* Return connection to pool before destruction. Connection is not usable afterwards. */
+  void release();
+
+  bool isValid() const
+  {
+    return entry != nullptr;
+  }
+
+private:
+  friend class SqlDatabasePool;
+
+  SqlPoolConnection(SqlDatabasePool *poolParam, internal::SqlPoolEntry *entryParam);
+
+  SqlDatabasePool *pool = nullptr;
+  internal::SqlPoolEntry *entry = nullptr;
+};
+
+/*
+ * Thread safe pool of read-only SQLite connections to one database file allowing
+ * several threads to run queries at the same time.
+ *
+ * Qt database connections can only be used in the thread which created them. Therefore the pool
+ * opens connections for each calling thread on demand and reuses them for further checkouts in the same thread.
+ * Free connections of other threads are closed and replaced if the maximum number of connections is reached.
+ * checkout() blocks if all connections are in use.
+ *
+ * Each connection keeps a cache of prepared queries.
+ *
+ * The pool has to be deleted after all connections are returned and after the threads stopped using it.
+ */
+class SqlDatabasePool
+{
+public:
+  /* filename: SQLite database file which has to exist.
+   * pragmas: Executed after opening each connection.
+   * maxConnections: Maximum number of open connections. Uses QThread::idealThreadCount() if <= 0. */
+  explicit SqlDatabasePool(const QString& filename, const QStringList& pragmas = defaultPragmas(), int maxConnections = 0);
+  ~SqlDatabasePool();
+
+  SqlDatabasePool(const SqlDatabasePool& other) = delete;
+  SqlDatabasePool& operator=(const SqlDatabasePool& other) = delete;
+
+  /* Get a connection for the calling thread. Blocks until a connection is available.
+   * Throws SqlException if the database cannot be opened. */
+  SqlPoolConnection checkout();
+
+  /* Close all connections which are not checked out */
+  void closeUnused();
+
+  /* Number of open connections */
+  int getNumConnections() const;
+
+  /* Memory mapped IO, no writes, temporary tables in memory and about 16 MB page cache per connection */
+  static QStringList defaultPragmas();
+
+private:
+  friend class SqlPoolConnection;
+
+  /* Called by SqlPoolConnection */
+  void release(internal::SqlPoolEntry *entry);
+
+  void close(internal::SqlPoolEntry *entry);
+
+  QString filename;
+  QStringList pragmas;
+  int maxConnections, connectionNumber = 0, numOpening = 0;
+
+  QVector<internal::SqlPoolEntry *> entries;
+  mutable QMutex mutex;
+  QWaitCondition released;
+};
+
+} // namespace sql
+} // namespace atools
+
+#endif // ATOOLS_SQL_SQLDATABASEPOOL_H
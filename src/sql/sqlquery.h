@@ -277,7 +277,9 @@ public:
   QString boundValuesAsString() const;
 
 private:
+  friend class SqlCursor;
   friend class SqlDatabase;
+  friend class SqlRowCopier;
 
   void checkError(bool retval = true, const QString& msg = QString()) const;
   void checkPlaceholder(const QString& funcInfo, const QString& placeholder) const;
@@ -0,0 +1,126 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "sql/sqlrowcopier.h"
+
+#include "sql/sqlexception.h"
+#include "sql/sqlquery.h"
+#include "sql/sqlrecord.h"
+#include "sql/sqltransaction.h"
+
+#include <QHash>
+#include <QSet>
+#include <QStringBuilder>
+
+namespace atools {
+namespace sql {
+
+SqlRowCopier::SqlRowCopier(SqlQuery& fromQuery, SqlQuery& toQuery)
+  : from(fromQuery), to(toQuery)
+{
+}
+
+void SqlRowCopier::buildMapping()
+{
+  mapping.clear();
+
+  // Get first position for each placeholder and detect the ones used more than once
+  const QStringList& placeholders = to.getPlaceholderList();
+  QHash<QString, int> placeholderIndexes;
+  QSet<QString> duplicates;
+  for(int i = 0; i < placeholders.size(); i++)
+  {
+    if(placeholderIndexes.contains(placeholders.at(i)))
+      duplicates.insert(placeholders.at(i));
+    else
+      placeholderIndexes.insert(placeholders.at(i), i);
+  }
+
+  SqlRecord fromRec = from.record();
+  for(int i = 0; i < fromRec.count(); i++)
+  {
+    QString bind = ":" % fromRec.fieldName(i);
+
+    // Positional placeholders are numbers and never match
+    if(placeholderIndexes.contains(bind))
+    {
+      if(duplicates.isEmpty())
+        mapping.append({i, placeholderIndexes.value(bind), QString()});
+      else
+        // Qt binds all occurrences only when using the name and gets confused by mixed binding - use names for all
+        mapping.append({i, -1, bind});
+    }
+  }
+
+  mappingValid = true;
+}
+
+void SqlRowCopier::bindRow()
+{
+  if(!mappingValid)
+    buildMapping();
+
+  // Access QSqlQuery directly to avoid checks for each value
+  for(const ColumnMapping& column : qAsConst(mapping))
+  {
+    if(column.placeholderIndex >= 0)
+      to.query.bindValue(column.placeholderIndex, from.query.value(column.column));
+    else
+      to.query.bindValue(column.placeholder, from.query.value(column.column));
+  }
+}
+
+int SqlRowCopier::copyRows(const FilterFuncType& func, int batchSize)
+{
+  if(batchSize > 0)
+  {
+    SqlTransaction transaction(to.getDatabase());
+    int copied = copyRowsInternal(func, batchSize, &transaction);
+    transaction.commit();
+    return copied;
+  }
+  else
+    return copyRowsInternal(func, 0, nullptr);
+}
+
+int SqlRowCopier::copyRowsInternal(const FilterFuncType& func, int batchSize, SqlTransaction *transaction)
+{
+  int copied = 0;
+  while(from.next())
+  {
+    bindRow();
+
+    if(!func || func(from, to))
+    {
+      to.exec();
+      if(to.numRowsAffected() != 1)
+        throw SqlException(&to, QLatin1String(Q_FUNC_INFO) % "Number of inserted rows not 1.");
+      copied++;
+
+      if(transaction != nullptr && copied % batchSize == 0)
+      {
+        // Commit batch and open a new transaction
+        transaction->commit();
+        transaction->start();
+      }
+    }
+  }
+  return copied;
+}
+
+} // namespace sql
+} // namespace atools
@@ -0,0 +1,89 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef ATOOLS_SQL_SQLROWCOPIER_H
+#define ATOOLS_SQL_SQLROWCOPIER_H
+
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+namespace atools {
+namespace sql {
+
+class SqlQuery;
+class SqlTransaction;
+
+/*
+ * Copies rows from a query to a prepared insert or update query having named placeholders like ":column".
+ *
+ * The mapping from source column to target placeholder position is resolved once for the first row and
+ * values are bound by position afterwards. This avoids building placeholder names and looking them up for each row.
+ *
+ * Source columns without a matching placeholder are ignored. All values are bound by name if any placeholder
+ * is used more than once in the target query.
+ */
+class SqlRowCopier
+{
+public:
+  /* Called after binding all values. Row is inserted if the function returns true. */
+  typedef std::function<bool (atools::sql::SqlQuery& from, atools::sql::SqlQuery& to)> FilterFuncType;
+
+  /* Both queries have to be prepared and valid until the copier is destroyed */
+  SqlRowCopier(atools::sql::SqlQuery& fromQuery, atools::sql::SqlQuery& toQuery);
+
+  /* Bind the values of the current row in the source query to the target query. */
+  void bindRow();
+
+  /* Fetch all rows from the source query, bind values, call optional filter and execute the target query.
+   * Throws an exception if the number of affected rows is not one.
+   *
+   * If batchSize is > 0 copying is done in a transaction on the target database which is
+   * committed every batchSize rows and at the end. Rolls back the current batch in case of exception.
+   *
+   * @return number of rows copied */
+  int copyRows(const FilterFuncType& func = nullptr, int batchSize = 0);
+
+  /* Mapped source and target columns. Valid after the first row was bound. */
+  int getNumMappedColumns() const
+  {
+    return mapping.size();
+  }
+
+private:
+  struct ColumnMapping
+  {
+    int column; /* Column index in source query */
+    int placeholderIndex; /* Position in target query or -1 if binding by name */
+    QString placeholder; /* Name with colon if binding by name */
+  };
+
+  void buildMapping();
+  int copyRowsInternal(const FilterFuncType& func, int batchSize, atools::sql::SqlTransaction *transaction);
+
+  atools::sql::SqlQuery& from;
+  atools::sql::SqlQuery& to;
+
+  QVector<ColumnMapping> mapping;
+  bool mappingValid = false;
+};
+
+} // namespace sql
+} // namespace atools
+
+#endif // ATOOLS_SQL_SQLROWCOPIER_H
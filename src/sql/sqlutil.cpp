@@ -19,6 +19,7 @@
 #include "sql/sqldatabase.h"
 #include "sql/sqlrecord.h"
 #include "sql/sqlquery.h"
+#include "sql/sqlrowcopier.h"
 #include "sql/sqlexception.h"
 
 #include <QDebug>
@@ -203,45 +204,12 @@ void SqlUtil::copyRowValuesInternal(const SqlQuery& from, SqlQuery& to, const Sq
 
 int SqlUtil::copyResultValues(SqlQuery& from, SqlQuery& to, std::function<bool(SqlQuery&, SqlQuery&)> func)
 {
-  int copied = 0;
-  SqlRecord fromRec;
-  QMap<QString, QVariant> bound = to.boundPlaceholderAndValueMap();
-
-  while(from.next())
-  {
-    if(fromRec.isEmpty())
-      fromRec = from.record();
-
-    copyRowValuesInternal(from, to, fromRec, bound);
-
-    if(func(from, to))
-    {
-      to.exec();
-      if(to.numRowsAffected() != 1)
-        throw SqlException(&to, QLatin1String(Q_FUNC_INFO) % "Number of inserted rows not 1.");
-      copied++;
-    }
-  }
-  return copied;
+  return SqlRowCopier(from, to).copyRows(func);
 }
 
 int SqlUtil::copyResultValues(SqlQuery& from, SqlQuery& to)
 {
-  int copied = 0;
-  SqlRecord fromRec;
-  QMap<QString, QVariant> bound = to.boundPlaceholderAndValueMap();
-  while(from.next())
-  {
-    if(fromRec.isEmpty())
-      fromRec = from.record();
-
-    copyRowValuesInternal(from, to, fromRec, bound);
-    to.exec();
-    if(to.numRowsAffected() != 1)
-      throw SqlException(&to, QLatin1String(Q_FUNC_INFO) % "Number of inserted rows not 1.");
-    copied++;
-  }
-  return copied;
+  return SqlRowCopier(from, to).copyRows();
 }
 
 void SqlUtil::updateColumnInTable(const QString& table, const QString& idColum, const QStringList& queryColumns,
@@ -273,11 +241,14 @@ void SqlUtil::updateColumnInTable(const QString& table, const QString& idColum,
 
   select.exec();
 
+  // Resolve id column and bind name only once - id is the last column in the select
+  QString idBind = ":" % idColum;
+  int idIndex = queryCols.size() - 1;
   while(select.next())
   {
     if(func(select, insert))
     {
-      insert.bindValue(":" % idColum, select.value(idColum));
+      insert.bindValue(idBind, select.value(idIndex));
       insert.exec();
     }
   }
@@ -98,6 +98,7 @@ public:
    * @param func Function that acts a filter. If return value is true the row is
    * inserted. Will be called after all variables are bound.
    * @return number of rows copied
+   * Uses SqlRowCopier which resolves the column mapping only once.
    */
   static int copyResultValues(atools::sql::SqlQuery& from, atools::sql::SqlQuery& to,
                               std::function<bool(atools::sql::SqlQuery& from, atools::sql::SqlQuery& to)> func);
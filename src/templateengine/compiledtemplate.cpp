@@ -0,0 +1,245 @@
+/**
+ *  @file
+ */
+
+#include "compiledtemplate.h"
+
+using namespace stefanfrings;
+
+void TemplateValues::setVariable(const QString& name, const QString& value)
+{
+  variables.insert(name, value);
+}
+
+void TemplateValues::setCondition(const QString& name, bool value)
+{
+  conditions.insert(name, value);
+}
+
+void TemplateValues::loop(const QString& name, int repetitions)
+{
+  Q_ASSERT(repetitions >= 0);
+  loops.insert(name, repetitions);
+}
+
+void TemplateValues::clear()
+{
+  variables.clear();
+  conditions.clear();
+  loops.clear();
+}
+
+CompiledTemplate::CompiledTemplate(const QString& source, const QString& sourceName)
+  : sourceName(sourceName), sourceSize(source.size())
+{
+  parse(source);
+}
+
+void CompiledTemplate::appendLiteral(const QString& source, int begin, int end)
+{
+  if(end > begin)
+  {
+    Node node;
+    node.type = LITERAL;
+    node.text = source.mid(begin, end - begin);
+    nodes.append(node);
+  }
+}
+
+void CompiledTemplate::parse(const QString& source)
+{
+  // Indexes of open blocks in nodes
+  QVector<int> openBlocks;
+
+  int literalStart = 0, pos = 0;
+  while((pos = source.indexOf('{', pos)) >= 0)
+  {
+    int close = source.indexOf('}', pos + 1);
+    if(close < 0)
+      break;
+
+    QString tag = source.mid(pos + 1, close - pos - 1);
+
+    // Split into keyword and name - tags like "{ a: 1 }" in scripts are literals
+    int space = tag.indexOf(' ');
+    QString keyword = space >= 0 ? tag.left(space) : QString();
+    QString name = space >= 0 ? tag.mid(space + 1) : tag;
+    bool validName = !name.isEmpty();
+    for(int i = 0; i < name.size() && validName; i++)
+      validName = !name.at(i).isSpace() && name.at(i) != '{';
+
+    if(!validName || !(keyword.isEmpty() || keyword == "if" || keyword == "ifnot" || keyword == "loop" ||
+                       keyword == "else" || keyword == "end"))
+    {
+      // Not a tag - look for next opening brace
+      pos++;
+      continue;
+    }
+
+    if(keyword == "else" || keyword == "end")
+    {
+      // Has to match the innermost open block, otherwise it is kept as literal
+      int openIndex = openBlocks.isEmpty() ? -1 : openBlocks.constLast();
+      if(openIndex == -1 || nodes.at(openIndex).text != name ||
+         (keyword == "else" && nodes.at(openIndex).elseBegin != -1))
+      {
+        pos++;
+        continue;
+      }
+
+      appendLiteral(source, literalStart, pos);
+      if(keyword == "else")
+        nodes[openIndex].elseBegin = nodes.size();
+      else
+      {
+        nodes[openIndex].end = nodes.size();
+        openBlocks.removeLast();
+      }
+    }
+    else
+    {
+      appendLiteral(source, literalStart, pos);
+
+      Node node;
+      node.text = name;
+      if(keyword.isEmpty())
+        node.type = VARIABLE;
+      else if(keyword == "if")
+        node.type = IF;
+      else if(keyword == "ifnot")
+        node.type = IFNOT;
+      else
+        node.type = LOOP;
+
+      if(node.type != VARIABLE)
+        openBlocks.append(nodes.size());
+      nodes.append(node);
+    }
+
+    pos = close + 1;
+    literalStart = pos;
+  }
+
+  appendLiteral(source, literalStart, source.size());
+
+  // Blocks without end tag contain all following nodes
+  for(int index : openBlocks)
+  {
+    qWarning("Template: missing end tag for %s in %s", qPrintable(nodes.at(index).text), qPrintable(sourceName));
+    nodes[index].end = nodes.size();
+    nodes[index].closed = false;
+  }
+}
+
+QString CompiledTemplate::render(const TemplateValues& values) const
+{
+  QString out;
+  out.reserve(sourceSize);
+
+  PrefixVector prefixes;
+  renderRange(out, 0, nodes.size(), values, prefixes);
+  return out;
+}
+
+void CompiledTemplate::renderRange(QString& out, int begin, int end, const TemplateValues& values,
+                                   PrefixVector& prefixes) const
+{
+  int index = begin;
+  while(index < end)
+  {
+    const Node& node = nodes.at(index);
+
+    if(node.type == LITERAL)
+      out.append(node.text);
+    else
+    {
+      QString name = resolveName(node.text, prefixes);
+
+      if(node.type == VARIABLE)
+      {
+        auto it = values.variables.constFind(name);
+        if(it != values.variables.constEnd())
+          out.append(it.value());
+        else
+          out.append('{').append(name).append('}');
+      }
+      else
+      {
+        int mainEnd = node.elseBegin != -1 ? node.elseBegin : node.end;
+
+        if(node.type == LOOP)
+        {
+          auto it = values.loops.constFind(name);
+          if(it == values.loops.constEnd() || !node.closed)
+            renderUnresolvedBlock(out, index, name, values, prefixes);
+          else if(it.value() > 0)
+          {
+            // Number variables, conditions and sub-loops within the loop
+            QString prefix = name + '.';
+            for(int i = 0; i < it.value(); i++)
+            {
+              prefixes.append(std::make_pair(prefix, name + QString::number(i) + '.'));
+              renderRange(out, index + 1, mainEnd, values, prefixes);
+              prefixes.removeLast();
+            }
+          }
+          else if(node.elseBegin != -1)
+            renderRange(out, node.elseBegin, node.end, values, prefixes);
+        }
+        else
+        {
+          auto it = values.conditions.constFind(name);
+          if(it == values.conditions.constEnd() || !node.closed)
+            renderUnresolvedBlock(out, index, name, values, prefixes);
+          else if(it.value() == (node.type == IF))
+            renderRange(out, index + 1, mainEnd, values, prefixes);
+          else if(node.elseBegin != -1)
+            renderRange(out, node.elseBegin, node.end, values, prefixes);
+        }
+
+        // Continue after block
+        index = node.end;
+        continue;
+      }
+    }
+    index++;
+  }
+}
+
+void CompiledTemplate::renderUnresolvedBlock(QString& out, int index, const QString& name,
+                                             const TemplateValues& values, PrefixVector& prefixes) const
+{
+  const Node& node = nodes.at(index);
+  int mainEnd = node.elseBegin != -1 ? node.elseBegin : node.end;
+
+  if(node.type == IF)
+    out.append("{if ");
+  else if(node.type == IFNOT)
+    out.append("{ifnot ");
+  else
+    out.append("{loop ");
+  out.append(name).append('}');
+
+  renderRange(out, index + 1, mainEnd, values, prefixes);
+
+  if(node.elseBegin != -1)
+  {
+    out.append("{else ").append(name).append('}');
+    renderRange(out, node.elseBegin, node.end, values, prefixes);
+  }
+
+  if(node.closed)
+    out.append("{end ").append(name).append('}');
+}
+
+QString CompiledTemplate::resolveName(const QString& name, const PrefixVector& prefixes)
+{
+  // Outer loops first since inner loop names already contain the numbering of the outer ones
+  QString resolved = name;
+  for(const std::pair<QString, QString>& prefix : prefixes)
+  {
+    if(resolved.startsWith(prefix.first))
+      resolved = prefix.second + resolved.mid(prefix.first.size());
+  }
+  return resolved;
+}
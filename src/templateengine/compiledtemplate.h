@@ -0,0 +1,148 @@
+/**
+ *  @file
+ */
+
+#ifndef COMPILEDTEMPLATE_H
+#define COMPILEDTEMPLATE_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <utility>
+#include "templateglobal.h"
+
+namespace stefanfrings {
+
+/**
+ *  Variables, conditions and loop repetitions used to render a CompiledTemplate.
+ *  The methods have the same meaning as the ones in Template but can be called in any order.
+ *  @see CompiledTemplate
+ */
+class DECLSPEC TemplateValues
+{
+public:
+  /**
+   *  Value for tags with the syntax {name}
+   */
+  void setVariable(const QString& name, const QString& value);
+
+  /**
+   *  Value for tags with the syntax {if name}, {ifnot name}, {else name} and {end name}
+   */
+  void setCondition(const QString& name, bool value);
+
+  /**
+   *  Number of repetitions for tags with the syntax {loop name}, {else name} and {end name}.
+   *  Variables inside the loop are numbered like in Template::loop(), e.g. {user.name} becomes user0.name.
+   */
+  void loop(const QString& name, int repetitions);
+
+  /** Remove all values */
+  void clear();
+
+private:
+  friend class CompiledTemplate;
+
+  QHash<QString, QString> variables;
+  QHash<QString, bool> conditions;
+  QHash<QString, int> loops;
+};
+
+/**
+ *  Template which is parsed once into a flat tree of literals, variables, conditions and loops.
+ *  Rendering is done in a single pass into a pre-sized string and does not modify the object.
+ *  Therefore, an instance can be kept in TemplateCache and rendered by several threads at the same time.
+ *  <p>
+ *  Output is the same as for Template with the difference that the order of calls does not matter.
+ *  Tags without a value are copied unchanged to the output like Template does.
+ *  <p><code><pre>
+ *  QSharedPointer<const CompiledTemplate> t = templateCache->getCompiledTemplate("index");
+ *  TemplateValues values;
+ *  values.setVariable("username", "Stefan");
+ *  values.setCondition("locked", false);
+ *  values.loop("user", 2);
+ *  values.setVariable("user0.name", "Markus");
+ *  values.setVariable("user1.name", "Roland");
+ *  QString html = t->render(values);
+ *  </pre></code></p>
+ *  @see Template
+ *  @see TemplateCache
+ */
+class DECLSPEC CompiledTemplate
+{
+public:
+  /**
+   *  Parse template.
+   *  @param source The template source text
+   *  @param sourceName Name of the source file, used for logging
+   */
+  CompiledTemplate(const QString& source, const QString& sourceName);
+
+  /**
+   *  Render template using the given values.
+   *  This method is thread safe.
+   */
+  QString render(const TemplateValues& values) const;
+
+  /** Name of the source file */
+  const QString& getSourceName() const
+  {
+    return sourceName;
+  }
+
+  /** Number of parsed nodes */
+  int getNumNodes() const
+  {
+    return nodes.size();
+  }
+
+private:
+  enum NodeType
+  {
+    LITERAL,
+    VARIABLE,
+    IF,
+    IFNOT,
+    LOOP
+  };
+
+  /** Nodes are stored in pre-order. Children of a block are in the range (index, end). */
+  struct Node
+  {
+    NodeType type;
+
+    /** Text for literals or name for variables and blocks */
+    QString text;
+
+    /** Index of first node of the else part or -1 */
+    int elseBegin = -1;
+
+    /** Index of the node after the block */
+    int end = -1;
+
+    /** false if end tag is missing */
+    bool closed = true;
+  };
+
+  typedef QVector<std::pair<QString, QString> > PrefixVector;
+
+  void parse(const QString& source);
+  void appendLiteral(const QString& source, int begin, int end);
+
+  void renderRange(QString& out, int begin, int end, const TemplateValues& values, PrefixVector& prefixes) const;
+
+  /** Write block tags and both parts if there is no value or the end tag is missing */
+  void renderUnresolvedBlock(QString& out, int index, const QString& name, const TemplateValues& values,
+                             PrefixVector& prefixes) const;
+
+  /** Apply loop numbering to name */
+  static QString resolveName(const QString& name, const PrefixVector& prefixes);
+
+  QVector<Node> nodes;
+  QString sourceName;
+  int sourceSize = 0;
+};
+
+} // end of namespace
+
+#endif // COMPILEDTEMPLATE_H
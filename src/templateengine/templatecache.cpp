@@ -14,24 +14,42 @@ TemplateCache::TemplateCache(const QHash<QString, QVariant>& settings, QObject *
   qDebug("TemplateCache: timeout=%i, size=%i", cacheTimeout, cache.maxCost());
 }
 
-QString TemplateCache::tryFile(const QString localizedName)
+TemplateCache::CacheEntry TemplateCache::fetchEntry(const QString& localizedName, bool compile)
 {
   qint64 now = QDateTime::currentMSecsSinceEpoch();
-  mutex.lock();
   // search in cache
   qDebug("TemplateCache: trying cached %s", qPrintable(localizedName));
   CacheEntry *entry = cache.object(localizedName);
   if(entry && (cacheTimeout == 0 || entry->created > now - cacheTimeout))
   {
-    mutex.unlock();
-    return entry->document;
+    // Parse only once per cache entry
+    if(compile && entry->compiled.isNull() && !entry->document.isEmpty())
+      entry->compiled.reset(new CompiledTemplate(entry->document, localizedName));
+    return *entry;
   }
   // search on filesystem
   entry = new CacheEntry();
   entry->created = now;
   entry->document = TemplateLoader::tryFile(localizedName);
+  if(compile && !entry->document.isEmpty())
+    entry->compiled.reset(new CompiledTemplate(entry->document, localizedName));
+
+  // Copy before insert since QCache deletes entries which are too large immediately
+  CacheEntry retval = *entry;
+
   // Store in cache even when the file did not exist, to remember that there is no such file
   cache.insert(localizedName, entry, entry->document.size());
-  mutex.unlock();
-  return entry->document;
+  return retval;
+}
+
+QString TemplateCache::tryFile(const QString localizedName)
+{
+  QMutexLocker locker(&mutex);
+  return fetchEntry(localizedName, false /* compile */).document;
+}
+
+QSharedPointer<const CompiledTemplate> TemplateCache::tryCompiledFile(const QString localizedName)
+{
+  QMutexLocker locker(&mutex);
+  return fetchEntry(localizedName, true /* compile */).compiled;
 }
@@ -68,13 +68,27 @@ protected:
    */
   virtual QString tryFile(const QString localizedName) override;
 
+  /**
+   *  Try to get a parsed template from cache or filesystem. The template is parsed only once
+   *  and shared between all callers until the cache entry expires.
+   *  @param localizedName Name of the template with locale to find
+   *  @return The parsed template, or null if not found
+   */
+  virtual QSharedPointer<const CompiledTemplate> tryCompiledFile(const QString localizedName) override;
+
 private:
   struct CacheEntry
   {
     QString document;
+    QSharedPointer<const CompiledTemplate> compiled;
     qint64 created;
   };
 
+  /** Get a copy of a valid entry from cache or load file. Parses the template too if compile is true.
+   *  Returns a copy since QCache deletes entries exceeding the maximum cost right on insert.
+   *  Caller has to lock the mutex. */
+  CacheEntry fetchEntry(const QString& localizedName, bool compile);
+
   /** Timeout for each cached file */
   int cacheTimeout;
 
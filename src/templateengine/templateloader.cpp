@@ -60,9 +60,19 @@ QString TemplateLoader::tryFile(QString localizedName)
   return "";
 }
 
-Template TemplateLoader::getTemplate(QString templateName, QString locales)
+QSharedPointer<const CompiledTemplate> TemplateLoader::tryCompiledFile(const QString localizedName)
+{
+  QString document = tryFile(localizedName);
+  if(!document.isEmpty())
+  {
+    return QSharedPointer<const CompiledTemplate>(new CompiledTemplate(document, localizedName));
+  }
+  return QSharedPointer<const CompiledTemplate>();
+}
+
+QStringList TemplateLoader::localizedNames(const QString& templateName, const QString& locales) const
 {
-  QSet<QString> tried; // used to suppress duplicate attempts
+  QStringList names; // checked to suppress duplicate attempts
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
   QStringList locs = locales.split(',', Qt::SkipEmptyParts);
@@ -75,14 +85,9 @@ Template TemplateLoader::getTemplate(QString templateName, QString locales)
     loc.replace(QRegularExpression(";.*"), "");
     loc.replace('-', '_');
     QString localizedName = templateName + "-" + loc.trimmed();
-    if(!tried.contains(localizedName))
+    if(!names.contains(localizedName))
     {
-      QString document = tryFile(localizedName);
-      if(!document.isEmpty())
-      {
-        return Template(document, localizedName);
-      }
-      tried.insert(localizedName);
+      names.append(localizedName);
     }
   }
 
@@ -91,24 +96,43 @@ Template TemplateLoader::getTemplate(QString templateName, QString locales)
   {
     loc.replace(QRegularExpression("[;_-].*"), "");
     QString localizedName = templateName + "-" + loc.trimmed();
-    if(!tried.contains(localizedName))
+    if(!names.contains(localizedName))
     {
-      QString document = tryFile(localizedName);
-      if(!document.isEmpty())
-      {
-        return Template(document, localizedName);
-      }
-      tried.insert(localizedName);
+      names.append(localizedName);
     }
   }
 
   // Search for default file
-  QString document = tryFile(templateName);
-  if(!document.isEmpty())
+  names.append(templateName);
+  return names;
+}
+
+Template TemplateLoader::getTemplate(QString templateName, QString locales)
+{
+  foreach(const QString& localizedName, localizedNames(templateName, locales))
   {
-    return Template(document, templateName);
+    QString document = tryFile(localizedName);
+    if(!document.isEmpty())
+    {
+      return Template(document, localizedName);
+    }
   }
 
   qCritical("TemplateCache: cannot find template %s", qPrintable(templateName));
   return Template("", templateName);
 }
+
+QSharedPointer<const CompiledTemplate> TemplateLoader::getCompiledTemplate(QString templateName, QString locales)
+{
+  foreach(const QString& localizedName, localizedNames(templateName, locales))
+  {
+    QSharedPointer<const CompiledTemplate> compiled = tryCompiledFile(localizedName);
+    if(!compiled.isNull())
+    {
+      return compiled;
+    }
+  }
+
+  qCritical("TemplateCache: cannot find template %s", qPrintable(templateName));
+  return QSharedPointer<const CompiledTemplate>(new CompiledTemplate("", templateName));
+}
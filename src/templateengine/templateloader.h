@@ -9,8 +9,11 @@
 #include <QString>
 #include <QTextCodec>
 #include <QMutex>
+#include <QSharedPointer>
+#include <QStringList>
 #include "templateglobal.h"
 #include "template.h"
+#include "compiledtemplate.h"
 
 namespace stefanfrings {
 
@@ -61,6 +64,16 @@ public:
    */
   Template getTemplate(const QString templateName, const QString locales = QString());
 
+  /**
+   *  Get a parsed template for a given locale. Uses the same search order as getTemplate().
+   *  This method is thread safe.
+   *  @param templateName base name of the template file, without suffix and without locale
+   *  @param locales Requested locale(s)
+   *  @return If the template cannot be loaded, an error message is logged and an empty template is returned.
+   */
+  QSharedPointer<const CompiledTemplate> getCompiledTemplate(const QString templateName,
+                                                             const QString locales = QString());
+
 protected:
   /**
    *  Try to get a file from cache or filesystem.
@@ -69,6 +82,19 @@ protected:
    */
   virtual QString tryFile(const QString localizedName);
 
+  /**
+   *  Try to get a parsed template from cache or filesystem.
+   *  @param localizedName Name of the template with locale to find
+   *  @return The parsed template, or null if not found
+   */
+  virtual QSharedPointer<const CompiledTemplate> tryCompiledFile(const QString localizedName);
+
+  /**
+   *  Get all localized names to try in the order of preference without duplicates.
+   *  The last entry is the template name without locale.
+   */
+  QStringList localizedNames(const QString& templateName, const QString& locales) const;
+
   /** Directory where the templates are searched */
   QString templatePath;
 
@@ -19,6 +19,7 @@
 
 #include "atools.h"
 #include "util/csvreader.h"
+#include "util/csvscanner.h"
 
 namespace atools {
 namespace util {
@@ -29,6 +30,7 @@ CsvFileReader::CsvFileReader()
 }
 
 CsvFileReader::CsvFileReader(QChar separatorChar, QChar escapeChar, bool trimValues)
+  : separator(separatorChar), escape(escapeChar), trim(trimValues)
 {
   reader = new CsvReader(separatorChar, escapeChar, trimValues);
 }
@@ -57,5 +59,14 @@ void CsvFileReader::readCsvFile(QTextStream& stream)
   }
 }
 
+void CsvFileReader::readCsvData(const QByteArray& data)
+{
+  CsvScanner scanner(separator, escape, trim);
+  scanner.openData(data);
+
+  while(scanner.readRecord())
+    values.append(scanner.getValues());
+}
+
 } // namespace util
 } // namespace atools
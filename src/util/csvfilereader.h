@@ -43,6 +43,10 @@ public:
    * Content can be fetched after reading by getValues() */
   void readCsvFile(QTextStream& stream);
 
+  /* Read UTF-8 encoded CSV data using the block based CsvScanner. Same rules as above.
+   * Content can be fetched after reading by getValues() */
+  void readCsvData(const QByteArray& data);
+
   /* Get values after calling readCsvFile */
   const QVector<QStringList>& getValues() const
   {
@@ -59,6 +63,10 @@ private:
   /* List of row and column values */
   QVector<QStringList> values;
   atools::util::CsvReader *reader = nullptr;
+
+  /* Configuration */
+  QChar separator = ',', escape = '"';
+  bool trim = true;
 };
 
 } // namespace util
@@ -0,0 +1,340 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "util/csvscanner.h"
+
+#include <QDebug>
+#include <QFile>
+
+#include <cstring>
+
+namespace atools {
+namespace util {
+
+/* Byte with value 1 in each position of a 64 bit word */
+static const quint64 ONES = 0x0101010101010101ULL;
+
+/* Highest bit of each byte */
+static const quint64 HIGH_BITS = 0x8080808080808080ULL;
+
+/* Returns a value not equal to zero if any byte of word is zero.
+ * Can give false positives only for bytes following a zero byte which does not matter here. */
+inline static quint64 zeroByteMask(quint64 word)
+{
+  return (word - ONES) & ~word & HIGH_BITS;
+}
+
+// ======================================================================================================
+QString CsvField::toString() const
+{
+  QString value = QString::fromUtf8(data, size);
+
+  if(!escaped)
+    return trim ? value.trimmed() : value;
+
+  // Decode escaped field using the same rules as in CsvReader::readCsvLine()
+  QString result;
+  result.reserve(value.size());
+  bool inEscape = false;
+  QChar lastChar('\0');
+  for(int i = 0; i < value.size(); i++)
+  {
+    QChar curChar = value.at(i);
+
+    if(curChar == escape)
+    {
+      if(inEscape)
+        // End of escaped text
+        inEscape = false;
+      else
+      {
+        if(lastChar == escape)
+          // Escape char itself doubled "" - add single escape " to value and keep escaped state
+          result.append(curChar);
+        inEscape = true;
+      }
+      lastChar = curChar;
+      continue;
+    }
+
+    if(curChar == '\r' && i + 1 < value.size() && value.at(i + 1) == '\n')
+      // Drop carriage return of Windows line endings in escaped text
+      continue;
+
+    result.append(curChar);
+
+    // Linefeeds in escaped text do not change the last character like in CsvReader
+    if(curChar != '\n')
+      lastChar = curChar;
+  }
+  return result;
+}
+
+int CsvField::toInt(bool *ok) const
+{
+  return escaped ? toString().toInt(ok) : raw().toInt(ok);
+}
+
+float CsvField::toFloat(bool *ok) const
+{
+  return escaped ? toString().toFloat(ok) : raw().toFloat(ok);
+}
+
+double CsvField::toDouble(bool *ok) const
+{
+  return escaped ? toString().toDouble(ok) : raw().toDouble(ok);
+}
+
+bool CsvField::isEmpty() const
+{
+  return size == 0 || toString().isEmpty();
+}
+
+// ======================================================================================================
+CsvScanner::CsvScanner()
+{
+  init(',', '"');
+}
+
+CsvScanner::CsvScanner(QChar separatorChar, QChar escapeChar, bool trimValues)
+  : trim(trimValues)
+{
+  init(separatorChar, escapeChar);
+}
+
+CsvScanner::~CsvScanner()
+{
+  close();
+}
+
+void CsvScanner::init(QChar separatorChar, QChar escapeChar)
+{
+  escape = escapeChar;
+
+  // Non ASCII characters are searched by their first UTF-8 byte and compared fully when found
+  separatorBytes = QString(separatorChar).toUtf8();
+  escapeBytes = QString(escapeChar).toUtf8();
+  separatorFirst = separatorBytes.at(0);
+  escapeFirst = escapeBytes.at(0);
+}
+
+bool CsvScanner::openFile(const QString& filename)
+{
+  close();
+
+  file = new QFile(filename);
+  if(!file->open(QIODevice::ReadOnly))
+  {
+    errorString = file->errorString();
+    qWarning() << Q_FUNC_INFO << "Cannot open" << filename << errorString;
+    delete file;
+    file = nullptr;
+    return false;
+  }
+
+  if(file->size() > 0)
+    mapped = file->map(0, file->size());
+
+  if(mapped != nullptr)
+  {
+    begin = reinterpret_cast<const char *>(mapped);
+    end = begin + file->size();
+  }
+  else
+  {
+    // Mapping not possible - read into buffer
+    buffer = file->readAll();
+    begin = buffer.constData();
+    end = begin + buffer.size();
+  }
+
+  // Skip UTF-8 BOM
+  pos = begin;
+  if(end - pos >= 3 && std::memcmp(pos, "\xEF\xBB\xBF", 3) == 0)
+    pos += 3;
+  return true;
+}
+
+void CsvScanner::openData(const QByteArray& bytes)
+{
+  close();
+
+  buffer = bytes;
+  begin = buffer.constData();
+  end = begin + buffer.size();
+
+  pos = begin;
+  if(end - pos >= 3 && std::memcmp(pos, "\xEF\xBB\xBF", 3) == 0)
+    pos += 3;
+}
+
+void CsvScanner::close()
+{
+  fields.clear();
+
+  if(file != nullptr)
+  {
+    if(mapped != nullptr)
+      file->unmap(mapped);
+    file->close();
+    delete file;
+    file = nullptr;
+  }
+  mapped = nullptr;
+  buffer.clear();
+
+  begin = end = pos = recordStart = recordEnd = fieldStart = nullptr;
+  lineNumber = 1;
+  recordLineNumber = 0;
+  errorString.clear();
+}
+
+const char *CsvScanner::findSpecial(const char *p) const
+{
+  const quint64 separatorPattern = ONES * static_cast<quint8>(separatorFirst);
+  const quint64 escapePattern = ONES * static_cast<quint8>(escapeFirst);
+  const quint64 linefeedPattern = ONES * static_cast<quint8>('\n');
+
+  // Skip blocks of eight bytes not containing any of the characters
+  while(end - p >= 8)
+  {
+    quint64 word;
+    std::memcpy(&word, p, 8);
+
+    if(zeroByteMask(word ^ separatorPattern) | zeroByteMask(word ^ escapePattern) | zeroByteMask(word ^ linefeedPattern))
+      break;
+    p += 8;
+  }
+
+  // Find exact position in block or rest
+  while(p < end && *p != separatorFirst && *p != escapeFirst && *p != '\n')
+    p++;
+  return p;
+}
+
+void CsvScanner::appendField(const char *fieldEnd, bool fieldEscaped)
+{
+  CsvField field;
+  field.data = fieldStart;
+  field.size = static_cast<int>(fieldEnd - fieldStart);
+  field.escaped = fieldEscaped;
+  field.trim = trim;
+  field.escape = escape;
+  fields.append(field);
+}
+
+bool CsvScanner::readRecord()
+{
+  fields.clear();
+
+  // Skip empty lines ======================
+  while(pos < end)
+  {
+    if(*pos == '\n')
+      pos++;
+    else if(*pos == '\r' && end - pos >= 2 && pos[1] == '\n')
+      pos += 2;
+    else
+      break;
+    lineNumber++;
+  }
+
+  if(pos >= end)
+    return false;
+
+  recordStart = fieldStart = pos;
+  recordLineNumber = lineNumber;
+
+  bool inEscape = false, fieldEscaped = false;
+  const char *p = pos;
+  while(true)
+  {
+    p = findSpecial(p);
+
+    if(p >= end || *p == '\n')
+    {
+      if(p < end)
+        lineNumber++;
+
+      if(inEscape)
+      {
+        if(p < end)
+        {
+          // Linefeed in escaped field - continue with next line
+          p++;
+          continue;
+        }
+
+        // Incomplete record at end of file - ignore
+        fields.clear();
+        pos = end;
+        return false;
+      }
+
+      // End of record - remove carriage return of Windows line endings
+      recordEnd = p;
+      if(recordEnd > fieldStart && recordEnd[-1] == '\r')
+        recordEnd--;
+      appendField(recordEnd, fieldEscaped);
+      pos = p < end ? p + 1 : end;
+      return true;
+    }
+
+    if(*p == escapeFirst && end - p >= escapeBytes.size() && std::memcmp(p, escapeBytes.constData(), escapeBytes.size()) == 0)
+    {
+      // Escape character toggles escape state - doubled ones are resolved in CsvField::toString()
+      inEscape = !inEscape;
+      fieldEscaped = true;
+      p += escapeBytes.size();
+    }
+    else if(*p == separatorFirst && end - p >= separatorBytes.size() &&
+            std::memcmp(p, separatorBytes.constData(), separatorBytes.size()) == 0)
+    {
+      if(!inEscape)
+      {
+        // Separator in unescaped text - start new value
+        appendField(p, fieldEscaped);
+        fieldEscaped = false;
+        fieldStart = p + separatorBytes.size();
+      }
+      p += separatorBytes.size();
+    }
+    else
+      // Only first byte of a multibyte character matched
+      p++;
+  }
+}
+
+QStringList CsvScanner::getValues() const
+{
+  QStringList values;
+  values.reserve(fields.size());
+  for(const CsvField& field : fields)
+    values.append(field.toString());
+  return values;
+}
+
+QString CsvScanner::getRecordText() const
+{
+  if(recordStart != nullptr && recordEnd != nullptr && recordEnd >= recordStart)
+    return QString::fromUtf8(recordStart, static_cast<int>(recordEnd - recordStart));
+  else
+    return QString();
+}
+
+} // namespace util
+} // namespace atools
@@ -0,0 +1,173 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef ATOOLS_UTIL_CSVSCANNER_H
+#define ATOOLS_UTIL_CSVSCANNER_H
+
+#include <QByteArray>
+#include <QStringList>
+#include <QVector>
+
+class QFile;
+
+namespace atools {
+namespace util {
+
+/*
+ * View into the raw UTF-8 data of a CsvScanner for one field. Does not copy any data and
+ * converts only on request. Valid until the next call of CsvScanner::readRecord() or CsvScanner::close().
+ */
+class CsvField
+{
+public:
+  /* Decoded value with escape characters removed. Trimmed if configured and not escaped.
+   * Same result as CsvReader. */
+  QString toString() const;
+
+  /* Numbers are converted directly from the raw data if the field is not escaped */
+  int toInt(bool *ok = nullptr) const;
+  float toFloat(bool *ok = nullptr) const;
+  double toDouble(bool *ok = nullptr) const;
+
+  /* true if decoded and trimmed value is empty */
+  bool isEmpty() const;
+
+  /* Field contains escape characters and needs decoding */
+  bool isEscaped() const
+  {
+    return escaped;
+  }
+
+  /* Raw size in bytes including escape characters */
+  int getRawSize() const
+  {
+    return size;
+  }
+
+private:
+  friend class CsvScanner;
+
+  /* Raw data without copy */
+  QByteArray raw() const
+  {
+    return QByteArray::fromRawData(data, size);
+  }
+
+  const char *data = nullptr;
+  int size = 0;
+  bool escaped = false, trim = true;
+  QChar escape = '"';
+};
+
+/*
+ * Block based CSV scanner which reads a whole memory mapped file or buffer.
+ *
+ * Separators, escape characters and linefeeds are searched eight bytes at a time.
+ * Fields are exposed as CsvField views which are converted lazily.
+ *
+ * Follows the same rules as CsvReader and CsvFileReader: fields can contain separators and linefeeds if
+ * escaped and doubled escape characters are added as a single one. Empty lines are skipped and an incomplete
+ * escaped record at the end of the file is ignored. Data has to be UTF-8 encoded. A BOM is skipped.
+ * Windows and Unix line endings are recognized.
+ */
+class CsvScanner
+{
+public:
+  CsvScanner();
+  /* trimValues: Trims only text which is not escaped */
+  CsvScanner(QChar separatorChar, QChar escapeChar, bool trimValues);
+  ~CsvScanner();
+
+  CsvScanner(const CsvScanner& other) = delete;
+  CsvScanner& operator=(const CsvScanner& other) = delete;
+
+  /* Memory map the file or read it if mapping is not possible. Returns false if the file cannot be opened.
+   * Error can be fetched with getErrorString(). */
+  bool openFile(const QString& filename);
+
+  /* Scan the given data. The byte array is shallow copied. */
+  void openData(const QByteArray& bytes);
+
+  /* Unmap and close file and clear fields */
+  void close();
+
+  /* Read the next record which can span more than one line if fields are escaped.
+   * Returns false if no more records are available. */
+  bool readRecord();
+
+  /* Fields of the current record */
+  const QVector<CsvField>& getFields() const
+  {
+    return fields;
+  }
+
+  int getNumFields() const
+  {
+    return fields.size();
+  }
+
+  const CsvField& getField(int index) const
+  {
+    return fields.at(index);
+  }
+
+  /* Convert all fields of the current record. Same as CsvReader::getValues(). */
+  QStringList getValues() const;
+
+  /* Text of the current record without line ending. Used for error messages. */
+  QString getRecordText() const;
+
+  /* Number of the line in the file where the current record starts. Starts with 1. */
+  int getLineNumber() const
+  {
+    return recordLineNumber;
+  }
+
+  const QString& getErrorString() const
+  {
+    return errorString;
+  }
+
+private:
+  void init(QChar separatorChar, QChar escapeChar);
+
+  /* Find next separator, escape or linefeed starting at pos. Returns end if nothing found. */
+  const char *findSpecial(const char *pos) const;
+  void appendField(const char *fieldEnd, bool fieldEscaped);
+
+  /* UTF-8 encoded separator and escape. Only the first bytes are used when scanning. */
+  QByteArray separatorBytes, escapeBytes;
+  char separatorFirst, escapeFirst;
+  QChar escape;
+  bool trim = true;
+
+  /* Either mapped file or buffer */
+  QFile *file = nullptr;
+  uchar *mapped = nullptr;
+  QByteArray buffer;
+  const char *begin = nullptr, *end = nullptr, *pos = nullptr, *recordStart = nullptr, *recordEnd = nullptr,
+             *fieldStart = nullptr;
+
+  QVector<CsvField> fields;
+  int lineNumber = 1, recordLineNumber = 0;
+  QString errorString;
+};
+
+} // namespace util
+} // namespace atools
+
+#endif // ATOOLS_UTIL_CSVSCANNER_H
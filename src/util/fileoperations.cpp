@@ -16,6 +16,7 @@
 *****************************************************************************/
 
 #include "util/fileoperations.h"
+#include "util/parallel.h"
 #include "atools.h"
 
 #include <QDir>
@@ -316,5 +317,49 @@ bool FileOperations::canRemoveDir(const QString& dir) const
          !d.isRoot() && dir != "." && dir != ".." && dir != QDir::homePath() && dir != QDir::tempPath();
 }
 
+QFileInfoList FileOperations::findDirectories(const QString& root, const DirAcceptFuncType& accept, QDir::Filters filters)
+{
+  QFileInfoList found, level({QFileInfo(root)});
+
+  while(!level.isEmpty())
+  {
+    // List and check children for all directories of the current level in parallel ===============
+    QVector<QFileInfoList> children(level.size());
+    QVector<QVector<bool> > accepted(level.size());
+    QFileInfoList *childrenData = children.data();
+    QVector<bool> *acceptedData = accepted.data();
+    const QFileInfoList& levelRef = level;
+
+    parallelFor(level.size(), [&levelRef, childrenData, acceptedData, &accept, filters](int begin, int end) -> void {
+          for(int i = begin; i < end; i++)
+          {
+            childrenData[i] = QDir(levelRef.at(i).absoluteFilePath(), QString(), QDir::Name, filters).entryInfoList();
+            acceptedData[i].reserve(childrenData[i].size());
+            for(const QFileInfo& child : qAsConst(childrenData[i]))
+              acceptedData[i].append(accept(child));
+          }
+        }, 1 /* minChunkSize */);
+
+    // Collect results in original order ===============
+    QFileInfoList nextLevel;
+    for(int i = 0; i < children.size(); i++)
+    {
+      const QFileInfoList& childList = children.at(i);
+      for(int j = 0; j < childList.size(); j++)
+      {
+        if(accepted.at(i).at(j))
+          // Add to list and do not descent further
+          found.append(childList.at(j));
+        else
+          // Descent further
+          nextLevel.append(childList.at(j));
+      }
+    }
+    level.swap(nextLevel);
+  }
+
+  return found;
+}
+
 } // namespace util
 } // namespace atools
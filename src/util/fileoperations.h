@@ -19,11 +19,17 @@
 #define ATOOLS_FILEOPERATIONS_H
 
 #include <QCoreApplication>
+#include <QDir>
 #include <QStringList>
 
+#include <functional>
+
 namespace atools {
 namespace util {
 
+/* Callback for FileOperations::findDirectories() */
+typedef std::function<bool (const QFileInfo& dir)> DirAcceptFuncType;
+
 /*
  * Provides operations to remove or copy folder structures recursively.
  * Collects error texts separately.
@@ -64,6 +70,14 @@ public:
     return filesProcessed;
   }
 
+  /* Walks the directory tree below root breadth first. Directories for which accept returns true are added to the
+   * result and not descended into. All other directories are searched further.
+   * Directories of one tree level are listed and checked in parallel which helps on slow network drives.
+   * Order of the result is the same as for a sequential walk with directories sorted by name.
+   * accept is called from several threads and has to be thread safe. */
+  static QFileInfoList findDirectories(const QString& root, const DirAcceptFuncType& accept,
+                                       QDir::Filters filters = QDir::Dirs | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+
   /* true if a folder is allowed to be removed. false for system folders like "Documents" and root folders. */
   bool canRemoveDir(const QString& dir) const;
 
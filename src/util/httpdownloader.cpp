@@ -16,7 +16,7 @@
 *****************************************************************************/
 
 #include "util/httpdownloader.h"
-#include "util/timedcache.h"
+#include "util/lrucache.h"
 
 #include <QCoreApplication>
 #include <QFileInfo>
@@ -195,10 +195,10 @@ void HttpDownloader::setPostParameters(const QStringList& parameters)
     postParametersQuery.insert(parameters.at(i), parameters.at(i + 1));
 }
 
-void HttpDownloader::enableCache(int secondsTimeout)
+void HttpDownloader::enableCache(int secondsTimeout, qint64 maxBytes)
 {
   delete dataCache;
-  dataCache = new atools::util::TimedCache<QString, QByteArray>(secondsTimeout);
+  dataCache = new atools::util::LruCache<QString, QByteArray>(secondsTimeout * 1000LL, 0, maxBytes);
 }
 
 void HttpDownloader::disableCache()
@@ -249,7 +249,9 @@ void HttpDownloader::setDefaultUserAgentShort(const QString& extension)
 void HttpDownloader::debugDumpContainerSizes() const
 {
   if(dataCache != nullptr)
-    qDebug() << Q_FUNC_INFO << "dataCache->size()" << dataCache->size();
+    qDebug() << Q_FUNC_INFO << "dataCache->size()" << dataCache->size() << "cost" << dataCache->totalCost()
+             << "hits" << dataCache->getNumHits() << "misses" << dataCache->getNumMisses()
+             << "evictions" << dataCache->getNumEvictions();
 }
 
 void HttpDownloader::deleteReply()
@@ -294,7 +296,7 @@ void HttpDownloader::httpFinished()
     if(reply->error() == QNetworkReply::NoError)
     {
       if(dataCache != nullptr)
-        dataCache->insert(reply->url().toString(), data);
+        dataCache->insert(reply->url().toString(), data, data.size());
 
       emit downloadFinished(data, reply->url().toString());
       deleteReply();
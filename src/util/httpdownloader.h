@@ -27,7 +27,7 @@ namespace atools {
 namespace util {
 
 template<typename KEY, typename TYPE>
-class TimedCache;
+class LruCache;
 
 /*
  * Simple async HTTP download tool that reads files from web addresses.
@@ -80,8 +80,9 @@ public:
     return postParameters;
   }
 
-  /* Enable an internal cache for each request URL */
-  void enableCache(int secondsTimeout);
+  /* Enable an internal cache for each request URL. Least recently used entries are removed
+   * if the size of all cached replies exceeds maxBytes. */
+  void enableCache(int secondsTimeout, qint64 maxBytes = 50000000);
 
   /* Disable and clear cache*/
   void disableCache();
@@ -225,7 +226,7 @@ private:
   bool verbose;
 
   /* Maps URL to result */
-  atools::util::TimedCache<QString, QByteArray> *dataCache = nullptr;
+  atools::util::LruCache<QString, QByteArray> *dataCache = nullptr;
 
 };
 
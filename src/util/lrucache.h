@@ -0,0 +1,519 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef ATOOLS_UTIL_LRUCACHE_H
+#define ATOOLS_UTIL_LRUCACHE_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+
+#include <limits>
+#include <list>
+
+namespace atools {
+namespace util {
+
+/*
+ * Hash based cache with least recently used eviction and optional timeout.
+ *
+ * Entries are kept in a linked list ordered by last access. Lookup, insert, move to front and
+ * eviction are O(1). Timestamps use a monotonic clock which is cheap and not affected by
+ * system time or timezone changes.
+ *
+ * The cache is bounded by a maximum number of entries and/or a total cost. The cost of an entry
+ * is given on insert and is usually the size in bytes. Least recently used entries are removed
+ * until the cache is within both limits again. An entry having a cost larger than the maximum
+ * cost is not inserted.
+ *
+ * Timed out entries are removed when accessed or by calling removeTimedOut().
+ *
+ * Pointers returned by value() or peek() are valid until the next call of a modifying method.
+ *
+ * Not thread safe. Use SyncLruCache for access from several threads.
+ */
+template<typename KEY, typename TYPE>
+class LruCache
+{
+public:
+  /* Use as timeout to keep entries forever */
+  static const qint64 NO_TIMEOUT = std::numeric_limits<qint64>::max();
+
+  /* timeoutMs: Entries older than this are removed on access. A value <= 0 lets entries time out at once
+   *            like in TimedCache. Use NO_TIMEOUT to disable.
+   * maxEntries: Maximum number of entries. Unlimited if <= 0.
+   * maxCost: Maximum summed up cost of all entries. Unlimited if <= 0. */
+  explicit LruCache(qint64 timeoutMs = NO_TIMEOUT, int maxEntries = 0, qint64 maxCost = 0)
+    : timeout(timeoutMs), entriesLimit(maxEntries), costLimit(maxCost)
+  {
+    clock.start();
+  }
+
+  /* Copies rebuild the hash since it refers to elements of the own list */
+  LruCache(const LruCache& other)
+  {
+    operator=(other);
+  }
+
+  LruCache& operator=(const LruCache& other);
+
+  /* Add or replace an entry, move it to the front and assign a timestamp to it.
+   * Returns false if cost exceeds the maximum cost and entry was not inserted. */
+  bool insert(const KEY& key, const TYPE& value, qint64 cost = 1);
+
+  /* Get entry and move it to the front. Returns null if not found or timed out.
+   * Timed out entries are removed. Counts hits and misses. */
+  TYPE *value(const KEY& key);
+
+  /* Get entry without updating order, statistics or checking the timeout */
+  TYPE *peek(const KEY& key);
+  const TYPE *peek(const KEY& key) const;
+
+  /* Check if entry exists. Timed out entry will be removed and method will return false.
+   * Does not change order and statistics. */
+  bool contains(const KEY& key);
+
+  /* true if in cache. Timeout is not checked. */
+  bool containsNoTimeout(const KEY& key) const
+  {
+    return hash.contains(key);
+  }
+
+  /* true if entry is older than the timeout or does not exist. Does not modify cache. */
+  bool isTimedOut(const KEY& key) const;
+
+  /* Remove entry and return its value. Returns default constructed value if not found. */
+  TYPE take(const KEY& key);
+
+  /* Remove entry. Returns true if found. */
+  bool remove(const KEY& key);
+
+  /* Remove all timed out entries. Returns number of removed entries. */
+  int removeTimedOut();
+
+  /* Remove all entries. Does not reset statistics. */
+  void clear()
+  {
+    hash.clear();
+    entries.clear();
+    cost = 0;
+  }
+
+  int size() const
+  {
+    return hash.size();
+  }
+
+  bool isEmpty() const
+  {
+    return hash.isEmpty();
+  }
+
+  /* Sum of cost for all entries */
+  qint64 totalCost() const
+  {
+    return cost;
+  }
+
+  /* Change limits. Evicts entries if needed. Value <= 0 means unlimited. Timeout as in constructor. */
+  void setMaxEntries(int maxEntries);
+  void setMaxCost(qint64 maxCost);
+
+  void setTimeoutMs(qint64 timeoutMs)
+  {
+    timeout = timeoutMs;
+  }
+
+  int getMaxEntries() const
+  {
+    return entriesLimit;
+  }
+
+  qint64 getMaxCost() const
+  {
+    return costLimit;
+  }
+
+  qint64 getTimeoutMs() const
+  {
+    return timeout;
+  }
+
+  /* Statistics for lookups by value() and entries removed due to size or cost limit */
+  quint64 getNumHits() const
+  {
+    return numHits;
+  }
+
+  quint64 getNumMisses() const
+  {
+    return numMisses;
+  }
+
+  quint64 getNumEvictions() const
+  {
+    return numEvictions;
+  }
+
+  void resetStatistics()
+  {
+    numHits = numMisses = numEvictions = 0;
+  }
+
+private:
+  struct Entry
+  {
+    KEY key;
+    TYPE value;
+    qint64 timestamp, cost;
+  };
+
+  typedef typename std::list<Entry>::iterator EntryIterator;
+
+  bool entryTimedOut(const Entry& entry) const
+  {
+    return timeout != NO_TIMEOUT && clock.elapsed() - entry.timestamp > timeout;
+  }
+
+  /* Get entry and remove if timed out. Returns end of list if not found or timed out. */
+  EntryIterator findValid(const KEY& key);
+
+  void erase(EntryIterator it)
+  {
+    cost -= it->cost;
+    hash.remove(it->key);
+    entries.erase(it);
+  }
+
+  /* Remove from the end of the list until within limits */
+  void evict();
+
+  /* Most recently used at front */
+  std::list<Entry> entries;
+  QHash<KEY, EntryIterator> hash;
+
+  QElapsedTimer clock;
+  qint64 timeout, cost = 0;
+  int entriesLimit;
+  qint64 costLimit;
+  quint64 numHits = 0, numMisses = 0, numEvictions = 0;
+};
+
+template<typename KEY, typename TYPE>
+LruCache<KEY, TYPE>& LruCache<KEY, TYPE>::operator=(const LruCache& other)
+{
+  if(this != &other)
+  {
+    entries = other.entries;
+    hash.clear();
+    hash.reserve(static_cast<int>(entries.size()));
+    for(EntryIterator it = entries.begin(); it != entries.end(); ++it)
+      hash.insert(it->key, it);
+
+    // Copy clock too since timestamps are relative to it
+    clock = other.clock;
+    timeout = other.timeout;
+    cost = other.cost;
+    entriesLimit = other.entriesLimit;
+    costLimit = other.costLimit;
+    numHits = other.numHits;
+    numMisses = other.numMisses;
+    numEvictions = other.numEvictions;
+  }
+  return *this;
+}
+
+template<typename KEY, typename TYPE>
+bool LruCache<KEY, TYPE>::insert(const KEY& key, const TYPE& value, qint64 entryCost)
+{
+  auto it = hash.find(key);
+  if(it != hash.end())
+    erase(it.value());
+
+  if(costLimit > 0 && entryCost > costLimit)
+    return false;
+
+  entries.push_front({key, value, clock.elapsed(), entryCost});
+  hash.insert(key, entries.begin());
+  cost += entryCost;
+  evict();
+  return true;
+}
+
+template<typename KEY, typename TYPE>
+typename LruCache<KEY, TYPE>::EntryIterator LruCache<KEY, TYPE>::findValid(const KEY& key)
+{
+  auto it = hash.find(key);
+  if(it == hash.end())
+    return entries.end();
+
+  EntryIterator entryIt = it.value();
+  if(entryTimedOut(*entryIt))
+  {
+    erase(entryIt);
+    return entries.end();
+  }
+  return entryIt;
+}
+
+template<typename KEY, typename TYPE>
+TYPE *LruCache<KEY, TYPE>::value(const KEY& key)
+{
+  EntryIterator it = findValid(key);
+  if(it == entries.end())
+  {
+    numMisses++;
+    return nullptr;
+  }
+
+  numHits++;
+
+  // Move to front - iterators stay valid
+  entries.splice(entries.begin(), entries, it);
+  return &it->value;
+}
+
+template<typename KEY, typename TYPE>
+TYPE *LruCache<KEY, TYPE>::peek(const KEY& key)
+{
+  auto it = hash.find(key);
+  return it != hash.end() ? &it.value()->value : nullptr;
+}
+
+template<typename KEY, typename TYPE>
+const TYPE *LruCache<KEY, TYPE>::peek(const KEY& key) const
+{
+  auto it = hash.constFind(key);
+  return it != hash.constEnd() ? &it.value()->value : nullptr;
+}
+
+template<typename KEY, typename TYPE>
+bool LruCache<KEY, TYPE>::contains(const KEY& key)
+{
+  return findValid(key) != entries.end();
+}
+
+template<typename KEY, typename TYPE>
+bool LruCache<KEY, TYPE>::isTimedOut(const KEY& key) const
+{
+  auto it = hash.constFind(key);
+  return it == hash.constEnd() || entryTimedOut(*it.value());
+}
+
+template<typename KEY, typename TYPE>
+TYPE LruCache<KEY, TYPE>::take(const KEY& key)
+{
+  TYPE value;
+  auto it = hash.find(key);
+  if(it != hash.end())
+  {
+    value = it.value()->value;
+    erase(it.value());
+  }
+  return value;
+}
+
+template<typename KEY, typename TYPE>
+bool LruCache<KEY, TYPE>::remove(const KEY& key)
+{
+  auto it = hash.find(key);
+  if(it != hash.end())
+  {
+    erase(it.value());
+    return true;
+  }
+  return false;
+}
+
+template<typename KEY, typename TYPE>
+int LruCache<KEY, TYPE>::removeTimedOut()
+{
+  if(timeout == NO_TIMEOUT)
+    return 0;
+
+  // Order by access is not order by insert - check all
+  int removed = 0;
+  for(EntryIterator it = entries.begin(); it != entries.end();)
+  {
+    EntryIterator cur = it++;
+    if(entryTimedOut(*cur))
+    {
+      erase(cur);
+      removed++;
+    }
+  }
+  return removed;
+}
+
+template<typename KEY, typename TYPE>
+void LruCache<KEY, TYPE>::setMaxEntries(int maxEntries)
+{
+  entriesLimit = maxEntries;
+  evict();
+}
+
+template<typename KEY, typename TYPE>
+void LruCache<KEY, TYPE>::setMaxCost(qint64 maxCost)
+{
+  costLimit = maxCost;
+  evict();
+}
+
+template<typename KEY, typename TYPE>
+void LruCache<KEY, TYPE>::evict()
+{
+  while(!entries.empty() && ((entriesLimit > 0 && hash.size() > entriesLimit) || (costLimit > 0 && cost > costLimit)))
+  {
+    erase(std::prev(entries.end()));
+    numEvictions++;
+  }
+}
+
+/*
+ * Thread safe variant of LruCache. All methods lock an internal mutex.
+ *
+ * Values are returned as copies since pointers into the cache can be invalidated by other threads.
+ */
+template<typename KEY, typename TYPE>
+class SyncLruCache
+{
+public:
+  explicit SyncLruCache(qint64 timeoutMs = LruCache<KEY, TYPE>::NO_TIMEOUT, int maxEntries = 0, qint64 maxCost = 0)
+    : cache(timeoutMs, maxEntries, maxCost)
+  {
+  }
+
+  bool insert(const KEY& key, const TYPE& value, qint64 cost = 1)
+  {
+    QMutexLocker locker(&mutex);
+    return cache.insert(key, value, cost);
+  }
+
+  /* Copy value into result and move entry to front. Returns false if not found or timed out. */
+  bool value(const KEY& key, TYPE& result)
+  {
+    QMutexLocker locker(&mutex);
+    TYPE *val = cache.value(key);
+    if(val != nullptr)
+    {
+      result = *val;
+      return true;
+    }
+    return false;
+  }
+
+  /* Returns a copy of the value or defaultValue if not found or timed out */
+  TYPE value(const KEY& key, const TYPE& defaultValue = TYPE())
+  {
+    QMutexLocker locker(&mutex);
+    TYPE *val = cache.value(key);
+    return val != nullptr ? *val : defaultValue;
+  }
+
+  bool contains(const KEY& key)
+  {
+    QMutexLocker locker(&mutex);
+    return cache.contains(key);
+  }
+
+  TYPE take(const KEY& key)
+  {
+    QMutexLocker locker(&mutex);
+    return cache.take(key);
+  }
+
+  bool remove(const KEY& key)
+  {
+    QMutexLocker locker(&mutex);
+    return cache.remove(key);
+  }
+
+  int removeTimedOut()
+  {
+    QMutexLocker locker(&mutex);
+    return cache.removeTimedOut();
+  }
+
+  void clear()
+  {
+    QMutexLocker locker(&mutex);
+    cache.clear();
+  }
+
+  int size() const
+  {
+    QMutexLocker locker(&mutex);
+    return cache.size();
+  }
+
+  qint64 totalCost() const
+  {
+    QMutexLocker locker(&mutex);
+    return cache.totalCost();
+  }
+
+  void setMaxEntries(int maxEntries)
+  {
+    QMutexLocker locker(&mutex);
+    cache.setMaxEntries(maxEntries);
+  }
+
+  void setMaxCost(qint64 maxCost)
+  {
+    QMutexLocker locker(&mutex);
+    cache.setMaxCost(maxCost);
+  }
+
+  void setTimeoutMs(qint64 timeoutMs)
+  {
+    QMutexLocker locker(&mutex);
+    cache.setTimeoutMs(timeoutMs);
+  }
+
+  quint64 getNumHits() const
+  {
+    QMutexLocker locker(&mutex);
+    return cache.getNumHits();
+  }
+
+  quint64 getNumMisses() const
+  {
+    QMutexLocker locker(&mutex);
+    return cache.getNumMisses();
+  }
+
+  quint64 getNumEvictions() const
+  {
+    QMutexLocker locker(&mutex);
+    return cache.getNumEvictions();
+  }
+
+  void resetStatistics()
+  {
+    QMutexLocker locker(&mutex);
+    cache.resetStatistics();
+  }
+
+private:
+  LruCache<KEY, TYPE> cache;
+  mutable QMutex mutex;
+};
+
+} // namespace util
+} // namespace atools
+
+#endif // ATOOLS_UTIL_LRUCACHE_H
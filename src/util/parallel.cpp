@@ -0,0 +1,106 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "util/parallel.h"
+
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+
+namespace atools {
+namespace util {
+
+namespace internal {
+
+/* Runs one chunk and releases the semaphore when done */
+class ParallelRangeTask :
+  public QRunnable
+{
+public:
+  ParallelRangeTask(const ParallelRangeFuncType& funcParam, int beginParam, int endParam, QSemaphore *semaphoreParam)
+    : func(funcParam), begin(beginParam), end(endParam), semaphore(semaphoreParam)
+  {
+    setAutoDelete(true);
+  }
+
+  virtual void run() override
+  {
+    func(begin, end);
+    semaphore->release();
+  }
+
+private:
+  const ParallelRangeFuncType& func;
+  int begin, end;
+  QSemaphore *semaphore;
+};
+
+} // namespace internal
+
+int parallelThreadCount(int size, int minChunkSize, int maxThreads)
+{
+  if(maxThreads <= 0)
+    maxThreads = QThread::idealThreadCount();
+
+  int threads = std::min(maxThreads, size / std::max(minChunkSize, 1));
+  return std::max(threads, 1);
+}
+
+void parallelFor(int size, const ParallelRangeFuncType& func, int minChunkSize, int maxThreads)
+{
+  if(size <= 0)
+    return;
+
+  int threads = parallelThreadCount(size, minChunkSize, maxThreads);
+  if(threads == 1)
+  {
+    func(0, size);
+    return;
+  }
+
+  int chunkSize = (size + threads - 1) / threads;
+  QSemaphore semaphore;
+  int started = 0;
+
+  // Start all chunks except the first one in the pool =============
+  for(int begin = chunkSize; begin < size; begin += chunkSize)
+  {
+    int end = std::min(begin + chunkSize, size);
+    internal::ParallelRangeTask *task = new internal::ParallelRangeTask(func, begin, end, &semaphore);
+
+    if(QThreadPool::globalInstance()->tryStart(task))
+      started++;
+    else
+    {
+      // No thread available - run in this thread
+      delete task;
+      func(begin, end);
+    }
+  }
+
+  // First chunk in calling thread =============
+  func(0, std::min(chunkSize, size));
+
+  // Wait for all pool threads
+  semaphore.acquire(started);
+}
+
+} // namespace util
+} // namespace atools
@@ -0,0 +1,48 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef ATOOLS_UTIL_PARALLEL_H
+#define ATOOLS_UTIL_PARALLEL_H
+
+#include <functional>
+
+namespace atools {
+namespace util {
+
+/* Callback for parallelFor() getting a half open range [begin, end) */
+typedef std::function<void (int begin, int end)> ParallelRangeFuncType;
+
+/*
+ * Splits the range [0, size) into chunks and calls func for each chunk in parallel using the global
+ * QThreadPool. One chunk is always processed in the calling thread. Blocks until all chunks are done.
+ *
+ * Chunks are never smaller than minChunkSize. Runs everything in the calling thread if size is too small or
+ * if no pool thread is available. The latter avoids deadlocks when called from inside a pool thread.
+ *
+ * maxThreads limits the number of threads including the calling one. Uses QThread::idealThreadCount() if <= 0.
+ *
+ * func has to be thread safe and should only write to data which is disjoint between ranges.
+ */
+void parallelFor(int size, const ParallelRangeFuncType& func, int minChunkSize = 1000, int maxThreads = 0);
+
+/* Number of threads which will be used by parallelFor() for the given parameters */
+int parallelThreadCount(int size, int minChunkSize = 1000, int maxThreads = 0);
+
+} // namespace util
+} // namespace atools
+
+#endif // ATOOLS_UTIL_PARALLEL_H
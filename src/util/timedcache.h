@@ -18,139 +18,94 @@
 #ifndef ATOOLS_UTIL_TIMEDCACHE_H
 #define ATOOLS_UTIL_TIMEDCACHE_H
 
-#include <QDateTime>
+#include "util/lrucache.h"
 
 namespace atools {
 namespace util {
 
-/* Simple hash that removes entries on timeout when they are accessed */
+/* Simple hash that removes entries on timeout when they are accessed.
+ * Kept for compatibility. Based on LruCache without size limits - use LruCache for new code.
+ * A timeout <= 0 lets entries time out immediately as before. Copies are independent. */
 template<typename KEY, typename TYPE>
 class TimedCache
 {
 public:
   TimedCache(int timeoutSeconds)
-    : timeout(timeoutSeconds)
+    : cache(timeoutSeconds * 1000LL)
   {
   }
 
   /* Add an entry and assign a timestamp to it **/
-  void insert(const KEY& key, const TYPE& type);
+  void insert(const KEY& key, const TYPE& type)
+  {
+    cache.insert(key, type);
+  }
 
   /* Check if entry exists. If timed out entry will be removed and method will return null */
   bool contains(const KEY& key)
   {
-    return checkTimeout(key) != nullptr;
+    return cache.contains(key);
   }
 
   /* Get entry. If timed out entry will be removed and method will return null */
   TYPE *value(const KEY& key)
   {
-    return checkTimeout(key);
+    return cache.value(key);
   }
 
   void clear()
   {
-    hash.clear();
+    cache.clear();
   }
 
   /* true if object is old. does not modify cache */
-  bool isTimedOut(const KEY& key) const;
+  bool isTimedOut(const KEY& key) const
+  {
+    return cache.isTimedOut(key);
+  }
 
   /* Flush from cache if old. true if timed out */
-  bool timeOut(const KEY& key);
+  bool timeOut(const KEY& key)
+  {
+    return !cache.contains(key);
+  }
 
   /* true if in cache. Timmout is not triggered */
   bool containsNoTimeout(const KEY& key) const
   {
-    return hash.contains(key);
+    return cache.containsNoTimeout(key);
   }
 
   /* Get from cache. Timeout is not triggered */
-  TYPE *valueNoTimeout(const KEY& key);
+  TYPE *valueNoTimeout(const KEY& key)
+  {
+    return cache.peek(key);
+  }
 
   /* Return a copy and then timeout value */
-  TYPE valueCopyAndTimeout(const KEY& key);
-
-  void remove(const KEY& key);
-
-  int size() const
+  TYPE valueCopyAndTimeout(const KEY& key)
   {
-    return hash.size();
+    TYPE type;
+    TYPE *ptr = cache.peek(key);
+    if(ptr != nullptr)
+      type = *ptr;
+    timeOut(key);
+    return type;
   }
 
-private:
-  struct Entry
+  void remove(const KEY& key)
   {
-    TYPE value;
-    QDateTime timestamp;
-  };
-
-  TYPE *checkTimeout(const KEY& key);
-
-  QHash<KEY, Entry> hash;
-  int timeout;
-};
-
-template<typename KEY, typename TYPE>
-void TimedCache<KEY, TYPE>::insert(const KEY& key, const TYPE& type)
-{
-  hash.insert(key, {type, QDateTime::currentDateTime()});
-}
+    cache.remove(key);
+  }
 
-template<typename KEY, typename TYPE>
-TYPE *TimedCache<KEY, TYPE>::checkTimeout(const KEY& key)
-{
-  if(!hash.contains(key))
-    return nullptr;
-  else
+  int size() const
   {
-    if(isTimedOut(key))
-    {
-      hash.remove(key);
-      return nullptr;
-    }
-    else
-      return &hash[key].value;
+    return cache.size();
   }
-}
-
-template<typename KEY, typename TYPE>
-bool TimedCache<KEY, TYPE>::isTimedOut(const KEY& key) const
-{
-  return hash.value(key).timestamp.addSecs(timeout) < QDateTime::currentDateTime();
-}
 
-template<typename KEY, typename TYPE>
-bool TimedCache<KEY, TYPE>::timeOut(const KEY& key)
-{
-  return checkTimeout(key) == nullptr;
-}
-
-template<typename KEY, typename TYPE>
-TYPE *TimedCache<KEY, TYPE>::valueNoTimeout(const KEY& key)
-{
-  if(containsNoTimeout(key))
-    return &hash[key].value;
-  else
-    return nullptr;
-}
-
-template<typename KEY, typename TYPE>
-TYPE TimedCache<KEY, TYPE>::valueCopyAndTimeout(const KEY& key)
-{
-  TYPE type;
-  TYPE *ptr = valueNoTimeout(key);
-  if(ptr != nullptr)
-    type = *ptr;
-  timeOut(key);
-  return type;
-}
-
-template<typename KEY, typename TYPE>
-void TimedCache<KEY, TYPE>::remove(const KEY& key)
-{
-  hash.remove(key);
-}
+private:
+  LruCache<KEY, TYPE> cache;
+};
 
 } // namespace util
 } // namespace atools
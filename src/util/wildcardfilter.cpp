@@ -0,0 +1,247 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "util/wildcardfilter.h"
+
+#include <QVarLengthArray>
+
+#include <algorithm>
+
+namespace atools {
+namespace util {
+
+/* Fold character by character like QRegExp does for case insensitive matching */
+inline static ushort foldChar(QChar c)
+{
+  return c.toLower().unicode();
+}
+
+static QString foldString(const QString& string)
+{
+  QString folded(string);
+  for(QChar& c : folded)
+    c = QChar(foldChar(c));
+  return folded;
+}
+
+inline static bool isWildcard(QChar c)
+{
+  return c == '*' || c == '?' || c == '[';
+}
+
+static bool hasWildcard(const QString& string, int from, int to)
+{
+  for(int i = from; i < to; i++)
+  {
+    if(isWildcard(string.at(i)))
+      return true;
+  }
+  return false;
+}
+
+inline static quint64 edgeKey(int node, ushort c)
+{
+  return (static_cast<quint64>(node) << 16) | c;
+}
+
+// ================================================================================================
+void WildcardFilter::Trie::insert(const QString& string, bool reverse)
+{
+  int node = 0;
+  for(int i = 0; i < string.size(); i++)
+  {
+    ushort c = foldChar(string.at(reverse ? string.size() - 1 - i : i));
+    quint64 key = edgeKey(node, c);
+
+    auto it = edges.constFind(key);
+    if(it == edges.constEnd())
+    {
+      int child = terminal.size();
+      terminal.append(false);
+      edges.insert(key, child);
+      node = child;
+    }
+    else
+      node = it.value();
+  }
+  terminal[node] = true;
+}
+
+bool WildcardFilter::Trie::matchesAnyPrefix(const QString& string, bool reverse) const
+{
+  int node = 0;
+  if(terminal.at(node))
+    return true;
+
+  for(int i = 0; i < string.size(); i++)
+  {
+    auto it = edges.constFind(edgeKey(node, foldChar(string.at(reverse ? string.size() - 1 - i : i))));
+    if(it == edges.constEnd())
+      return false;
+
+    node = it.value();
+    if(terminal.at(node))
+      return true;
+  }
+  return false;
+}
+
+// ================================================================================================
+void WildcardFilter::addPattern(const QString& pattern)
+{
+  patterns.append(pattern);
+
+  int size = pattern.size();
+  if(pattern.contains('['))
+    // Character sets are rare - leave the exact semantics to QRegExp
+    regExps.append(QRegExp(pattern, Qt::CaseInsensitive, QRegExp::Wildcard));
+  else if(!hasWildcard(pattern, 0, size))
+    exact.insert(foldString(pattern));
+  else if(pattern.endsWith('*') && !hasWildcard(pattern, 0, size - 1))
+    // "abc*"
+    prefixes.insert(pattern.left(size - 1), false /* reverse */);
+  else if(pattern.startsWith('*') && !hasWildcard(pattern, 1, size))
+    // "*abc"
+    suffixes.insert(pattern.mid(1), true /* reverse */);
+  else
+  {
+    // Add to combined automaton ==========================
+    globStarts.append(globTokens.size());
+    for(QChar c : pattern)
+    {
+      if(c == '*')
+      {
+        // Collapse consecutive stars
+        if(globTokens.size() == globStarts.constLast() || globTokens.constLast().type != GlobToken::STAR)
+          globTokens.append({GlobToken::STAR, 0});
+      }
+      else if(c == '?')
+        globTokens.append({GlobToken::ANY, 0});
+      else
+        globTokens.append({GlobToken::LITERAL, foldChar(c)});
+    }
+    globTokens.append({GlobToken::END, 0});
+  }
+}
+
+bool WildcardFilter::matches(const QString& string) const
+{
+  if(patterns.isEmpty())
+    return false;
+
+  if(!exact.isEmpty() && exact.contains(foldString(string)))
+    return true;
+
+  if(!prefixes.isEmpty() && prefixes.matchesAnyPrefix(string, false /* reverse */))
+    return true;
+
+  if(!suffixes.isEmpty() && suffixes.matchesAnyPrefix(string, true /* reverse */))
+    return true;
+
+  if(!globStarts.isEmpty() && matchesGlob(string))
+    return true;
+
+  for(const QRegExp& regExp : regExps)
+  {
+    if(regExp.exactMatch(string))
+      return true;
+  }
+  return false;
+}
+
+bool WildcardFilter::matchesGlob(const QString& string) const
+{
+  // Simulate all patterns at once - states are token indexes
+  // Mark holds the step number when a state was last added to avoid duplicates
+  QVarLengthArray<int, 256> mark(globTokens.size());
+  std::fill(mark.begin(), mark.end(), -1);
+
+  QVarLengthArray<int, 64> current, next;
+
+  // Add state and follow star since it can match an empty string
+  auto add = [this, &mark](QVarLengthArray<int, 64>& states, int state, int step) -> void {
+               while(mark[state] != step)
+               {
+                 mark[state] = step;
+                 states.append(state);
+                 if(globTokens.at(state).type != GlobToken::STAR)
+                   break;
+                 state++;
+               }
+             };
+
+  for(int start : globStarts)
+    add(current, start, 0);
+
+  for(int i = 0; i < string.size() && !current.isEmpty(); i++)
+  {
+    ushort c = foldChar(string.at(i));
+    next.clear();
+    for(int state : current)
+    {
+      const GlobToken& token = globTokens.at(state);
+      switch(token.type)
+      {
+        case GlobToken::STAR:
+          add(next, state, i + 1);
+          break;
+
+        case GlobToken::ANY:
+          add(next, state + 1, i + 1);
+          break;
+
+        case GlobToken::LITERAL:
+          if(token.ch == c)
+            add(next, state + 1, i + 1);
+          break;
+
+        case GlobToken::END:
+          break;
+      }
+    }
+    std::swap(current, next);
+  }
+
+  for(int state : current)
+  {
+    if(globTokens.at(state).type == GlobToken::END)
+      return true;
+  }
+  return false;
+}
+
+void WildcardFilter::clear()
+{
+  patterns.clear();
+  exact.clear();
+  prefixes = Trie();
+  suffixes = Trie();
+  globTokens.clear();
+  globStarts.clear();
+  regExps.clear();
+}
+
+QList<QRegExp> WildcardFilter::toRegExpList() const
+{
+  QList<QRegExp> list;
+  for(const QString& pattern : patterns)
+    list.append(QRegExp(pattern, Qt::CaseInsensitive, QRegExp::Wildcard));
+  return list;
+}
+
+} // namespace util
+} // namespace atools
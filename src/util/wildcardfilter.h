@@ -0,0 +1,120 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef ATOOLS_UTIL_WILDCARDFILTER_H
+#define ATOOLS_UTIL_WILDCARDFILTER_H
+
+#include <QHash>
+#include <QList>
+#include <QRegExp>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+namespace atools {
+namespace util {
+
+/*
+ * Set of case insensitive wildcard patterns which can be tested against a string in one pass.
+ * Matches exactly like a list of QRegExp with Qt::CaseInsensitive and QRegExp::Wildcard using exactMatch()
+ * where any matching pattern gives a match.
+ *
+ * Patterns are sorted into groups when added:
+ * Plain strings go into a hash set, patterns ending with a single "*" into a prefix trie and patterns starting
+ * with a single "*" into a suffix trie. Remaining patterns using "*" and "?" are combined into one automaton
+ * which is run for all patterns at once. Patterns with character sets "[...]" are kept as QRegExp.
+ */
+class WildcardFilter
+{
+public:
+  /* Add pattern as is. Call trimmed() before if needed. */
+  void addPattern(const QString& pattern);
+
+  void addPatterns(const QStringList& patternList)
+  {
+    for(const QString& pattern : patternList)
+      addPattern(pattern);
+  }
+
+  /* true if any pattern matches the whole string */
+  bool matches(const QString& string) const;
+
+  bool isEmpty() const
+  {
+    return patterns.isEmpty();
+  }
+
+  void clear();
+
+  /* All patterns in order of adding */
+  const QStringList& getPatterns() const
+  {
+    return patterns;
+  }
+
+  /* Patterns as wildcard regular expressions for code needing QRegExp */
+  QList<QRegExp> toRegExpList() const;
+
+private:
+  /* Tree of case folded characters. Node 0 is the root. */
+  struct Trie
+  {
+    void insert(const QString& string, bool reverse);
+
+    /* true if a terminal node is reached while walking along string */
+    bool matchesAnyPrefix(const QString& string, bool reverse) const;
+
+    /* Root is terminal for an empty string like from pattern "*" which matches everything */
+    bool isEmpty() const
+    {
+      return terminal.size() <= 1 && !terminal.at(0);
+    }
+
+    /* Key is node index shifted left by 16 bits or'ed with the character */
+    QHash<quint64, int> edges;
+    QVector<bool> terminal = {false};
+  };
+
+  /* Element of the combined automaton */
+  struct GlobToken
+  {
+    enum Type : quint8
+    {
+      LITERAL, /* Matches ch */
+      ANY, /* ? */
+      STAR, /* * */
+      END /* Pattern matched */
+    };
+
+    Type type;
+    ushort ch;
+  };
+
+  bool matchesGlob(const QString& string) const;
+
+  QStringList patterns;
+  QSet<QString> exact;
+  Trie prefixes, suffixes;
+  QVector<GlobToken> globTokens; /* Tokens of all patterns. Each one terminated by END. */
+  QVector<int> globStarts; /* Index of first token for each pattern */
+  QList<QRegExp> regExps; /* Patterns with character sets */
+};
+
+} // namespace util
+} // namespace atools
+
+#endif // ATOOLS_UTIL_WILDCARDFILTER_H
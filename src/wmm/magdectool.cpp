@@ -19,6 +19,7 @@
 #include "io/tempfile.h"
 #include "exception.h"
 #include "geo/pos.h"
+#include "util/parallel.h"
 
 extern "C" {
 #include <stdio.h>
@@ -44,10 +45,11 @@ extern "C" {
 namespace atools {
 namespace wmm {
 
-/* Copy of MAG_Grid function with simplifications also avoiding the need to write the output to a file */
+/* Copy of MAG_Grid function with simplifications also avoiding the need to write the output to a file.
+ * Calculates bands of latitudes in parallel. */
 QVector<float> MAG_GridInternal(int year, int month,
                                 MAGtype_MagneticModel *magneticModel,
-                                MAGtype_Geoid *Geoid, MAGtype_Ellipsoid ellipsoid);
+                                MAGtype_Geoid *Geoid, MAGtype_Ellipsoid ellipsoid, int maxThreads);
 
 // ==============================================================================
 
@@ -66,7 +68,7 @@ void MagDecTool::init(const QDate& dateTimeParam)
   return init(dateTimeParam.year(), dateTimeParam.month());
 }
 
-void MagDecTool::init(int year, int month)
+void MagDecTool::init(int year, int month, int maxThreads)
 {
   clear();
 
@@ -116,7 +118,7 @@ void MagDecTool::init(int year, int month)
   geoid.Geoid_Initialized = 1;
 
   // Calculate declination grid
-  QVector<float> declinations = MAG_GridInternal(year, month, magneticModel, &geoid, ellipsoid);
+  QVector<float> declinations = MAG_GridInternal(year, month, magneticModel, &geoid, ellipsoid, maxThreads);
   if(declinations.isEmpty())
     throw atools::Exception(tr("Error in MAG_GridInternal."));
 
@@ -163,6 +165,16 @@ QString MagDecTool::getVersion() const
   return VERSIONDATE_LARGE;
 }
 
+QString MagDecTool::getCoefficientVersion()
+{
+  // Header line contains epoch, model name and release date like "2025.0 WMM-2025 11/13/2024"
+  QFile file(QString(":/atools/resources/wmm/WMM.COF"));
+  if(file.open(QIODevice::ReadOnly))
+    return QString::fromLatin1(file.readLine()).simplified();
+  else
+    throw atools::Exception(tr("Cannot open coeffizient file \"%1\".").arg(file.fileName()));
+}
+
 float MagDecTool::getMagVar(const geo::Pos& pos)
 {
   if(pos.nearGrid(1.f, atools::geo::Pos::POS_EPSILON_500M))
@@ -216,94 +228,83 @@ QVector<float> MagDecTool::readGeoidBuffer()
 }
 
 QVector<float> MAG_GridInternal(int year, int month, MAGtype_MagneticModel *magneticModel,
-                                MAGtype_Geoid *geoid, MAGtype_Ellipsoid ellipsoid)
+                                MAGtype_Geoid *geoid, MAGtype_Ellipsoid ellipsoid, int maxThreads)
 {
-  // Boundary always covers whole world
-  MAGtype_CoordGeodetic minimum;
-  minimum.phi = -90.;
-  minimum.lambda = -180.;
-  minimum.HeightAboveGeoid = minimum.HeightAboveEllipsoid = 0.;
-  minimum.UseGeoid = 1;
-
-  MAGtype_CoordGeodetic maximum;
-  maximum.phi = 90.;
-  maximum.lambda = 179.;
-  maximum.HeightAboveGeoid = maximum.HeightAboveEllipsoid = 0.;
-  maximum.UseGeoid = 1;
-
   // Only one date - no range
-  MAGtype_Date startdate, enddate;
-  startdate.DecimalYear = enddate.DecimalYear = year + (month - 1) / 12.;
+  MAGtype_Date date;
+  date.DecimalYear = year + (month - 1) / 12.;
 
-  int numTerms;
-  double b, c;
+  int numTerms = ((magneticModel->nMax + 1) * (magneticModel->nMax + 2) / 2);
 
-  MAGtype_MagneticModel *timedMagneticModel;
-  MAGtype_CoordSpherical coordSpherical;
-  MAGtype_MagneticResults magneticResultsSph, magneticResultsGeo, magneticResultsSphVar, magneticResultsGeoVar;
-  MAGtype_SphericalHarmonicVariables *sphericalVariables;
-  MAGtype_GeoMagneticElements geoMagneticElements, errors;
-  MAGtype_LegendreFunction *legendreFunction;
+  // This modifies the Magnetic coefficients to the correct date.
+  // Depends only on date - done once and shared read only by all threads
+  MAGtype_MagneticModel *timedMagneticModel = MAG_AllocateModelMemory(numTerms);
+  MAG_TimelyModifyMagneticModel(date, magneticModel, timedMagneticModel);
 
-  double cord_step_size = 1.;
-  if(fabs(cord_step_size) < 1.0e-10)
-    cord_step_size = 99999.0; // checks to make sure that the step_size is not too small
+  // Latitude Y -90 to 90 and longitude X -180 to 179
+  QVector<float> retval(360 * 181);
+  float *values = retval.data();
 
-  numTerms = ((magneticModel->nMax + 1) * (magneticModel->nMax + 2) / 2);
-  timedMagneticModel = MAG_AllocateModelMemory(numTerms);
-  legendreFunction = MAG_AllocateLegendreFunctionMemory(numTerms); // For storing the ALF functions
-  sphericalVariables = MAG_AllocateSphVarMemory(magneticModel->nMax);
+  // Calculate bands of latitude rows in parallel - geoid and models are only read
+  atools::util::parallelFor(181, [ = ](int beginRow, int endRow) -> void {
+          // Working memory for each band
+          MAGtype_LegendreFunction *legendreFunction = MAG_AllocateLegendreFunctionMemory(numTerms); // For storing the ALF functions
+          MAGtype_SphericalHarmonicVariables *sphericalVariables = MAG_AllocateSphVarMemory(magneticModel->nMax);
 
-  QVector<float> retval;
-  retval.reserve(360 * 181);
+          MAGtype_CoordSpherical coordSpherical;
+          MAGtype_MagneticResults magneticResultsSph, magneticResultsGeo, magneticResultsSphVar, magneticResultsGeoVar;
+          MAGtype_GeoMagneticElements geoMagneticElements;
 
-  b = minimum.phi;
-  c = minimum.lambda;
-  for(minimum.phi = b; minimum.phi <= maximum.phi; minimum.phi += cord_step_size) // Latitude Y loop
-  {
-    for(minimum.lambda = c; minimum.lambda <= maximum.lambda; minimum.lambda += cord_step_size) // Longitude X loop
-    {
-      if(geoid->UseGeoid == 1)
-        // This converts the height above mean sea level to height above the WGS-84 ellipsoid
-        MAG_ConvertGeoidToEllipsoidHeight(&minimum, geoid);
-      else
-        minimum.HeightAboveEllipsoid = minimum.HeightAboveGeoid;
+          MAGtype_CoordGeodetic coord;
+          coord.UseGeoid = 1;
+
+          for(int row = beginRow; row < endRow; row++) // Latitude Y loop
+          {
+            for(int col = 0; col < 360; col++) // Longitude X loop
+            {
+              coord.phi = row - 90.;
+              coord.lambda = col - 180.;
+              coord.HeightAboveGeoid = coord.HeightAboveEllipsoid = 0.;
+
+              if(geoid->UseGeoid == 1)
+                // This converts the height above mean sea level to height above the WGS-84 ellipsoid
+                MAG_ConvertGeoidToEllipsoidHeight(&coord, geoid);
+              else
+                coord.HeightAboveEllipsoid = coord.HeightAboveGeoid;
 
-      MAG_GeodeticToSpherical(ellipsoid, minimum, &coordSpherical);
+              MAG_GeodeticToSpherical(ellipsoid, coord, &coordSpherical);
 
-      // Compute Spherical Harmonic variables
-      MAG_ComputeSphericalHarmonicVariables(ellipsoid, coordSpherical, magneticModel->nMax, sphericalVariables);
+              // Compute Spherical Harmonic variables
+              MAG_ComputeSphericalHarmonicVariables(ellipsoid, coordSpherical, magneticModel->nMax, sphericalVariables);
 
-      // Compute ALF  Equations 5-6, WMM Technical report
-      MAG_AssociatedLegendreFunction(coordSpherical, magneticModel->nMax, legendreFunction);
+              // Compute ALF  Equations 5-6, WMM Technical report
+              MAG_AssociatedLegendreFunction(coordSpherical, magneticModel->nMax, legendreFunction);
 
-      // This modifies the Magnetic coefficients to the correct date.
-      MAG_TimelyModifyMagneticModel(startdate, magneticModel, timedMagneticModel);
+              // Accumulate the spherical harmonic coefficients Equations 10:12 , WMM Technical report
+              MAG_Summation(legendreFunction, timedMagneticModel, *sphericalVariables, coordSpherical, &magneticResultsSph);
 
-      // Accumulate the spherical harmonic coefficients Equations 10:12 , WMM Technical report
-      MAG_Summation(legendreFunction, timedMagneticModel, *sphericalVariables, coordSpherical, &magneticResultsSph);
+              // Sum the Secular Variation Coefficients, Equations 13:15 , WMM Technical report
+              MAG_SecVarSummation(legendreFunction, timedMagneticModel, *sphericalVariables, coordSpherical,
+                                  &magneticResultsSphVar);
 
-      // Sum the Secular Variation Coefficients, Equations 13:15 , WMM Technical report
-      MAG_SecVarSummation(legendreFunction, timedMagneticModel, *sphericalVariables, coordSpherical,
-                          &magneticResultsSphVar);
+              // Map the computed Magnetic fields to Geodetic coordinates Equation 16 , WMM Technical report
+              MAG_RotateMagneticVector(coordSpherical, coord, magneticResultsSph, &magneticResultsGeo);
 
-      // Map the computed Magnetic fields to Geodetic coordinates Equation 16 , WMM Technical report
-      MAG_RotateMagneticVector(coordSpherical, minimum, magneticResultsSph, &magneticResultsGeo);
+              // Map the secular variation field components to Geodetic coordinates, Equation 17 , WMM Technical report
+              MAG_RotateMagneticVector(coordSpherical, coord, magneticResultsSphVar, &magneticResultsGeoVar);
 
-      // Map the secular variation field components to Geodetic coordinates, Equation 17 , WMM Technical report
-      MAG_RotateMagneticVector(coordSpherical, minimum, magneticResultsSphVar, &magneticResultsGeoVar);
+              // Calculate the Geomagnetic elements, Equation 18 , WMM Technical report
+              MAG_CalculateGeoMagneticElements(&magneticResultsGeo, &geoMagneticElements);
 
-      // Calculate the Geomagnetic elements, Equation 18 , WMM Technical report
-      MAG_CalculateGeoMagneticElements(&magneticResultsGeo, &geoMagneticElements);
-      MAG_WMMErrorCalc(geoMagneticElements.H, &errors);
+              values[row * 360 + col] = static_cast<float>(geoMagneticElements.Decl);
+            } // Longitude Loop
+          } // Latitude Loop
 
-      retval.append(static_cast<float>(geoMagneticElements.Decl));
-    } // Longitude Loop
-  } // Latitude Loop
+          MAG_FreeLegendreMemory(legendreFunction);
+          MAG_FreeSphVarMemory(sphericalVariables);
+        }, 8 /* minChunkSize */, maxThreads);
 
   MAG_FreeMagneticModelMemory(timedMagneticModel);
-  MAG_FreeLegendreMemory(legendreFunction);
-  MAG_FreeSphVarMemory(sphericalVariables);
 
   return retval;
 }
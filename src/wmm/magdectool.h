@@ -46,13 +46,18 @@ public:
   MagDecTool(const MagDecTool& other) = delete;
   MagDecTool& operator=(const MagDecTool& other) = delete;
 
-  /* Build the declination array for current year/month or given values. January = 1 */
-  void init(int year = 0, int month = 1);
+  /* Build the declination array for current year/month or given values. January = 1
+   * Latitude bands are calculated in parallel using up to maxThreads or QThread::idealThreadCount() if <= 0.
+   * maxThreads = 1 calculates all in the calling thread. */
+  void init(int year = 0, int month = 1, int maxThreads = 0);
   void init(const QDate& dateTime);
 
   /* Get version information for the GeomagnetismLibrary */
   QString getVersion() const;
 
+  /* Header of the coeffizient file with epoch, model name and release date. Changes with each model update. */
+  static QString getCoefficientVersion();
+
   /* Get magnetic variance/declination. Positive is east and negative is west. */
   float getMagVar(const atools::geo::Pos& pos);
 
@@ -0,0 +1,376 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "zip/gzipdevice.h"
+
+#include <QDebug>
+
+#include <algorithm>
+#include <limits>
+
+#include <zlib.h>
+
+/* 15 bit window plus 16 for gzip header and trailer */
+#define GZIP_WINDOW_BITS 15 + 16
+
+namespace atools {
+namespace zip {
+
+/* Largest chunk which can be passed to zlib in one call */
+static const qint64 MAX_ZLIB_LEN = std::numeric_limits<uInt>::max();
+
+/* Minimum size of internal buffers */
+static const int MIN_CHUNK_SIZE = 1024;
+
+// ===============================================================================================
+GzipReader::GzipReader(QIODevice *sourceDevice, int chunkSize)
+  : source(sourceDevice), stream(new z_stream)
+{
+  inBuffer.resize(std::max(chunkSize, MIN_CHUNK_SIZE));
+}
+
+GzipReader::~GzipReader()
+{
+  close();
+
+  if(streamInitialized)
+    inflateEnd(stream);
+  delete stream;
+}
+
+void GzipReader::setSourceDevice(QIODevice *sourceDevice)
+{
+  close();
+  source = sourceDevice;
+}
+
+bool GzipReader::open(OpenMode mode)
+{
+  if((mode & QIODevice::ReadWrite) != QIODevice::ReadOnly)
+  {
+    qWarning() << Q_FUNC_INFO << "Only read only mode supported" << mode;
+    return false;
+  }
+
+  if(source == nullptr || !source->isReadable())
+  {
+    setErrorString(QString("Source device is not readable"));
+    return false;
+  }
+
+  int err;
+  if(streamInitialized)
+    // Keep allocated state
+    err = inflateReset(stream);
+  else
+  {
+    stream->zalloc = Z_NULL;
+    stream->zfree = Z_NULL;
+    stream->opaque = Z_NULL;
+    stream->next_in = Z_NULL;
+    stream->avail_in = 0;
+    err = inflateInit2(stream, GZIP_WINDOW_BITS);
+    streamInitialized = err == Z_OK;
+  }
+
+  if(err != Z_OK)
+  {
+    setErrorString(QString("Cannot initialize decompression: %1").arg(err));
+    return false;
+  }
+
+  stream->next_in = Z_NULL;
+  stream->avail_in = 0;
+  finished = failed = false;
+  totalIn = totalOut = 0;
+
+  return QIODevice::open(mode);
+}
+
+void GzipReader::close()
+{
+  if(isOpen())
+    QIODevice::close();
+}
+
+bool GzipReader::atEnd() const
+{
+  return !isOpen() || (finished && QIODevice::atEnd());
+}
+
+qint64 GzipReader::fillBuffer()
+{
+  qint64 numRead = source->read(inBuffer.data(), inBuffer.size());
+  if(numRead > 0)
+  {
+    stream->next_in = reinterpret_cast<Bytef *>(inBuffer.data());
+    stream->avail_in = static_cast<uInt>(numRead);
+    totalIn += numRead;
+  }
+  return numRead;
+}
+
+qint64 GzipReader::fail(const QString& message)
+{
+  finished = failed = true;
+  setErrorString(message);
+  qWarning() << Q_FUNC_INFO << message;
+  return -1;
+}
+
+qint64 GzipReader::readData(char *data, qint64 maxlen)
+{
+  // Report error again or end of data
+  if(finished)
+    return failed ? -1 : 0;
+  else if(maxlen <= 0)
+    return 0;
+
+  maxlen = std::min(maxlen, MAX_ZLIB_LEN);
+  stream->next_out = reinterpret_cast<Bytef *>(data);
+  stream->avail_out = static_cast<uInt>(maxlen);
+
+  // Inflate until at least one byte is produced or end of data =========================
+  while(stream->avail_out == static_cast<uInt>(maxlen))
+  {
+    if(stream->avail_in == 0)
+    {
+      qint64 numRead = fillBuffer();
+      if(numRead < 0)
+        return fail(source->errorString());
+      else if(numRead == 0)
+      {
+        if(totalIn == 0)
+        {
+          // Empty input gives empty output
+          finished = true;
+          break;
+        }
+        else
+          return fail(QString("Unexpected end of gzip data"));
+      }
+    }
+
+    int err = inflate(stream, Z_NO_FLUSH);
+    if(err == Z_STREAM_END)
+    {
+      // End of gzip member - check for a concatenated one
+      if(stream->avail_in == 0)
+      {
+        qint64 numRead = fillBuffer();
+        if(numRead < 0)
+          return fail(source->errorString());
+      }
+
+      if(stream->avail_in > 0 && stream->next_in[0] == 0x1f)
+        inflateReset(stream);
+      else
+      {
+        // Done - ignore any trailing garbage like gzipDecompress() does
+        finished = true;
+        break;
+      }
+    }
+    else if(err != Z_OK)
+      return fail(QString("Error decompressing gzip data: %1").
+                  arg(stream->msg != nullptr ? QString(stream->msg) : QString::number(err)));
+  }
+
+  qint64 produced = maxlen - stream->avail_out;
+  totalOut += produced;
+  return produced;
+}
+
+qint64 GzipReader::writeData(const char *, qint64)
+{
+  return -1;
+}
+
+// ===============================================================================================
+GzipWriter::GzipWriter(QIODevice *sinkDevice, int level, int chunkSize)
+  : sink(sinkDevice), stream(new z_stream), compressionLevel(std::max(-1, std::min(9, level)))
+{
+  outBuffer.resize(std::max(chunkSize, MIN_CHUNK_SIZE));
+}
+
+GzipWriter::~GzipWriter()
+{
+  close();
+
+  if(streamInitialized)
+    deflateEnd(stream);
+  delete stream;
+}
+
+void GzipWriter::setSinkDevice(QIODevice *sinkDevice)
+{
+  close();
+  sink = sinkDevice;
+}
+
+bool GzipWriter::open(OpenMode mode)
+{
+  if((mode & QIODevice::ReadWrite) != QIODevice::WriteOnly)
+  {
+    qWarning() << Q_FUNC_INFO << "Only write only mode supported" << mode;
+    return false;
+  }
+
+  if(sink == nullptr || !sink->isWritable())
+  {
+    setErrorString(QString("Sink device is not writable"));
+    return false;
+  }
+
+  int err;
+  if(streamInitialized)
+    // Keep allocated state
+    err = deflateReset(stream);
+  else
+  {
+    stream->zalloc = Z_NULL;
+    stream->zfree = Z_NULL;
+    stream->opaque = Z_NULL;
+    stream->next_in = Z_NULL;
+    stream->avail_in = 0;
+    err = deflateInit2(stream, compressionLevel, Z_DEFLATED, GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY);
+    streamInitialized = err == Z_OK;
+  }
+
+  if(err != Z_OK)
+  {
+    setErrorString(QString("Cannot initialize compression: %1").arg(err));
+    return false;
+  }
+
+  stream->next_out = reinterpret_cast<Bytef *>(outBuffer.data());
+  stream->avail_out = static_cast<uInt>(outBuffer.size());
+  finished = failed = false;
+  totalIn = totalOut = 0;
+
+  return QIODevice::open(mode);
+}
+
+void GzipWriter::close()
+{
+  if(isOpen())
+  {
+    finish();
+    QIODevice::close();
+  }
+}
+
+bool GzipWriter::finish()
+{
+  if(!isOpen() || failed)
+    return false;
+  else if(finished)
+    return true;
+
+  finished = true;
+  stream->next_in = Z_NULL;
+  stream->avail_in = 0;
+  return deflateInput(Z_FINISH) && writeBuffer();
+}
+
+bool GzipWriter::flush()
+{
+  if(!isOpen() || failed || finished)
+    return false;
+
+  stream->next_in = Z_NULL;
+  stream->avail_in = 0;
+  return deflateInput(Z_SYNC_FLUSH) && writeBuffer();
+}
+
+bool GzipWriter::writeBuffer()
+{
+  qint64 len = outBuffer.size() - stream->avail_out;
+  if(len > 0)
+  {
+    if(sink->write(outBuffer.constData(), len) != len)
+    {
+      failed = true;
+      setErrorString(sink->errorString());
+      qWarning() << Q_FUNC_INFO << "Error writing" << sink->errorString();
+      return false;
+    }
+    totalOut += len;
+  }
+
+  stream->next_out = reinterpret_cast<Bytef *>(outBuffer.data());
+  stream->avail_out = static_cast<uInt>(outBuffer.size());
+  return true;
+}
+
+bool GzipWriter::deflateInput(int flushMode)
+{
+  int err;
+  do
+  {
+    // Output chunk full - pass to sink
+    if(stream->avail_out == 0 && !writeBuffer())
+      return false;
+
+    err = deflate(stream, flushMode);
+    if(err == Z_STREAM_ERROR)
+    {
+      failed = true;
+      setErrorString(QString("Error compressing gzip data"));
+      qWarning() << Q_FUNC_INFO << "Error compressing gzip data";
+      return false;
+    }
+  } while(stream->avail_in > 0 || stream->avail_out == 0 || (flushMode == Z_FINISH && err != Z_STREAM_END));
+
+  return true;
+}
+
+qint64 GzipWriter::writeData(const char *data, qint64 len)
+{
+  if(finished || failed)
+  {
+    setErrorString(QString("Stream is finished"));
+    return -1;
+  }
+
+  // Pass data in chunks zlib can handle - usually only one iteration
+  qint64 remaining = len;
+  while(remaining > 0)
+  {
+    qint64 chunk = std::min(remaining, MAX_ZLIB_LEN);
+    stream->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    stream->avail_in = static_cast<uInt>(chunk);
+
+    if(!deflateInput(Z_NO_FLUSH))
+      return -1;
+
+    data += chunk;
+    remaining -= chunk;
+  }
+
+  totalIn += len;
+  return len;
+}
+
+qint64 GzipWriter::readData(char *, qint64)
+{
+  return -1;
+}
+
+} // namespace zip
+} // namespace atools
@@ -0,0 +1,196 @@
+/*****************************************************************************
+* Copyright 2015-2025 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef ATOOLS_ZIP_GZIPDEVICE_H
+#define ATOOLS_ZIP_GZIPDEVICE_H
+
+#include <QIODevice>
+
+struct z_stream_s;
+
+namespace atools {
+namespace zip {
+
+/*
+ * Sequential read only device decompressing gzip data from a source device on the fly.
+ * Reads the source in chunks and keeps only one chunk of compressed data in memory.
+ * Concatenated gzip members are decompressed as one stream.
+ *
+ * The inflate state is kept when changing the source with setSourceDevice() or reopening which avoids
+ * reallocation when decompressing many small payloads.
+ *
+ * Source device has to be opened for reading and is not owned.
+ *
+ * Usage:
+ *   QFile file(filename);
+ *   file.open(QIODevice::ReadOnly);
+ *   atools::zip::GzipReader reader(&file);
+ *   reader.open(QIODevice::ReadOnly);
+ *   QXmlStreamReader xml(&reader);
+ */
+class GzipReader :
+  public QIODevice
+{
+public:
+  explicit GzipReader(QIODevice *sourceDevice = nullptr, int chunkSize = 64 * 1024);
+  virtual ~GzipReader() override;
+
+  GzipReader(const GzipReader& other) = delete;
+  GzipReader& operator=(const GzipReader& other) = delete;
+
+  /* Set a new source device. Closes this device. */
+  void setSourceDevice(QIODevice *sourceDevice);
+
+  QIODevice *getSourceDevice() const
+  {
+    return source;
+  }
+
+  /* Only QIODevice::ReadOnly is allowed. Resets the inflate state. */
+  virtual bool open(QIODevice::OpenMode mode) override;
+  virtual void close() override;
+
+  virtual bool isSequential() const override
+  {
+    return true;
+  }
+
+  virtual bool atEnd() const override;
+
+  /* Number of compressed bytes consumed and uncompressed bytes produced since opening */
+  qint64 getTotalIn() const
+  {
+    return totalIn;
+  }
+
+  qint64 getTotalOut() const
+  {
+    return totalOut;
+  }
+
+protected:
+  virtual qint64 readData(char *data, qint64 maxlen) override;
+  virtual qint64 writeData(const char *data, qint64 len) override;
+
+private:
+  /* Read next chunk from source into inBuffer. Returns number of bytes or -1 on error. */
+  qint64 fillBuffer();
+
+  /* Stop reading and set error string. Returns -1. */
+  qint64 fail(const QString& message);
+
+  QIODevice *source;
+  z_stream_s *stream;
+  QByteArray inBuffer;
+  bool streamInitialized = false, finished = false, failed = false;
+  qint64 totalIn = 0, totalOut = 0;
+};
+
+/*
+ * Sequential write only device compressing all written data to gzip format into a sink device.
+ * Compressed data is collected in a buffer of chunk size and written to the sink when full.
+ * Memory usage does not depend on the payload size.
+ *
+ * The gzip trailer is written by close() or finish(). Data is incomplete until then.
+ *
+ * The deflate state is kept when changing the sink with setSinkDevice() or reopening.
+ *
+ * Sink device has to be opened for writing and is not owned.
+ *
+ * Usage:
+ *   QSaveFile file(filename);
+ *   file.open(QIODevice::WriteOnly);
+ *   atools::zip::GzipWriter writer(&file);
+ *   writer.open(QIODevice::WriteOnly);
+ *   QXmlStreamWriter xml(&writer);
+ *   ...
+ *   if(writer.finish())
+ *     file.commit();
+ */
+class GzipWriter :
+  public QIODevice
+{
+public:
+  /* level: 0 = no compression, 9 = max, -1 = default */
+  explicit GzipWriter(QIODevice *sinkDevice = nullptr, int level = -1, int chunkSize = 64 * 1024);
+  virtual ~GzipWriter() override;
+
+  GzipWriter(const GzipWriter& other) = delete;
+  GzipWriter& operator=(const GzipWriter& other) = delete;
+
+  /* Set a new sink device. Closes this device which finishes the current stream. */
+  void setSinkDevice(QIODevice *sinkDevice);
+
+  QIODevice *getSinkDevice() const
+  {
+    return sink;
+  }
+
+  /* Only QIODevice::WriteOnly is allowed. Resets the deflate state. */
+  virtual bool open(QIODevice::OpenMode mode) override;
+
+  /* Calls finish() if not done yet and closes device. Call finish() before to detect errors. */
+  virtual void close() override;
+
+  /* Write all pending data and the gzip trailer to the sink. Returns false on error.
+   * Further writes are not possible. */
+  bool finish();
+
+  /* Write all pending data to the sink using a sync flush which allows a reader to decompress
+   * everything written up to now. Degrades compression if used often. */
+  bool flush();
+
+  virtual bool isSequential() const override
+  {
+    return true;
+  }
+
+  /* Number of uncompressed bytes consumed and compressed bytes written since opening */
+  qint64 getTotalIn() const
+  {
+    return totalIn;
+  }
+
+  qint64 getTotalOut() const
+  {
+    return totalOut;
+  }
+
+protected:
+  virtual qint64 readData(char *data, qint64 maxlen) override;
+  virtual qint64 writeData(const char *data, qint64 len) override;
+
+private:
+  /* Run deflate with given flush mode until input is consumed and write full chunks to sink */
+  bool deflateInput(int flushMode);
+
+  /* Write collected compressed data in outBuffer to sink */
+  bool writeBuffer();
+
+  QIODevice *sink;
+  z_stream_s *stream;
+  int compressionLevel;
+  QByteArray outBuffer;
+  bool streamInitialized = false, finished = false, failed = false;
+  qint64 totalIn = 0, totalOut = 0;
+};
+
+} // namespace zip
+} // namespace atools
+
+#endif // ATOOLS_ZIP_GZIPDEVICE_H
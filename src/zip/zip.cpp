@@ -36,10 +36,16 @@
 #include "zip/zipreader.h"
 #include "zip/zipwriter.h"
 
+#include "util/parallel.h"
+
 #include <QDebug>
 #include <QDateTime>
 #include <QtEndian>
 #include <QDir>
+#include <QAtomicInt>
+#include <QVector>
+
+#include <limits>
 
 #if defined(Q_CC_MSVC)
 #include <QtZlib/zlib.h>
@@ -555,6 +561,15 @@ public:
 
   void scanFiles();
 
+  /* Index into fileHeaders or -1 if not found */
+  int indexOf(const QString& fileName) const;
+
+  /* Create an opened streaming device for the entry at index reading from source.
+   * Takes ownership of source if ownSource is true, also on error.
+   * Returns null and sets entryStatus on error. Does not modify status and can be called from any thread
+   * as long as source is not shared. */
+  QIODevice *openEntry(int index, QIODevice *source, bool ownSource, ZipReader::Status& entryStatus) const;
+
   ZipReader::Status status;
 };
 
@@ -582,6 +597,221 @@ public:
 
 };
 
+/*
+ * Read only sequential device streaming the uncompressed contents of one zip entry.
+ * Stored entries are passed through and deflated entries are inflated in chunks.
+ * The CRC32 and size are calculated while reading and compared against the values of the
+ * central directory when the end of the entry is reached. readData() returns an error on mismatch.
+ *
+ * Keeps its own read position in the source device which allows several
+ * entry devices to share one source in the same thread.
+ */
+class ZipEntryDevice :
+  public QIODevice
+{
+public:
+  ZipEntryDevice(QIODevice *sourceParam, bool ownSourceParam, qint64 dataOffsetParam, const FileHeader& header)
+    : source(sourceParam), ownSource(ownSourceParam), sourcePos(dataOffsetParam)
+  {
+    compressionMethod = readUShort(header.h.compression_method);
+    compressedRemaining = readUInt(header.h.compressed_size);
+    uncompressedSize = readUInt(header.h.uncompressed_size);
+    expectedCrc = readUInt(header.h.crc_32);
+    crc = ::crc32(0L, Z_NULL, 0);
+  }
+
+  virtual ~ZipEntryDevice() override
+  {
+    close();
+    if(ownSource)
+      delete source;
+  }
+
+  /* Initializes inflate state if needed and opens the device */
+  bool openEntry()
+  {
+    if(compressionMethod == CompressionMethodDeflated)
+    {
+      stream.zalloc = Z_NULL;
+      stream.zfree = Z_NULL;
+      stream.opaque = Z_NULL;
+      stream.next_in = Z_NULL;
+      stream.avail_in = 0;
+
+      if(inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return false;
+
+      streamInitialized = true;
+    }
+    return QIODevice::open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+  }
+
+  virtual bool isSequential() const override
+  {
+    return true;
+  }
+
+  virtual qint64 size() const override
+  {
+    return uncompressedSize;
+  }
+
+  virtual bool atEnd() const override
+  {
+    return finished;
+  }
+
+  virtual qint64 bytesAvailable() const override
+  {
+    return uncompressedSize - totalOut + QIODevice::bytesAvailable();
+  }
+
+  virtual void close() override
+  {
+    if(streamInitialized)
+    {
+      inflateEnd(&stream);
+      streamInitialized = false;
+    }
+    QIODevice::close();
+  }
+
+protected:
+  virtual qint64 readData(char *data, qint64 maxlen) override;
+
+  virtual qint64 writeData(const char *, qint64) override
+  {
+    return -1;
+  }
+
+private:
+  /* Read up to maxlen compressed or stored bytes from the source at the own position */
+  qint64 readSource(char *data, qint64 maxlen);
+
+  /* Check CRC and size at end of entry. Sets error string and returns false on mismatch. */
+  bool finish();
+
+  /* Stop reading and set error string. Returns -1 to indicate the error. */
+  qint64 fail(const QString& message);
+
+  static const int CHUNK_SIZE = 64 * 1024;
+
+  QIODevice *source;
+  bool ownSource;
+  qint64 sourcePos;
+  int compressionMethod;
+  qint64 compressedRemaining, uncompressedSize, totalOut = 0;
+  uLong crc, expectedCrc;
+  z_stream stream;
+  bool streamInitialized = false, finished = false, failed = false;
+  QByteArray inBuffer;
+};
+
+qint64 ZipEntryDevice::readSource(char *data, qint64 maxlen)
+{
+  qint64 len = qMin(maxlen, compressedRemaining);
+  if(len <= 0)
+    return 0;
+
+  if(source->pos() != sourcePos && !source->seek(sourcePos))
+    return -1;
+
+  qint64 numRead = source->read(data, len);
+  if(numRead > 0)
+  {
+    sourcePos += numRead;
+    compressedRemaining -= numRead;
+  }
+  return numRead;
+}
+
+qint64 ZipEntryDevice::fail(const QString& message)
+{
+  finished = failed = true;
+  setErrorString(message);
+  return -1;
+}
+
+bool ZipEntryDevice::finish()
+{
+  finished = true;
+  if(totalOut != uncompressedSize)
+    fail(QString("Size mismatch: expected %1 but got %2 bytes").arg(uncompressedSize).arg(totalOut));
+  else if(crc != expectedCrc)
+    fail(QString("CRC mismatch: expected 0x%1 but got 0x%2").
+         arg(expectedCrc, 8, 16, QChar('0')).arg(crc, 8, 16, QChar('0')));
+  return !failed;
+}
+
+qint64 ZipEntryDevice::readData(char *data, qint64 maxlen)
+{
+  // Report error again or end of data
+  if(finished)
+    return failed ? -1 : 0;
+  else if(maxlen <= 0)
+    return 0;
+
+  // Limit to what zlib can handle in one call
+  maxlen = qMin(maxlen, static_cast<qint64>(std::numeric_limits<uInt>::max()));
+  qint64 produced = 0;
+
+  if(compressionMethod == CompressionMethodStored)
+  {
+    // Stored - pass through =====================================
+    produced = readSource(data, qMin(maxlen, uncompressedSize - totalOut));
+    if(produced < 0)
+      return fail(source->errorString());
+    if(produced == 0 && totalOut < uncompressedSize)
+      return fail(QLatin1String("Unexpected end of stored data"));
+  }
+  else
+  {
+    // Deflated - inflate until at least one byte was produced or stream is done =====================
+    stream.next_out = reinterpret_cast<Bytef *>(data);
+    stream.avail_out = static_cast<uInt>(maxlen);
+
+    while(stream.avail_out == static_cast<uInt>(maxlen))
+    {
+      if(stream.avail_in == 0 && compressedRemaining > 0)
+      {
+        inBuffer.resize(CHUNK_SIZE);
+        qint64 numRead = readSource(inBuffer.data(), CHUNK_SIZE);
+        if(numRead < 0)
+          return fail(source->errorString());
+        else if(numRead == 0)
+          return fail(QLatin1String("Unexpected end of archive"));
+        stream.next_in = reinterpret_cast<Bytef *>(inBuffer.data());
+        stream.avail_in = static_cast<uInt>(numRead);
+      }
+
+      int err = ::inflate(&stream, Z_NO_FLUSH);
+      if(err == Z_STREAM_END)
+      {
+        inflateEnd(&stream);
+        streamInitialized = false;
+        break;
+      }
+      else if(err == Z_BUF_ERROR && stream.avail_in == 0 && compressedRemaining == 0)
+        return fail(QLatin1String("Unexpected end of compressed data"));
+      else if(err != Z_OK && err != Z_BUF_ERROR)
+        return fail(QString("Inflate error %1").arg(err));
+    }
+    produced = maxlen - stream.avail_out;
+  }
+
+  crc = ::crc32(crc, reinterpret_cast<const Bytef *>(data), static_cast<uInt>(produced));
+  totalOut += produced;
+
+  if((compressionMethod == CompressionMethodStored && totalOut >= uncompressedSize) ||
+     (compressionMethod == CompressionMethodDeflated && !streamInitialized))
+  {
+    if(!finish())
+      return -1;
+  }
+
+  return produced;
+}
+
 LocalFileHeader CentralFileHeader::toLocalHeader() const
 {
   LocalFileHeader h;
@@ -707,6 +937,72 @@ void ZipReaderPrivate::scanFiles()
   }
 }
 
+int ZipReaderPrivate::indexOf(const QString& fileName) const
+{
+  for(int i = 0; i < fileHeaders.size(); i++)
+  {
+    if(QString::fromLocal8Bit(fileHeaders.at(i).file_name) == fileName)
+      return i;
+  }
+  return -1;
+}
+
+QIODevice *ZipReaderPrivate::openEntry(int index, QIODevice *source, bool ownSource,
+                                       ZipReader::Status& entryStatus) const
+{
+  QScopedPointer<QIODevice> sourceDeleter(ownSource ? source : nullptr);
+  const FileHeader& header = fileHeaders.at(index);
+
+  ushort version_needed = readUShort(header.h.version_needed);
+  if(version_needed > ZIP_VERSION)
+  {
+    qWarning("Zip: .ZIP specification version %d implementationis needed to extract the data.", version_needed);
+    entryStatus = ZipReader::FileNotSupported;
+    return nullptr;
+  }
+
+  if((readUShort(header.h.general_purpose_bits) & Encrypted) != 0)
+  {
+    qWarning("Zip: Unsupported encryption method is needed to extract the data.");
+    entryStatus = ZipReader::FileEncryptionMethodNotSupported;
+    return nullptr;
+  }
+
+  int compression_method = readUShort(header.h.compression_method);
+  if(compression_method != CompressionMethodStored && compression_method != CompressionMethodDeflated)
+  {
+    qWarning("Zip: Unsupported compression method %d is needed to extract the data.", compression_method);
+    entryStatus = ZipReader::FileEncryptionMethodNotSupported;
+    return nullptr;
+  }
+
+  // Skip local header with variable length name and extra field
+  LocalFileHeader lh;
+  qint64 start = readUInt(header.h.offset_local_header);
+  if(!source->seek(start) || source->read((char *)&lh, sizeof(LocalFileHeader)) != sizeof(LocalFileHeader) ||
+     readUInt(lh.signature) != 0x04034b50)
+  {
+    qWarning("Zip: Invalid local file header at %lld.", start);
+    entryStatus = ZipReader::FileCorrupted;
+    return nullptr;
+  }
+  qint64 dataOffset = start + sizeof(LocalFileHeader) + readUShort(lh.file_name_length) +
+                      readUShort(lh.extra_field_length);
+
+  sourceDeleter.take();
+  ZipEntryDevice *entryDevice = new ZipEntryDevice(source, ownSource, dataOffset, header);
+  if(!entryDevice->openEntry())
+  {
+    qWarning("Zip: Cannot initialize decompression.");
+    entryStatus = ZipReader::MemoryError;
+    delete entryDevice;
+    return nullptr;
+  }
+
+  entryStatus = ZipReader::NoError;
+  return entryDevice;
+}
+
 void ZipWriterPrivate::addEntry(EntryType type, const QString& fileName,
                                 const QByteArray& contents /*, QFile::Permissions permissions, QZip::Method m*/)
 {
@@ -1020,13 +1316,8 @@ ZipReader::FileInfo ZipReader::entryInfoAt(int index) const
 QByteArray ZipReader::fileData(const QString& fileName) const
 {
   d->scanFiles();
-  int i;
-  for(i = 0; i < d->fileHeaders.size(); i++)
-  {
-    if(QString::fromLocal8Bit(d->fileHeaders.at(i).file_name) == fileName)
-      break;
-  }
-  if(i == d->fileHeaders.size())
+  int i = d->indexOf(fileName);
+  if(i == -1)
     return QByteArray();
 
   FileHeader header = d->fileHeaders.at(i);
@@ -1111,19 +1402,69 @@ QByteArray ZipReader::fileData(const QString& fileName) const
   return QByteArray();
 }
 
+/*!
+ *   Opens a sequential read only device streaming the uncompressed contents of \a fileName.
+ *   The data is inflated in chunks while reading and the CRC32 is verified when reaching the end of the entry.
+ *   A read error is returned on CRC or size mismatch. See QIODevice::errorString() for details.
+ *
+ *   The device uses its own file handle if the archive was opened by filename. Otherwise it reads from
+ *   device() and has to be used in the thread of this reader.
+ *
+ *   Caller takes ownership of the returned device which has to be deleted before this reader.
+ *   Returns null and sets status() if the entry was not found or cannot be extracted.
+ */
+QIODevice *ZipReader::openEntry(const QString& fileName) const
+{
+  d->scanFiles();
+  int i = d->indexOf(fileName);
+  if(i == -1)
+    return nullptr;
+
+  // Use a separate file handle if possible to avoid sharing the file position
+  QIODevice *source = d->device;
+  bool ownSource = false;
+  QFile *archiveFile = qobject_cast<QFile *>(d->device);
+  if(archiveFile != nullptr && !archiveFile->fileName().isEmpty())
+  {
+    QFile *file = new QFile(archiveFile->fileName());
+    if(file->open(QIODevice::ReadOnly))
+    {
+      source = file;
+      ownSource = true;
+    }
+    else
+      delete file;
+  }
+
+  ZipReader::Status entryStatus = NoError;
+  QIODevice *entryDevice = d->openEntry(i, source, ownSource, entryStatus);
+  if(entryDevice == nullptr)
+    d->status = entryStatus;
+  return entryDevice;
+}
+
 /*!
  *   Extracts the full contents of the zip file into \a destinationDir on
  *   the local filesystem.
  *   In case writing or linking a file fails, the extraction will be aborted.
+ *
+ *   Files are streamed to disk in chunks and verified against the CRC32. Files are extracted in parallel
+ *   using up to \a maxThreads threads where each thread uses its own file handle. Uses
+ *   QThread::idealThreadCount() if \a maxThreads is <= 0. Extraction is done in the calling thread only
+ *   if the archive was not opened by filename.
+ *
+ *   A partially written file is removed if extraction fails.
  */
-bool ZipReader::extractAll(const QString& destinationDir) const
+bool ZipReader::extractAll(const QString& destinationDir, int maxThreads) const
 {
   QDir baseDir(destinationDir);
 
-  // create directories first
+  // create directories first including missing parents of files
   QList<FileInfo> allFiles = fileInfoList();
-  foreach(const FileInfo& fi, allFiles)
+  QVector<int> fileIndexes;
+  for(int i = 0; i < allFiles.size(); i++)
   {
+    const FileInfo& fi = allFiles.at(i);
     const QString absPath = destinationDir + QDir::separator() + fi.filePath;
     if(fi.isDir)
     {
@@ -1133,6 +1474,14 @@ bool ZipReader::extractAll(const QString& destinationDir) const
       if(!QFile::setPermissions(absPath, fi.permissions))
         return false;
     }
+    else if(fi.isFile)
+    {
+      QFileInfo fileFi(absPath);
+      if(!QFile::exists(fileFi.absolutePath()) && !QDir::root().mkpath(fileFi.absolutePath()))
+        return false;
+
+      fileIndexes.append(i);
+    }
   }
 
   // set up symlinks
@@ -1157,19 +1506,78 @@ bool ZipReader::extractAll(const QString& destinationDir) const
     }
   }
 
-  foreach(const FileInfo& fi, allFiles)
+  // Extract files - parallel only if archive can be opened separately for each thread
+  QFile *archiveFile = qobject_cast<QFile *>(d->device);
+  const QString archiveName = archiveFile != nullptr ? archiveFile->fileName() : QString();
+  if(archiveName.isEmpty())
+    maxThreads = 1;
+
+  // First error status - also used to stop all threads
+  QAtomicInt errorStatus(NoError);
+
+  atools::util::parallelFor(fileIndexes.size(), [&](int begin, int end) -> void {
+        QIODevice *source = d->device;
+        QScopedPointer<QFile> threadFile;
+        if(!archiveName.isEmpty())
+        {
+          threadFile.reset(new QFile(archiveName));
+          if(!threadFile->open(QIODevice::ReadOnly))
+          {
+            qWarning() << Q_FUNC_INFO << "Cannot open" << archiveName << threadFile->errorString();
+            errorStatus.testAndSetRelaxed(NoError, FileOpenError);
+            return;
+          }
+          source = threadFile.data();
+        }
+
+        QByteArray buffer(256 * 1024, Qt::Uninitialized);
+        for(int i = begin; i < end && errorStatus.loadAcquire() == NoError; i++)
+        {
+          int index = fileIndexes.at(i);
+          const FileInfo& fi = allFiles.at(index);
+          const QString absPath = destinationDir + QDir::separator() + fi.filePath;
+
+          ZipReader::Status entryStatus = NoError;
+          QScopedPointer<QIODevice> entry(d->openEntry(index, source, false /* ownSource */, entryStatus));
+          if(entry.isNull())
+          {
+            errorStatus.testAndSetRelaxed(NoError, entryStatus);
+            return;
+          }
+
+          QFile f(absPath);
+          if(!f.open(QIODevice::WriteOnly))
+          {
+            qWarning() << Q_FUNC_INFO << "Cannot open" << absPath << f.errorString();
+            errorStatus.testAndSetRelaxed(NoError, FileOpenError);
+            return;
+          }
+
+          // Copy in chunks
+          qint64 numRead = 0;
+          bool ok = true;
+          while(ok && (numRead = entry->read(buffer.data(), buffer.size())) > 0)
+            ok = f.write(buffer.constData(), numRead) == numRead;
+
+          if(!ok || numRead < 0)
+          {
+            qWarning() << Q_FUNC_INFO << "Error extracting" << fi.filePath
+                       << (ok ? entry->errorString() : f.errorString());
+            errorStatus.testAndSetRelaxed(NoError, ok ? FileCorrupted : FileError);
+            f.close();
+            f.remove();
+            return;
+          }
+
+          f.setPermissions(fi.permissions);
+          f.close();
+        }
+      }, 1 /* minChunkSize */, maxThreads);
+
+  if(errorStatus.loadAcquire() != NoError)
   {
-    const QString absPath = destinationDir + QDir::separator() + fi.filePath;
-    if(fi.isFile)
-    {
-      QFile f(absPath);
-      if(!f.open(QIODevice::WriteOnly))
-        return false;
-
-      f.write(fileData(fi.filePath));
-      f.setPermissions(fi.permissions);
-      f.close();
-    }
+    d->status = static_cast<ZipReader::Status>(errorStatus.loadAcquire());
+    return false;
   }
 
   return true;
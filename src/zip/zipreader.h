@@ -86,7 +86,12 @@ public:
 
   FileInfo entryInfoAt(int index) const;
   QByteArray fileData(const QString& fileName) const;
-  bool extractAll(const QString& destinationDir) const;
+
+  /* Streaming read only device for an entry. Caller takes ownership. Null if not found or not supported. */
+  QIODevice *openEntry(const QString& fileName) const;
+
+  /* Extract all files in parallel using up to maxThreads. Uses ideal thread count if <= 0. */
+  bool extractAll(const QString& destinationDir, int maxThreads = 0) const;
 
   enum Status
   {